@@ -0,0 +1,157 @@
+#pragma once
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+// ==============================================================
+//		Applies replacement textures (liveries) spread over the first frames.
+//
+// Previously all replacement textures were loaded in clbkPostCreation, which stalled scenario start for seconds
+// with big user textures. Now LoadTextureFile only queues a job, and clbkPreStep applies at most
+// TEXTURE_APPLY_PER_FRAME jobs per frame. The default textures are shown until then.
+//
+// Orbiter can only make a surface from a file, and only on the main thread, so everything happens there. A background
+// thread was tried, but oapiLoadTexture reads and decodes the whole file anyway, so it gained nothing.
+// Before each load the DDS header is read, so that the log tells if a file is missing or has another size than given.
+//
+// The Orbiter calls, including the log, are behind TextureLoader. With TEXTUREQUEUE_STANDALONE the Orbiter one is left out,
+// so the queue can be run with a stand-in loader without Orbiter (see TextureQueueProgram).
+// ==============================================================
+
+const int TEXTURE_APPLY_PER_FRAME = 2;
+const int TEXTURE_HEADER_SIZE = 20; // "DDS " magic, then DDS_HEADER size, flags, height, width
+
+typedef struct
+{
+	char file[100]; // relative to Textures folder
+	const char* type; // for log
+	int w, h;
+	MESHHANDLE mesh;
+	DWORD texIdx;
+} TEXTUREJOB;
+
+class TextureLoader
+{
+public:
+	virtual ~TextureLoader() {}
+
+	// Read the first size bytes of the file. Return number of bytes read, or -1 if not found
+	virtual int ReadHeader(const char* file, unsigned char* header, int size) = 0;
+
+	// Make the surface and copy it to the mesh. Return false if it failed
+	virtual bool Apply(const TEXTUREJOB& job) = 0;
+
+	virtual void Log(const char* line) = 0;
+};
+
+#ifndef TEXTUREQUEUE_STANDALONE
+// The real one, using the texture cache and oapiBlt
+class OrbiterTextureLoader : public TextureLoader
+{
+public:
+	int ReadHeader(const char* file, unsigned char* header, int size)
+	{
+		char path[120] = "Textures\\";
+		strcat(path, file);
+
+		FILE* f = fopen(path, "rb");
+		if (f == NULL)
+			return -1;
+
+		int read = (int)fread(header, 1, size, f);
+		fclose(f);
+		return read;
+	}
+
+	bool Apply(const TEXTUREJOB& job)
+	{
+		SURFHANDLE newTex = TextureCache::Global().Acquire(job.file, job.w, job.h);
+		if (newTex == NULL)
+			return false;
+
+		SURFHANDLE oldTex = oapiGetTextureHandle(job.mesh, job.texIdx);
+		oapiBlt(oldTex, newTex, 0, 0, 0, 0, job.w, job.h);
+		TextureCache::Global().Release(newTex); // copied, so only kept briefly for other vessels
+		return true;
+	}
+
+	void Log(const char* line)
+	{
+		oapiWriteLog((char*)line);
+	}
+};
+#endif
+
+class TextureQueue
+{
+public:
+	TextureQueue(TextureLoader* textureLoader) : loader(textureLoader) {}
+
+	void Request(const char* file, const char* type, int w, int h, MESHHANDLE mesh, DWORD texIdx)
+	{
+		TEXTUREJOB job;
+		strncpy(job.file, file, sizeof(job.file) - 1);
+		job.file[sizeof(job.file) - 1] = '\0';
+		job.type = type;
+		job.w = w;
+		job.h = h;
+		job.mesh = mesh;
+		job.texIdx = texIdx;
+
+		if (jobs.size() == nextApply) startTime = clock(); // new batch
+		jobs.push_back(job);
+	}
+
+	// Every frame. Returns number of jobs not yet applied
+	int Update(void)
+	{
+		for (int applied = 0; applied < TEXTURE_APPLY_PER_FRAME && nextApply < jobs.size(); applied++)
+		{
+			const TEXTUREJOB& job = jobs[nextApply];
+			char cbuf[256];
+
+			unsigned char header[TEXTURE_HEADER_SIZE];
+			int read = loader->ReadHeader(job.file, header, TEXTURE_HEADER_SIZE);
+			int fileW = 0, fileH = 0;
+			if (read == TEXTURE_HEADER_SIZE && memcmp(header, "DDS ", 4) == 0)
+			{
+				// DDS_HEADER follows the magic: size, flags, height, width
+				memcpy(&fileH, &header[12], 4);
+				memcpy(&fileW, &header[16], 4);
+			}
+
+			if (read < 0)
+			{
+				sprintf(cbuf, "Could not read %s file >%s<, trying anyway", job.type, job.file);
+				loader->Log(cbuf);
+			}
+			else if (fileW != 0 && (fileW != job.w || fileH != job.h))
+			{
+				sprintf(cbuf, "Warning! %s file >%s< is %ix%i, but %ix%i was given", job.type, job.file, fileW, fileH, job.w, job.h);
+				loader->Log(cbuf);
+			}
+
+			if (loader->Apply(job))
+				sprintf(cbuf, "Finished loading %s texture", job.type);
+			else
+				sprintf(cbuf, "Failed loading %s texture", job.type);
+			loader->Log(cbuf);
+
+			nextApply += 1;
+			if (nextApply == jobs.size())
+			{
+				sprintf(cbuf, "All %i replacement textures applied after %.2f s", (int)jobs.size(), double(clock() - startTime) / CLOCKS_PER_SEC);
+				loader->Log(cbuf);
+			}
+		}
+
+		return int(jobs.size() - nextApply);
+	}
+
+private:
+	TextureLoader* loader;
+	std::vector<TEXTUREJOB> jobs;
+	size_t nextApply = 0;
+	clock_t startTime = 0;
+};
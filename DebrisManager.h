@@ -0,0 +1,278 @@
+#pragma once
+#include <vector> // growable list of created vessels
+#include "MercuryTimer.h"
+
+// ==============================================================
+//		Keeps track of everything we separate (retro pack, straps, covers, antenna, rings, boosters, cores),
+//		and deletes them again when they are no longer of interest.
+//		Shared by Atlas, Redstone, Little Joe, Scout and the capsule.
+//
+// Previously a fixed array createdVessel[25] was filled with no bounds check, and every entry was checked every timestep.
+// Now the list grows as needed, and only a few entries are checked each timestep (round-robin).
+// What makes a vessel "of no interest" is given by a list of retirement policies, which can be added to freely.
+//
+// The first creation of a vessel class loads its config and module from disk, which gave visible hitches at
+// BECO, SECO and retro jettison. So every class we may create is prewarmed in clbkPostCreation, and the time
+// of each creation is written to the log.
+// ==============================================================
+
+// Return true if the debris vessel should be deleted. Limit is the value given with AddPolicy.
+typedef bool (*DEBRIS_RETIRE_FUNC)(OBJHANDLE debris, OBJHANDLE parent, double age, double limit);
+
+typedef struct
+{
+	OBJHANDLE handle;
+	double createdTime;
+} DEBRIS;
+
+typedef struct
+{
+	const char* name; // for log
+	DEBRIS_RETIRE_FUNC retire;
+	double limit;
+	int retired; // stats
+} DEBRIS_POLICY;
+
+const int DEBRIS_CHECKS_PER_STEP = 3; // so with 20 pieces of debris every piece is checked every 7th timestep. Plenty
+const double DEBRIS_DEFAULT_DISTANCE = 2e5; // over 200 km away. Should be further than any realistic attempt at any rendezvous
+
+// Built-in policies
+inline bool DebrisTooFar(OBJHANDLE debris, OBJHANDLE parent, double age, double limit)
+{
+	VECTOR3 relPos;
+	oapiGetRelativePos(debris, parent, &relPos);
+	return length(relPos) > limit;
+}
+
+inline bool DebrisTooOld(OBJHANDLE debris, OBJHANDLE parent, double age, double limit)
+{
+	return age > limit;
+}
+
+// Landed (Orbiter has set it to inactive on the ground), or touching ground with groundspeed below limit
+inline bool DebrisAtRest(OBJHANDLE debris, OBJHANDLE parent, double age, double limit)
+{
+	VESSEL* v = oapiGetVesselInterface(debris);
+	return (v->GetFlightStatus() & 1) || (v->GroundContact() && v->GetGroundspeed() < limit);
+}
+
+// Below the horizon as seen from parent, and further away than limit (so that stuff lying next to a landed capsule is not deleted)
+inline bool DebrisBelowHorizon(OBJHANDLE debris, OBJHANDLE parent, double age, double limit)
+{
+	OBJHANDLE planet = oapiGetVesselInterface(parent)->GetSurfaceRef();
+	if (planet == NULL)
+		return false;
+
+	VECTOR3 planetPos, parentPos, debrisPos;
+	oapiGetGlobalPos(planet, &planetPos);
+	oapiGetGlobalPos(parent, &parentPos);
+	oapiGetGlobalPos(debris, &debrisPos);
+
+	VECTOR3 lineOfSight = debrisPos - parentPos;
+	double distance = length(lineOfSight);
+	if (distance < limit)
+		return false;
+
+	double parentRadius = length(parentPos - planetPos);
+	double planetRadius = oapiGetSize(planet);
+	if (parentRadius < planetRadius) parentRadius = planetRadius; // sanity
+
+	double elevation = asin(dotp(lineOfSight, parentPos - planetPos) / distance / parentRadius);
+	double horizonDip = acos(planetRadius / parentRadius);
+	return elevation < -horizonDip;
+}
+
+class DebrisManager
+{
+public:
+	DebrisManager(void)
+	{
+		AddPolicy("distance", DebrisTooFar, DEBRIS_DEFAULT_DISTANCE); // the original behaviour
+	}
+
+	~DebrisManager(void)
+	{
+		for (int i = 0; i < (int)prewarmedModules.size(); i++)
+			FreeLibrary(prewarmedModules[i]);
+	}
+
+	// Read config and load module of a vessel class we may create later. Meshes are loaded globally by us already
+	void Prewarm(const char* className)
+	{
+		double startTime = MercuryTimerMs();
+
+		char cfgName[256];
+		if (_strnicmp(className, "Vessels\\", 8) == 0) sprintf(cfgName, "%s.cfg", className); // some are given with full path
+		else sprintf(cfgName, "Vessels\\%s.cfg", className);
+
+		FILEHANDLE cfg = oapiOpenFile(cfgName, FILE_IN_ZEROONFAIL, CONFIG);
+		if (cfg == 0)
+		{
+			oapiWriteLogV("Prewarm could not find %s", cfgName);
+			return;
+		}
+
+		char moduleName[256];
+		if (oapiReadItem_string(cfg, "Module", moduleName))
+		{
+			char modulePath[300];
+			sprintf(modulePath, "Modules\\%s.dll", moduleName);
+			HMODULE module = LoadLibraryA(modulePath); // Orbiter's own LoadLibrary then only increases the reference count
+			if (module != NULL) prewarmedModules.push_back(module);
+		}
+		oapiCloseFile(cfg, FILE_IN_ZEROONFAIL);
+
+		oapiWriteLogV("Prewarmed %s in %.2f ms", className, MercuryTimerMs() - startTime);
+	}
+
+	// Create a separated vessel and start tracking it. Log the time, so that we can see if separation still hitches
+	OBJHANDLE Create(const char* name, const char* className, void* vs)
+	{
+		double startTime = MercuryTimerMs();
+		OBJHANDLE handle = oapiCreateVesselEx(name, className, vs);
+		oapiWriteLogV("Created %s (%s) in %.2f ms", name, className, MercuryTimerMs() - startTime);
+
+		Add(handle);
+		return handle;
+	}
+
+	// Add a newly created vessel. Failed creations (NULL) are not tracked
+	void Add(OBJHANDLE handle)
+	{
+		lastAdded = handle;
+		if (handle == NULL)
+			return;
+
+		DEBRIS newDebris = { handle, oapiGetSimTime() };
+		debrisList.push_back(newDebris);
+		created += 1;
+		if ((int)debrisList.size() > maxTracked) maxTracked = (int)debrisList.size();
+	}
+
+	// Most recently created vessel (NULL if creation failed)
+	OBJHANDLE Last(void)
+	{
+		return lastAdded;
+	}
+
+	void AddPolicy(const char* name, DEBRIS_RETIRE_FUNC retire, double limit)
+	{
+		DEBRIS_POLICY newPolicy = { name, retire, limit, 0 };
+		policies.push_back(newPolicy);
+	}
+
+	// Change the limit of an existing policy, or add it if not present. Limit <= 0 removes the policy
+	void SetPolicy(const char* name, DEBRIS_RETIRE_FUNC retire, double limit)
+	{
+		for (int i = 0; i < (int)policies.size(); i++)
+		{
+			if (policies[i].retire == retire)
+			{
+				if (limit > 0.0)
+					policies[i].limit = limit;
+				else
+					policies.erase(policies.begin() + i);
+				return;
+			}
+		}
+
+		if (limit > 0.0)
+			AddPolicy(name, retire, limit);
+	}
+
+	// Check a few entries. Call every timestep
+	void Update(OBJHANDLE parent)
+	{
+		double simt = oapiGetSimTime();
+		int checks = min(DEBRIS_CHECKS_PER_STEP, (int)debrisList.size());
+
+		for (int n = 0; n < checks; n++)
+		{
+			if (nextCheck >= (int)debrisList.size())
+				nextCheck = 0;
+
+			OBJHANDLE handle = debrisList[nextCheck].handle;
+			if (!oapiIsVessel(handle)) // deleted by someone else
+			{
+				RemoveEntry(nextCheck);
+				continue;
+			}
+
+			if (oapiGetFocusObject() == handle) // don't delete if object is in focus (like if playing with staged parts)
+			{
+				nextCheck += 1;
+				continue;
+			}
+
+			double age = simt - debrisList[nextCheck].createdTime;
+			bool deleted = false;
+			for (int i = 0; i < (int)policies.size() && !deleted; i++)
+			{
+				if (policies[i].retire(handle, parent, age, policies[i].limit))
+				{
+					VECTOR3 relPos;
+					oapiGetRelativePos(handle, parent, &relPos);
+					char vesselName[256];
+					oapiGetObjectName(handle, vesselName, 256);
+
+					if (oapiDeleteVessel(handle))
+					{
+						oapiWriteLogV("Delete vessel %s due to %s (%.2f km, %.0f s old)", vesselName, policies[i].name, length(relPos) / 1000.0, age);
+						policies[i].retired += 1;
+						RemoveEntry(nextCheck);
+					}
+					else
+					{
+						oapiWriteLogV("Failed to delete vessel %s due to %s (%.2f km, %.0f s old). Not tracked anymore", vesselName, policies[i].name, length(relPos) / 1000.0, age);
+						RemoveEntry(nextCheck); // as before, only try once, so that it isn't logged again every round
+						failed += 1;
+					}
+
+					deleted = true;
+				}
+			}
+
+			if (!deleted)
+				nextCheck += 1;
+		}
+	}
+
+	// Number of created vessels still in the simulation
+	int LiveCount(void)
+	{
+		int live = 0;
+		for (int i = 0; i < (int)debrisList.size(); i++)
+		{
+			if (oapiIsVessel(debrisList[i].handle))
+				live += 1;
+		}
+
+		return live;
+	}
+
+	void WriteLogStats(void)
+	{
+		oapiWriteLogV(" > Debris: %i created, %i still live, maximum %i tracked at once, %i failed deletions", created, LiveCount(), maxTracked, failed);
+		for (int i = 0; i < (int)policies.size(); i++)
+		{
+			oapiWriteLogV(" >   deleted due to %s: %i", policies[i].name, policies[i].retired);
+		}
+	}
+
+private:
+	// Order doesn't matter, so swap with last
+	void RemoveEntry(int index)
+	{
+		debrisList[index] = debrisList.back();
+		debrisList.pop_back();
+	}
+
+	std::vector<DEBRIS> debrisList;
+	std::vector<DEBRIS_POLICY> policies;
+	std::vector<HMODULE> prewarmedModules;
+	OBJHANDLE lastAdded = NULL;
+	int nextCheck = 0;
+	int created = 0;
+	int maxTracked = 0;
+	int failed = 0;
+};
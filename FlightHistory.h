@@ -0,0 +1,195 @@
+#pragma once
+#include <stdio.h>
+#include <string>
+
+// ==============================================================
+//		Decimated flight history
+//
+// Previously the flight summary in WriteFlightParameters only had scalar extremes (historyMaxAltitude, historyMaxReentryAcc, ...).
+// Now altitude, G-load and velocity are also kept as time series, with min, max and mean per bucket.
+// Memory is bounded also for a 34 hour MA-9 flight: every level holds HIST_BUCKETS buckets, and each level has twice the
+// bucket width of the one below. When a level is full, its two oldest buckets are merged into one bucket of the next level.
+// So the last minutes are at 1 s, and older data gets coarser. The top level halves its own resolution when full.
+//
+// Written to MercuryHistory_<vessel>_<time>.csv in FLIGHT_OUTPUT_FOLDER (see FlightRecorder.h) at exit, if the vessel has launched.
+// One row per bucket in time order, ready for plotting.
+// ==============================================================
+
+const int HIST_NUM_CHANNELS = 4;
+const char* const HIST_CHANNEL_NAMES[HIST_NUM_CHANNELS] = { "altitude", "gLoad", "spaceVelocity", "earthVelocity" }; // m, G, m/s, m/s
+const int HIST_LEVELS = 8;
+const int HIST_BUCKETS = 256; // per level. 8 * 256 buckets covers 18 hours before the top level is halved
+const double HIST_BASE_WIDTH = 1.0; // s, level 0
+
+typedef struct
+{
+	double t0, t1; // simt of first and last sample
+	int count;
+	double min[HIST_NUM_CHANNELS];
+	double max[HIST_NUM_CHANNELS];
+	double sum[HIST_NUM_CHANNELS];
+} HISTBUCKET;
+
+class FlightHistory
+{
+public:
+	void Begin(double mjd)
+	{
+		startMJD = mjd;
+	}
+
+	double StartMJD(void) const
+	{
+		return startMJD;
+	}
+
+	// Every time step. values in HIST_CHANNEL_NAMES order
+	void Add(double simt, const double* values)
+	{
+		if (open.count > 0 && (simt >= open.t0 + HIST_BASE_WIDTH || simt < open.t1))
+		{
+			Push(0, open);
+			open.count = 0;
+		}
+
+		if (open.count == 0)
+		{
+			open.t0 = simt;
+			for (int i = 0; i < HIST_NUM_CHANNELS; i++)
+			{
+				open.min[i] = open.max[i] = values[i];
+				open.sum[i] = 0.0;
+			}
+		}
+
+		open.t1 = simt;
+		open.count += 1;
+		for (int i = 0; i < HIST_NUM_CHANNELS; i++)
+		{
+			if (values[i] < open.min[i]) open.min[i] = values[i];
+			if (values[i] > open.max[i]) open.max[i] = values[i];
+			open.sum[i] += values[i];
+		}
+		samples += 1;
+	}
+
+	// CSV with MET relative to launchTime. Formatted in memory and written at once
+	bool Export(const char* file, double launchTime)
+	{
+		if (samples == 0)
+			return false;
+
+		std::string csv;
+		csv.reserve((HIST_LEVELS * HIST_BUCKETS + 1) * (40 + HIST_NUM_CHANNELS * 48));
+		csv += "metStart,metEnd,samples";
+		for (int i = 0; i < HIST_NUM_CHANNELS; i++)
+		{
+			char cbuf[100];
+			sprintf(cbuf, ",%sMin,%sMax,%sMean", HIST_CHANNEL_NAMES[i], HIST_CHANNEL_NAMES[i], HIST_CHANNEL_NAMES[i]);
+			csv += cbuf;
+		}
+		csv += "\n";
+
+		int rows = 0;
+		for (int level = HIST_LEVELS - 1; level >= 0; level--) // oldest first
+		{
+			for (int i = 0; i < levels[level].count; i++)
+			{
+				AppendRow(csv, levels[level].At(i), launchTime);
+				rows += 1;
+			}
+		}
+		if (open.count > 0)
+		{
+			AppendRow(csv, open, launchTime);
+			rows += 1;
+		}
+
+		FILE* out = fopen(file, "w");
+		if (out == NULL)
+		{
+			oapiWriteLogV("Flight history could not open >%s<", file);
+			return false;
+		}
+		fwrite(csv.data(), 1, csv.size(), out);
+		fclose(out);
+
+		oapiWriteLogV(" > Flight history: %i samples in %i rows, written to >%s<", samples, rows, file);
+		return true;
+	}
+
+private:
+	struct HistoryLevel
+	{
+		HISTBUCKET buckets[HIST_BUCKETS];
+		int head = 0; // oldest
+		int count = 0;
+
+		HISTBUCKET& At(int i)
+		{
+			return buckets[(head + i) % HIST_BUCKETS];
+		}
+	};
+
+	static HISTBUCKET Merge(const HISTBUCKET& a, const HISTBUCKET& b)
+	{
+		HISTBUCKET m = a;
+		m.t1 = b.t1;
+		m.count = a.count + b.count;
+		for (int i = 0; i < HIST_NUM_CHANNELS; i++)
+		{
+			if (b.min[i] < m.min[i]) m.min[i] = b.min[i];
+			if (b.max[i] > m.max[i]) m.max[i] = b.max[i];
+			m.sum[i] += b.sum[i];
+		}
+		return m;
+	}
+
+	void Push(int level, const HISTBUCKET& bucket)
+	{
+		HistoryLevel& l = levels[level];
+		if (l.count == HIST_BUCKETS)
+		{
+			if (level + 1 < HIST_LEVELS)
+			{
+				// Two oldest move up as one
+				HISTBUCKET merged = Merge(l.At(0), l.At(1));
+				l.head = (l.head + 2) % HIST_BUCKETS;
+				l.count -= 2;
+				Push(level + 1, merged);
+			}
+			else
+			{
+				// Top level, halve the resolution of everything in it
+				for (int i = 0; i < HIST_BUCKETS / 2; i++)
+					scratch[i] = Merge(l.At(2 * i), l.At(2 * i + 1));
+				for (int i = 0; i < HIST_BUCKETS / 2; i++)
+					l.buckets[i] = scratch[i];
+				l.head = 0;
+				l.count = HIST_BUCKETS / 2;
+			}
+		}
+
+		l.At(l.count) = bucket;
+		l.count += 1;
+	}
+
+	void AppendRow(std::string& csv, const HISTBUCKET& b, double launchTime)
+	{
+		char cbuf[100];
+		sprintf(cbuf, "%.1f,%.1f,%i", b.t0 - launchTime, b.t1 - launchTime, b.count);
+		csv += cbuf;
+		for (int i = 0; i < HIST_NUM_CHANNELS; i++)
+		{
+			sprintf(cbuf, ",%.6g,%.6g,%.6g", b.min[i], b.max[i], b.sum[i] / double(b.count));
+			csv += cbuf;
+		}
+		csv += "\n";
+	}
+
+	HistoryLevel levels[HIST_LEVELS];
+	HISTBUCKET open = { 0 };
+	HISTBUCKET scratch[HIST_BUCKETS / 2];
+	double startMJD = 0.0;
+	int samples = 0;
+};
@@ -0,0 +1,244 @@
+#pragma once
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+// ==============================================================
+//		Flight data recorder
+//
+// Previously the only telemetry was one line appended to MercuryEntryLog.txt (with std::ofstream on the simulation thread)
+// when the drogue deployed. Now a set of channels is sampled at a fixed rate for the whole flight.
+// Samples go into a ring buffer without locks, and a background thread writes them to a binary file.
+// If the disk can't keep up the newest samples are dropped (and counted), so the simulation thread never waits.
+//
+// Off by default. Set RecorderRate (Hz) in the config to record. The files are MercuryFlight_<vessel>_<time>.mrec in
+// FLIGHT_OUTPUT_FOLDER, so that they don't pile up in the Orbiter folder.
+// Convert the file to CSV with FlightRecorderProgram\FlightRecorderToCSV.cpp.
+//
+// File layout (little endian):
+//		FLIGHTRECORDHEADER
+//		column names, comma separated, header.namesLength bytes
+//		records of (header.numValues + 1) doubles: simt, then the values of each channel in REC_CHANNELS order
+// ==============================================================
+
+const int FLIGHTRECORD_VERSION = 1;
+const char FLIGHT_OUTPUT_FOLDER[] = "MercuryFlights"; // in the Orbiter folder. Created when a file is written
+const int REC_MAX_VALUES = 32;
+const unsigned int REC_RING_SIZE = 4096; // samples. Must be power of two. Almost 30 min at 2 Hz
+const int REC_DRAIN_INTERVAL_MS = 250;
+
+const enum REC_CHANNEL
+{
+	REC_STATE = 1 << 0,
+	REC_ATTITUDE = 1 << 1,
+	REC_THRUSTERS = 1 << 2,
+	REC_GLOAD = 1 << 3,
+	REC_STATUS = 1 << 4,
+	REC_FUEL = 1 << 5,
+	REC_ALL = (1 << 6) - 1
+};
+
+typedef struct
+{
+	const char* name; // as in config
+	unsigned int mask;
+	int numValues;
+	const char* columns;
+} RECCHANNEL;
+
+const RECCHANNEL REC_CHANNELS[] = {
+	{ "STATE", REC_STATE, 7, "posX,posY,posZ,velX,velY,velZ,altitude" }, // ecliptic, relative to reference body. m and m/s
+	{ "ATTITUDE", REC_ATTITUDE, 6, "pitch,bank,slip,rateX,rateY,rateZ" }, // deg and deg/s
+	{ "THRUSTERS", REC_THRUSTERS, 8, "main,retro,pitchUp,pitchDown,yawLeft,yawRight,bankLeft,bankRight" }, // thruster group levels
+	{ "GLOAD", REC_GLOAD, 1, "gLoad" },
+	{ "STATUS", REC_STATUS, 2, "vesselStatus,autopilotStatus" },
+	{ "FUEL", REC_FUEL, 3, "fuelAuto,fuelManual,propellant" }, // kg
+};
+const int REC_NUM_CHANNELS = sizeof(REC_CHANNELS) / sizeof(REC_CHANNELS[0]);
+
+typedef struct
+{
+	char magic[4]; // "MREC"
+	int version;
+	unsigned int channels; // REC_CHANNEL mask
+	int numValues; // per record, not counting simt
+	double rate; // Hz
+	double startMJD;
+	int namesLength;
+} FLIGHTRECORDHEADER;
+
+// Channel names separated by space or comma, e.g. "STATE ATTITUDE FUEL". ALL for everything
+inline unsigned int FlightRecorderChannels(const char* list)
+{
+	unsigned int mask = 0;
+	const char* c = list;
+	while (*c != '\0')
+	{
+		while (*c == ' ' || *c == ',' || *c == '\t') c++;
+		int len = 0;
+		while (c[len] != '\0' && c[len] != ' ' && c[len] != ',' && c[len] != '\t') len++;
+		if (len == 0)
+			break;
+
+		if (len == 3 && _strnicmp(c, "ALL", 3) == 0)
+			mask |= REC_ALL;
+		for (int i = 0; i < REC_NUM_CHANNELS; i++)
+		{
+			if ((int)strlen(REC_CHANNELS[i].name) == len && _strnicmp(c, REC_CHANNELS[i].name, len) == 0)
+				mask |= REC_CHANNELS[i].mask;
+		}
+		c += len;
+	}
+	return mask;
+}
+
+class FlightRecorder
+{
+public:
+	~FlightRecorder()
+	{
+		Stop();
+	}
+
+	bool Start(const char* file, unsigned int channelMask, double rate, double mjd)
+	{
+		if (running || rate <= 0.0 || channelMask == 0)
+			return false;
+
+		channels = channelMask;
+		interval = 1.0 / rate;
+		numValues = 0;
+		char names[512] = "";
+		for (int i = 0; i < REC_NUM_CHANNELS; i++)
+		{
+			if ((channels & REC_CHANNELS[i].mask) == 0)
+				continue;
+			if (names[0] != '\0') strcat(names, ",");
+			strcat(names, REC_CHANNELS[i].columns);
+			numValues += REC_CHANNELS[i].numValues;
+		}
+
+		out = fopen(file, "wb");
+		if (out == NULL)
+		{
+			oapiWriteLogV("Flight recorder could not open >%s<", file);
+			return false;
+		}
+
+		FLIGHTRECORDHEADER header;
+		memcpy(header.magic, "MREC", 4);
+		header.version = FLIGHTRECORD_VERSION;
+		header.channels = channels;
+		header.numValues = numValues;
+		header.rate = rate;
+		header.startMJD = mjd;
+		header.namesLength = (int)strlen(names);
+		fwrite(&header, sizeof(header), 1, out);
+		fwrite(names, 1, header.namesLength, out);
+
+		stride = numValues + 1;
+		ring.assign(REC_RING_SIZE * stride, 0.0);
+		writeIndex = 0;
+		readIndex = 0;
+		nextSample = -1e10;
+		samples = dropped = 0;
+		stopping = false;
+		running = true;
+		worker = std::thread(&FlightRecorder::Drain, this);
+
+		oapiWriteLogV("Flight recorder started, %i values at %.1f Hz to >%s<", numValues, rate, file);
+		return true;
+	}
+
+	void Stop(void)
+	{
+		if (!running)
+			return;
+
+		stopping = true;
+		worker.join();
+		fclose(out);
+		out = NULL;
+		running = false;
+		oapiWriteLogV(" > Flight recorder: %i samples, %i dropped", samples, dropped);
+	}
+
+	// Time for a new sample? Also handles jumps back in time
+	bool Due(double simt)
+	{
+		if (!running)
+			return false;
+		if (simt < nextSample - interval)
+			nextSample = simt;
+		return simt >= nextSample;
+	}
+
+	unsigned int Channels(void) const
+	{
+		return channels;
+	}
+
+	// Simulation thread. values in REC_CHANNELS order, for the recorded channels only
+	void Push(double simt, const double* values)
+	{
+		nextSample = (simt - nextSample > interval) ? simt + interval : nextSample + interval;
+
+		unsigned int w = writeIndex.load(std::memory_order_relaxed);
+		unsigned int r = readIndex.load(std::memory_order_acquire);
+		if (w - r >= REC_RING_SIZE) // full, disk is behind
+		{
+			dropped += 1;
+			return;
+		}
+
+		double* slot = &ring[(w & (REC_RING_SIZE - 1)) * stride];
+		slot[0] = simt;
+		memcpy(slot + 1, values, numValues * sizeof(double));
+		writeIndex.store(w + 1, std::memory_order_release);
+		samples += 1;
+	}
+
+private:
+	// Background thread
+	void Drain(void)
+	{
+		std::vector<double> block;
+		while (true)
+		{
+			bool last = stopping; // read before draining, so that the final samples are written
+			unsigned int r = readIndex.load(std::memory_order_relaxed);
+			unsigned int w = writeIndex.load(std::memory_order_acquire);
+
+			if (w != r)
+			{
+				block.resize((w - r) * stride);
+				for (unsigned int i = r; i != w; i++)
+					memcpy(&block[(i - r) * stride], &ring[(i & (REC_RING_SIZE - 1)) * stride], stride * sizeof(double));
+				readIndex.store(w, std::memory_order_release);
+				fwrite(&block[0], sizeof(double), block.size(), out);
+			}
+
+			if (last)
+				return;
+			std::this_thread::sleep_for(std::chrono::milliseconds(REC_DRAIN_INTERVAL_MS));
+		}
+	}
+
+	FILE* out = NULL;
+	unsigned int channels = 0;
+	int numValues = 0;
+	int stride = 1;
+	double interval = 1.0;
+	double nextSample = 0.0;
+	std::vector<double> ring;
+	std::atomic<unsigned int> writeIndex{ 0 };
+	std::atomic<unsigned int> readIndex{ 0 };
+	std::atomic<bool> stopping{ false };
+	bool running = false;
+	int samples = 0;
+	int dropped = 0;
+	std::thread worker;
+};
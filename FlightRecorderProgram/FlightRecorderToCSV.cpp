@@ -0,0 +1,126 @@
+// FlightRecorderToCSV.cpp : This file contains the 'main' function. Program execution begins and ends there.
+//
+// Created by Asbjrn ("asbjos" on Orbiter-Forum).
+// This program is included in the Project Mercury X package
+//
+// It converts the binary flight recorder files (MercuryFlight_<vessel>_<time>.mrec in the MercuryFlights folder) to CSV,
+// with one row per sample and one column per value. See FlightRecorder.h for the file layout and the channels.
+//
+// Standalone, and does not need Orbiter. Compile on Linux with:
+//		g++ -O2 -std=c++11 FlightRecorderToCSV.cpp -o FlightRecorderToCSV
+//
+// Usage:
+//		FlightRecorderToCSV input.mrec [-o output.csv]
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+const int FLIGHTRECORD_VERSION = 1; // same as FlightRecorder.h
+
+// Same as FlightRecorder.h
+typedef struct
+{
+	char magic[4]; // "MREC"
+	int version;
+	unsigned int channels;
+	int numValues;
+	double rate;
+	double startMJD;
+	int namesLength;
+} FLIGHTRECORDHEADER;
+
+int main(int argc, char* argv[])
+{
+	const char* inputFile = NULL;
+	const char* outputFile = NULL;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) outputFile = argv[++i];
+		else if (inputFile == NULL && argv[i][0] != '-') inputFile = argv[i];
+		else
+		{
+			inputFile = NULL; // show usage
+			break;
+		}
+	}
+
+	if (inputFile == NULL)
+	{
+		std::cerr << "Flight Recorder to CSV\n";
+		std::cerr << "Usage: " << argv[0] << " input.mrec [-o output.csv]\n";
+		return 1;
+	}
+
+	FILE* in = fopen(inputFile, "rb");
+	if (in == NULL)
+	{
+		std::cerr << "Could not open input file " << inputFile << "\n";
+		return 1;
+	}
+
+	FLIGHTRECORDHEADER header;
+	if (fread(&header, sizeof(header), 1, in) != 1 || memcmp(header.magic, "MREC", 4) != 0)
+	{
+		std::cerr << inputFile << " is not a flight recorder file\n";
+		fclose(in);
+		return 1;
+	}
+
+	if (header.version != FLIGHTRECORD_VERSION || header.numValues <= 0 || header.namesLength < 0)
+	{
+		std::cerr << inputFile << " has version " << header.version << ", but this program reads version " << FLIGHTRECORD_VERSION << "\n";
+		fclose(in);
+		return 1;
+	}
+
+	std::string names(header.namesLength, '\0');
+	if (header.namesLength > 0 && fread(&names[0], 1, header.namesLength, in) != (size_t)header.namesLength)
+	{
+		std::cerr << inputFile << " is truncated\n";
+		fclose(in);
+		return 1;
+	}
+
+	std::ofstream outfile;
+	if (outputFile != NULL)
+	{
+		outfile.open(outputFile);
+		if (!outfile.is_open())
+		{
+			std::cerr << "Could not open output file " << outputFile << "\n";
+			fclose(in);
+			return 1;
+		}
+	}
+	std::ostream& out = outputFile != NULL ? outfile : std::cout;
+
+	out << "simt," << names << "\n";
+
+	int stride = header.numValues + 1;
+	std::vector<double> record(stride);
+	long long rows = 0;
+	while (fread(&record[0], sizeof(double), stride, in) == (size_t)stride)
+	{
+		char cbuf[64];
+		sprintf(cbuf, "%.3f", record[0]);
+		out << cbuf;
+		for (int i = 1; i < stride; i++)
+		{
+			sprintf(cbuf, ",%.10g", record[i]);
+			out << cbuf;
+		}
+		out << "\n";
+		rows += 1;
+	}
+	fclose(in);
+
+	char mjdString[32];
+	sprintf(mjdString, "%.6f", header.startMJD);
+	std::cerr << rows << " samples at " << header.rate << " Hz, recording started at MJD " << mjdString << "\n";
+	return 0;
+}
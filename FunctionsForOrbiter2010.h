@@ -25,11 +25,12 @@ inline double ProjectMercury::normangle(double angle)
 
 inline void ProjectMercury::oapiWriteLogV(const char* format, ...)
 {
-	char string[256];
+	char string[1024];
 	va_list va; // variable list
     va_start (va, format);
-    vsprintf (string, format, va);
+    vsnprintf (string, sizeof(string), format, va); // bounded, long lines are cut
     va_end (va);
+	string[sizeof(string) - 1] = '\0';
 	
 	oapiWriteLog(string);
 }
@@ -20,19 +20,16 @@ inline void ProjectMercury::VersionDependentPanelClick(int id, const RECT& pos,
 
 void ProjectMercury::VersionDependentPadHUD(oapi::Sketchpad* skp, double simt, int* yIndexUpdate, char* cbuf, VESSEL *v)
 {
-	sprintf(cbuf, "  Height: %.2f km", v->GetAltitude(ALTMODE_GROUND) / 1000.0);
-	skp->Text(TextX0 * secondColumnHUDx, (*yIndexUpdate) * LineSpacing + TextY0, cbuf, strlen(cbuf));
+	hudText.Text(skp, TextX0 * secondColumnHUDx, (*yIndexUpdate) * LineSpacing + TextY0, "  Height: %.2f km", v->GetAltitude(ALTMODE_GROUND) / 1000.0);
 	*yIndexUpdate += 1;
 
 	double longR, latR, radR, longP, latP, radP;
 	v->GetEquPos(longR, latR, radR);
 	OBJHANDLE plt = GetEquPos(longP, latP, radP);
 	double angleDownrange = oapiOrthodome(longR, latR, longP, latP);
-	sprintf(cbuf, "  Downrange: %.2f km", angleDownrange * oapiGetSize(plt) / 1000.0);
-	skp->Text(TextX0 * secondColumnHUDx, (*yIndexUpdate) * LineSpacing + TextY0, cbuf, strlen(cbuf));
+	hudText.Text(skp, TextX0 * secondColumnHUDx, (*yIndexUpdate) * LineSpacing + TextY0, "  Downrange: %.2f km", angleDownrange * oapiGetSize(plt) / 1000.0);
 	*yIndexUpdate += 1;
 
-	sprintf(cbuf, "  Speed: %.1f m/s", v->GetGroundspeed());
-	skp->Text(TextX0 * secondColumnHUDx, (*yIndexUpdate) * LineSpacing + TextY0, cbuf, strlen(cbuf));
+	hudText.Text(skp, TextX0 * secondColumnHUDx, (*yIndexUpdate) * LineSpacing + TextY0, "  Speed: %.1f m/s", v->GetGroundspeed());
 	*yIndexUpdate += 1;
 }
\ No newline at end of file
@@ -0,0 +1,250 @@
+#pragma once
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+// ==============================================================
+//		Retained HUD text. Shared by all the vessels with on-screen text.
+//
+// Previously every HUD line was formatted with sprintf every frame, even the constant key help lines.
+// Now every line is stored, keyed by its format string and position. The arguments are compared with the last frame
+// at the precision they are displayed with (so %.1f only reformats when the value changes by 0.1), and the cached
+// string is drawn if nothing has changed.
+//
+// Usage: replace
+//		sprintf(cbuf, "Altitude: %.1f km", alt);
+//		skp->Text(x, y, cbuf, strlen(cbuf));
+// with
+//		hudText.Text(skp, x, y, "Altitude: %.1f km", alt);
+// The format must be a string literal, as the pointer is used as key.
+//
+// A line is looked for in at most HUD_CACHE_PROBE slots. If it isn't there, the least recently drawn of those slots is
+// reused, so a HUD with many positions (scrolling lists) costs the same per line as a small one.
+// The table is allocated at the first line, so vessels that never draw text don't pay for it.
+// ==============================================================
+
+const int HUD_CACHE_SIZE = 256; // number of distinct lines (format and position). Must be power of two
+const int HUD_CACHE_PROBE = 8; // slots searched per line before the oldest is replaced
+const int HUD_MAX_ARGS = 8;
+const int HUD_LINE_LENGTH = 256; // same as cbuf
+
+typedef struct
+{
+	const char* fmt; // NULL if slot unused
+	int x, y;
+	int numArgs; // -1 if the format can't be cached (like * width), and is always formatted
+	char argType[HUD_MAX_ARGS]; // i int, l long, L long long, f fixed, d other double, s string, p pointer
+	double argScale[HUD_MAX_ARGS]; // for f, 10^precision
+	long long key[HUD_MAX_ARGS];
+	bool formatted;
+	unsigned int lastUsed; // drawCount when last drawn
+	char text[HUD_LINE_LENGTH];
+	int len;
+} HUDLINE;
+
+class HudTextCache
+{
+public:
+	void Text(oapi::Sketchpad* skp, int x, int y, const char* fmt, ...)
+	{
+		va_list args;
+		va_start(args, fmt);
+
+		HUDLINE* line = Find(fmt, x, y);
+		if (line->fmt != fmt || line->x != x || line->y != y) // new line, in an empty or replaced slot
+		{
+			line->fmt = fmt;
+			line->x = x;
+			line->y = y;
+			line->formatted = false;
+			ParseFormat(line);
+		}
+		line->lastUsed = drawCount++;
+
+		bool changed = !line->formatted || line->numArgs < 0;
+
+		va_list values;
+		va_copy(values, args);
+		for (int i = 0; i < line->numArgs; i++)
+		{
+			long long key = ReadKey(line->argType[i], line->argScale[i], values);
+			if (key != line->key[i])
+			{
+				line->key[i] = key;
+				changed = true;
+			}
+		}
+		va_end(values);
+
+		if (changed)
+		{
+			line->len = Format(line->text, fmt, args);
+			line->formatted = true;
+			reformatted += 1;
+		}
+		else
+		{
+			reused += 1;
+		}
+		va_end(args);
+
+		skp->Text(x, y, line->text, line->len);
+	}
+
+	void WriteLogStats(void)
+	{
+		if (reformatted + reused > 0)
+			oapiWriteLogV(" > HUD text: %.1f %% of lines reused from cache (%i lines formatted, %i replaced)", 100.0 * double(reused) / double(reformatted + reused), reformatted, replaced);
+	}
+
+private:
+	// Slot of the line, or an empty slot, or the least recently drawn slot of the probed ones
+	HUDLINE* Find(const char* fmt, int x, int y)
+	{
+		if (lines.empty())
+		{
+			lines.resize(HUD_CACHE_SIZE);
+			for (int i = 0; i < HUD_CACHE_SIZE; i++)
+				lines[i].fmt = NULL;
+		}
+
+		unsigned int hash = (unsigned int)((size_t)fmt >> 2) * 2654435761u ^ (unsigned int)(x * 31 + y) * 40503u;
+		HUDLINE* oldest = NULL;
+		for (int n = 0; n < HUD_CACHE_PROBE; n++)
+		{
+			HUDLINE* line = &lines[(hash + n) & (HUD_CACHE_SIZE - 1)];
+			if (line->fmt == NULL || (line->fmt == fmt && line->x == x && line->y == y))
+				return line;
+			if (oldest == NULL || drawCount - line->lastUsed > drawCount - oldest->lastUsed) // wraps fine
+				oldest = line;
+		}
+
+		replaced += 1;
+		return oldest;
+	}
+
+	int Format(char* buffer, const char* fmt, va_list args)
+	{
+		int len = vsnprintf(buffer, HUD_LINE_LENGTH, fmt, args);
+		if (len < 0 || len >= HUD_LINE_LENGTH) len = (int)strlen(buffer); // truncated
+		return len;
+	}
+
+	// Find the type and displayed precision of every argument
+	void ParseFormat(HUDLINE* line)
+	{
+		line->numArgs = 0;
+		const char* c = line->fmt;
+		while (*c != '\0')
+		{
+			if (*c++ != '%')
+				continue;
+
+			if (*c == '%')
+			{
+				c++;
+				continue;
+			}
+
+			while (*c == '-' || *c == '+' || *c == ' ' || *c == '#' || *c == '0') c++; // flags
+			if (*c == '*') { line->numArgs = -1; return; }
+			while (*c >= '0' && *c <= '9') c++; // width
+
+			int precision = 6; // printf default
+			if (*c == '.')
+			{
+				c++;
+				if (*c == '*') { line->numArgs = -1; return; }
+				precision = 0;
+				while (*c >= '0' && *c <= '9') precision = precision * 10 + (*c++ - '0');
+			}
+
+			char length = ' ';
+			if (*c == 'h') { c++; if (*c == 'h') c++; }
+			else if (*c == 'l') { c++; length = 'l'; if (*c == 'l') { c++; length = 'L'; } }
+			else if (*c == 'L') { c++; }
+			else if (*c == 'I' && c[1] == '6' && c[2] == '4') { c += 3; length = 'L'; }
+			else if (*c == 'z') { c++; length = 'p'; }
+
+			if (line->numArgs >= HUD_MAX_ARGS) { line->numArgs = -1; return; }
+
+			char type;
+			switch (*c)
+			{
+			case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+				type = (length == ' ') ? 'i' : length;
+				break;
+			case 'f': case 'F':
+				type = 'f';
+				line->argScale[line->numArgs] = pow(10.0, precision);
+				break;
+			case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+				type = 'd';
+				break;
+			case 's':
+				type = 's';
+				break;
+			case 'p':
+				type = 'p';
+				break;
+			default: // unknown, so don't try
+				line->numArgs = -1;
+				return;
+			}
+
+			line->argType[line->numArgs] = type;
+			line->key[line->numArgs] = 0;
+			line->numArgs += 1;
+			c++;
+		}
+	}
+
+	long long ReadKey(char type, double scale, va_list& values)
+	{
+		switch (type)
+		{
+		case 'i':
+			return (long long)va_arg(values, int);
+		case 'l':
+			return (long long)va_arg(values, long);
+		case 'L':
+			return va_arg(values, long long);
+		case 'p':
+			return (long long)(size_t)va_arg(values, void*);
+		case 's':
+		{
+			const char* str = va_arg(values, const char*);
+			unsigned long long hash = 14695981039346656037ull; // FNV-1a
+			while (str != NULL && *str != '\0')
+			{
+				hash ^= (unsigned char)*str++;
+				hash *= 1099511628211ull;
+			}
+			return (long long)hash;
+		}
+		case 'f':
+		{
+			double value = va_arg(values, double) * scale;
+			if (fabs(value) < 9e18) return (long long)floor(value + 0.5); // what is displayed
+			return DoubleBits(value / scale); // huge, inf or nan
+		}
+		default:
+			return DoubleBits(va_arg(values, double));
+		}
+	}
+
+	long long DoubleBits(double value)
+	{
+		long long bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	std::vector<HUDLINE> lines;
+	unsigned int drawCount = 0;
+	int reformatted = 0;
+	int reused = 0;
+	int replaced = 0;
+};
@@ -7,9 +7,12 @@
 #define VESSELVER VESSEL3
 
 #include "orbitersdk.h"
+#include "..\..\HudTextCache.h"
 
 const double LC_MASS = 2e6; // guesstimate
 const double LC_COG = 21.26;
+const double PAD_ROCKET_MIN_MASS = 1e4; // kg. Must be large enough to fit to pad
+const int PAD_MAX_CANDIDATES = 10; // rockets near the pad that are checked every timestep
 const VECTOR3 EXHAUST_POS = _V(0.0, -18.38 + LC_COG, 0.0);
 const VECTOR3 EXHAUST_DIR = _V(1.0, 0.0, 0.0);
 const VECTOR3 ROCKET_POS = _V(3.05, -14.18 + LC_COG, -7.37);
@@ -89,6 +92,7 @@ public:
 	void SwitchCamera(int camera);
 	void AttachRocket(double simt, OBJHANDLE closestVessel, VESSEL* v);
 	void GetClosestVessel(OBJHANDLE* closestVessel, double* distance);
+	void RefreshPadCandidates(double simt);
 	void DefineAnimation(void);
 
 	DWORD ScreenWidth, ScreenHeight, ScreenColour;
@@ -109,9 +113,15 @@ private:
 	UINT LaunchPad;
 	MESHHANDLE launchPad;
 	ATTACHMENTHANDLE rocketAttach;
+	OBJHANDLE padCandidate[PAD_MAX_CANDIDATES]; // see LaunchComplexCommon.h
+	int padCandidateNum = 0;
+	DWORD padVesselCount = 0;
+	double padCandidateRefreshTime = -1e10;
 	UINT TowerMoveAway, TowerMoveIn;
 	int cameraMode = 0; // smlTwrDwn, lrgTwrDwn, lrgTwrFar, undrRckt, farAwy, farAwy2
 
+	HudTextCache hudText; // see HudTextCache.h
+
 	int showInfoOnHud = 0;	/* 0 = Both key commands and flight data
 							   1 = Only flight data
 							   2 = Nothing (only stock HUD)*/
@@ -125,6 +135,7 @@ private:
 };
 
 #include "..\..\FunctionsForOrbiter2010.h"
+#include "..\..\LaunchComplexCommon.h"
 
 // ==============================================================
 // API interface
@@ -426,10 +437,13 @@ int ProjectMercury::clbkConsumeBufferedKey(DWORD key, bool down, char* kstate)
 
 			GetClosestVessel(&closestVessel, &distance);
 
-			VESSEL* v = oapiGetVesselInterface(closestVessel);
+			if (closestVessel != NULL) // no rockets near pad
+			{
+				VESSEL* v = oapiGetVesselInterface(closestVessel);
 
-			if (v->GetThrusterGroupLevel(THGROUP_MAIN) == 0.0)
-				AttachRocket(oapiGetSimTime(), closestVessel, v);
+				if (v->GetThrusterGroupLevel(THGROUP_MAIN) == 0.0)
+					AttachRocket(oapiGetSimTime(), closestVessel, v);
+			}
 
 			return 1;
 		}
@@ -508,42 +522,34 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 	if (showInfoOnHud == 0)
 	{
 		// ==== Buttons text ====
-		sprintf(cbuf, "Key commands:");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "Key commands:");
 		yIndex += 1;
 
-		sprintf(cbuf, "Ctrl+T\t:Hide on-screen text");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "Ctrl+T\t:Hide on-screen text");
 		yIndex += 1;
 
 		if (TowerInProcess == AWAY)
 		{
-			sprintf(cbuf, "K\t:Move tower away/close");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "K\t:Move tower away/close");
 			yIndex += 1;
 		}
 		
 		if (TowerProcess == CLOSE)
 		{
-			sprintf(cbuf, "G\t:Move tower in/out");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "G\t:Move tower in/out");
 			yIndex += 1;
 		}
 
-		sprintf(cbuf, "V\t:Attach closest rocket");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "V\t:Attach closest rocket");
 		yIndex += 1;
 
-		sprintf(cbuf, "C\t:Switch camera");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "C\t:Switch camera");
 		yIndex += 1;
 
-		sprintf(cbuf, "P\t:Launch attached rocket");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "P\t:Launch attached rocket");
 		yIndex += 1;
 
-		sprintf(cbuf, "SPACE\t:Lights on/off");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "SPACE\t:Lights on/off");
 		yIndex += 1;
 	}
 
@@ -553,8 +559,7 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 
 	if (showInfoOnHud < 2)
 	{
-		sprintf(cbuf, "Camera:");
-		skp->Text(TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, "Camera:");
 		yIndex += 1;
 
 		if (cameraMode == 1)
@@ -569,7 +574,7 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 			sprintf(cbuf, "  Far 2");
 		else
 			sprintf(cbuf, "  Tower");
-		skp->Text(TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, "%s", cbuf);
 		yIndex += 1;
 
 		OBJHANDLE closestVessel = NULL;
@@ -578,13 +583,11 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		char ccbuf[256];
 		if (closestVessel != NULL)
 		{
-			sprintf(cbuf, "Closest rocket:");
-			skp->Text(TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, "Closest rocket:");
 			yIndex += 1;
 
 			oapiGetObjectName(closestVessel, ccbuf, 256);
-			sprintf(cbuf, "  %s", ccbuf);
-			skp->Text(TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, "  %s", ccbuf);
 			yIndex += 1;
 
 			if (engineIgnitionTime != 0.0)
@@ -603,20 +606,18 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 				int metM = (int)floor((metAbs - metH * 3600.0) / 60.0);
 				int metS = (int)floor((metAbs - metH * 3600.0 - metM * 60.0));
 
-				sprintf(cbuf, "  T%s%02i %02i %02i", signChar, metH, metM, metS);
-				skp->Text(TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, "  T%s%02i %02i %02i", signChar, metH, metM, metS);
 				yIndex += 1;
 			}
 
-			sprintf(cbuf, "  Distance %.1f m", distance);
-			skp->Text(TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, "  Distance %.1f m", distance);
 			yIndex += 1;
 
 			if (GetAttachmentStatus(rocketAttach) == closestVessel)
 				sprintf(cbuf, "  ATTACHED");
 			else
 				sprintf(cbuf, "  NOT ATTACHED");
-			skp->Text(TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, "%s", cbuf);
 			yIndex += 1;
 
 			VESSEL* v = oapiGetVesselInterface(closestVessel);
@@ -624,7 +625,7 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 				sprintf(cbuf, "  ENGINES ON");
 			else
 				sprintf(cbuf, "  ENGINES OFF");
-			skp->Text(TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, "%s", cbuf);
 			yIndex += 1;
 
 			VersionDependentPadHUD(skp, simt, &yIndex, cbuf, v);
@@ -633,14 +634,12 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 			GetRelativePos(GetSurfaceRef(), planetVec);
 			GetRelativePos(closestVessel, rocketVec);
 			double elevationAngle = acos(dotp(planetVec, rocketVec) / (length(planetVec) * length(rocketVec))) - PI05;
-			sprintf(cbuf, "  Elevation: %.1f\u00B0", elevationAngle * DEG);
-			skp->Text(TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, "  Elevation: %.1f\u00B0", elevationAngle * DEG);
 			yIndex += 1;
 		}
 		else
 		{
-			sprintf(cbuf, "No rockets detected");
-			skp->Text(TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0 * secondColumnHUDx, yIndex * LineSpacing + TextY0, "No rockets detected");
 			yIndex += 1;
 		}
 	}
@@ -728,22 +727,6 @@ void ProjectMercury::AttachRocket(double simt, OBJHANDLE closestVessel, VESSEL*
 	}
 }
 
-void ProjectMercury::GetClosestVessel(OBJHANDLE* closestVessel, double* distance)
-{
-	VECTOR3 pos;
-	OBJHANDLE vesselI;
-	for (int i = 0; i < (int)oapiGetVesselCount(); i++)
-	{
-		vesselI = oapiGetVesselByIndex(i);
-		GetRelativePos(vesselI, pos);
-		if (vesselI != GetHandle() && length(pos) < *distance && oapiGetMass(vesselI) > 1e4) // must be large enough to fit to pad
-		{
-			*closestVessel = vesselI;
-			*distance = length(pos);
-		}
-	}
-}
-
 void ProjectMercury::DefineAnimation(void)
 {
 	const int additionalGroupsNum = 2;
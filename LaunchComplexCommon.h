@@ -0,0 +1,68 @@
+#pragma once
+// Functions shared by the launch pads (LC14, LC5 and Little Joe ramp). Include after the class declaration.
+// Each pad defines PAD_ROCKET_MIN_MASS and PAD_MAX_CANDIDATES, and declares the padCandidate members.
+
+// Previously every pad looped through all vessels in the simulation every timestep, to find the closest rocket.
+// With many vessels (or several pads) this adds up. Now we only check a small set of candidates near the pad,
+// which is refreshed on a slow schedule, or when a vessel is created or deleted.
+const double PAD_CANDIDATE_RADIUS = 5e3; // m. Rocket is around 40 seconds into flight here, so HUD still shows liftoff data
+const double PAD_CANDIDATE_REFRESH = 5.0; // s, when something is close to the pad
+const double PAD_CANDIDATE_IDLE_REFRESH = 60.0; // s, when nothing is close. Vessel creation/deletion is still caught at once
+
+void ProjectMercury::RefreshPadCandidates(double simt)
+{
+	VECTOR3 pos;
+	OBJHANDLE vesselI;
+	padVesselCount = oapiGetVesselCount();
+	padCandidateNum = 0;
+	for (int i = 0; i < (int)padVesselCount; i++)
+	{
+		vesselI = oapiGetVesselByIndex(i);
+		if (vesselI == GetHandle() || oapiGetMass(vesselI) <= PAD_ROCKET_MIN_MASS) // must be large enough to fit to pad
+			continue;
+
+		GetRelativePos(vesselI, pos);
+		if (length(pos) < PAD_CANDIDATE_RADIUS && padCandidateNum < PAD_MAX_CANDIDATES)
+		{
+			padCandidate[padCandidateNum] = vesselI;
+			padCandidateNum += 1;
+		}
+	}
+
+	if (padCandidateNum > 0)
+		padCandidateRefreshTime = simt + PAD_CANDIDATE_REFRESH;
+	else
+		padCandidateRefreshTime = simt + PAD_CANDIDATE_IDLE_REFRESH; // launched rocket is out of range, so go idle
+}
+
+void ProjectMercury::GetClosestVessel(OBJHANDLE* closestVessel, double* distance)
+{
+	VECTOR3 pos;
+
+	// While attached we already know which rocket it is, so no need to look for it
+	OBJHANDLE attached = GetAttachmentStatus(rocketAttach);
+	if (attached != NULL && oapiIsVessel(attached))
+	{
+		GetRelativePos(attached, pos);
+		*closestVessel = attached;
+		*distance = length(pos);
+		return;
+	}
+
+	double simt = oapiGetSimTime();
+	if (oapiGetVesselCount() != padVesselCount || simt > padCandidateRefreshTime || simt < padCandidateRefreshTime - PAD_CANDIDATE_IDLE_REFRESH) // vessel created or deleted, time for refresh, or time has jumped backwards
+		RefreshPadCandidates(simt);
+
+	for (int i = 0; i < padCandidateNum; i++)
+	{
+		if (!oapiIsVessel(padCandidate[i])) // deleted since last refresh
+			continue;
+
+		GetRelativePos(padCandidate[i], pos);
+		if (length(pos) < *distance && oapiGetMass(padCandidate[i]) > PAD_ROCKET_MIN_MASS)
+		{
+			*closestVessel = padCandidate[i];
+			*distance = length(pos);
+		}
+	}
+}
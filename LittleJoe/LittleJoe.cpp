@@ -18,6 +18,15 @@
 #define VESSELVER VESSEL4
 
 #include "orbitersdk.h"
+#include "..\DebrisManager.h"
+#include "..\HudTextCache.h"
+#include "..\MercurySettings.h"
+#include "..\TextureCache.h"
+#include "..\AsyncTextureLoader.h"
+#include "..\FlightRecorder.h"
+#include "..\FlightHistory.h"
+#include "..\MercuryLog.h"
+#include "..\MercuryProfiler.h"
 #include "LittleJoe.h"
 #include "..\FunctionsForOrbiter2016.h"
 #include "..\MercuryCapsule.h"
@@ -382,60 +391,40 @@ void ProjectMercury::clbkPostCreation()
 		boosterSeparated = true;
 		towerJettisoned = true;
 	}
+
+	// Load everything we may separate now, instead of at separation
+	PrewarmCapsuleSeparations();
+	if (!towerJettisoned)
+	{
+		debris.Prewarm("ProjectMercury\\Mercury_Abort");
+		debris.Prewarm("ProjectMercury\\Mercury_AbortNominal");
+	}
+	if (!boosterSeparated)
+	{
+		debris.Prewarm("Vessels\\ProjectMercury\\LittleJoeBooster");
+		debris.Prewarm("ProjectMercury\\Mercury_AdaptCover1");
+		debris.Prewarm("ProjectMercury\\Mercury_AdaptCover2");
+		debris.Prewarm("ProjectMercury\\Mercury_AdaptCover3");
+		debris.Prewarm("ProjectMercury\\Mercury_AdaptRing1");
+		debris.Prewarm("ProjectMercury\\Mercury_AdaptRing2");
+		debris.Prewarm("ProjectMercury\\Mercury_AdaptRing3");
+	}
 }
 
 void ProjectMercury::clbkPreStep(double simt, double simdt, double mjd)
 {
+	PROFILE_FRAME(); // see MercuryProfiler.h
+	PROFILE_SCOPE(PROF_PRESTEP);
+	UpdateFlightState(simt); // read once, used by HUD, panel and retro calculations
+	textureQueue.Update(); // apply replacement textures that have been read
+	TextureCache::Global().ReleaseIdle(oapiGetSysTime()); // replacement textures no vessel has needed for a while
+
 	// Automatic abort
 	if (VesselStatus == LAUNCH && abortConditionsMet)
 		LaunchAbort();
 
 	// Actions
-	if (separateTowerAction)
-	{
-		TowerSeparation();
-		separateTowerAction = false;
-	}
-	else if (separateCapsuleAction)
-	{
-		CapsuleSeparate();
-		separateCapsuleAction = false;
-	}
-	else if (prepareReentryAction)
-	{
-		PrepareReentry();
-		prepareReentryAction = false;
-	}
-	else if (separateRetroCoverAction[0])
-	{
-		SeparateRetroCoverN(1);
-		separateRetroCoverAction[1 - 1] = false;
-	}
-	else if (separateRetroCoverAction[1])
-	{
-		SeparateRetroCoverN(2);
-		separateRetroCoverAction[2 - 1] = false;
-	}
-	else if (separateRetroCoverAction[2])
-	{
-		SeparateRetroCoverN(3);
-		separateRetroCoverAction[3 - 1] = false;
-	}
-	else if (separateDrogueCoverAction)
-	{
-		SeparateDrogueCover();
-		separateDrogueCoverAction = false;
-	}
-	else if (separateDrogueAction)
-	{
-		SeparateDrogue();
-		separateDrogueAction = false;
-	}
-	else if (separateMainChuteAction)
-	{
-		SeparateMainChute();
-		separateMainChuteAction = false;
-	}
+	ProcessActionQueue(simt, simdt);
 
 	SetEmptyMass(EmptyMass()); // calculate drymass of current setting (launch, abort, flight ...)
 
@@ -564,13 +553,13 @@ void ProjectMercury::clbkPreStep(double simt, double simdt, double mjd)
 		}
 		else if (!mainChuteSeparated && GroundContact())
 		{
-			separateMainChuteAction = true;
+			QueueAction(ACTION_SEPARATEMAINCHUTE);
 			oapiWriteLog("sep main on contact");
 		}
 		else if (reserveChuteDeployed && !reserveChuteSeparated && GroundContact())
 		{
 			oapiWriteLog("Sep reserve on contact");
-			separateMainChuteAction = true;
+			QueueAction(ACTION_SEPARATEMAINCHUTE);
 		}
 
 		if (mainChuteDeployed)
@@ -645,7 +634,7 @@ void ProjectMercury::clbkPreStep(double simt, double simdt, double mjd)
 		}
 	}
 
-	DeleteRogueVessels();
+	debris.Update(GetHandle());
 
 	if (periscope && PeriscopeStatus != P_DEPLOYED)
 	{
@@ -677,6 +666,7 @@ void ProjectMercury::clbkPreStep(double simt, double simdt, double mjd)
 
 void ProjectMercury::clbkPostStep(double simt, double simdt, double mjd)
 {
+	PROFILE_SCOPE(PROF_POSTSTEP);
 	if (VesselStatus == LAUNCH || VesselStatus == TOWERSEP)
 	{
 		// Abort due to failure mode
@@ -690,9 +680,7 @@ void ProjectMercury::clbkPostStep(double simt, double simdt, double mjd)
 		if (currentThrusterLevel == 0.0 && previousThrusterLevel != 0.0)
 		{
 			// Ran dry
-			char cbuf[256];
-			sprintf(cbuf, "Booster cutoff T+%.1f", simt - launchTime); // debug
-			oapiWriteLog(cbuf);
+			MLOG_INFO("Booster cutoff T+%.1f", simt - launchTime); // debug
 
 			historyCutOffAlt = GetAltitude();
 			VECTOR3 currentSpaceVelocity;
@@ -724,16 +712,16 @@ void ProjectMercury::clbkPostStep(double simt, double simdt, double mjd)
 		{
 			// Unguided launch
 		}
-		else if (simt - boosterShutdownTime > 0.5)
+		else if (simt + simdt - boosterShutdownTime > 0.5)
 		{
-			separateTowerAction = true;
+			QueueActionAt(ACTION_SEPARATETOWER, boosterShutdownTime + 0.5); // queued one step ahead, so that it can land at the right time
 		}
 	}
 	else if (autoPilot && VesselStatus == TOWERSEP)
 	{
-		if (simt - boosterShutdownTime > 9.5 && vesselAcceleration < 0.25 * G)
+		if (simt + simdt - boosterShutdownTime > 9.5 && vesselAcceleration < 0.25 * G)
 		{
-			separateCapsuleAction = true;
+			QueueActionAt(ACTION_SEPARATECAPSULE, boosterShutdownTime + 9.5);
 		}
 	}
 	else
@@ -771,6 +759,11 @@ int ProjectMercury::clbkConsumeBufferedKey(DWORD key, bool down, char* kstate)
 				showInfoOnHud = 0;
 			}
 			return 1;
+#if MERCURY_PROFILE
+		case OAPI_KEY_Y: // profiler on HUD
+			PROFILE_TOGGLE_HUD();
+			return 1;
+#endif
 		case OAPI_KEY_R:
 			if (VesselStatus == REENTRY)
 			{
@@ -811,7 +804,7 @@ int ProjectMercury::clbkConsumeBufferedKey(DWORD key, bool down, char* kstate)
 			}
 			else if (VesselStatus == TOWERSEP)
 			{
-				separateCapsuleAction = true;
+				QueueAction(ACTION_SEPARATECAPSULE);
 				autoPilot = false;
 			}
 			else if (VesselStatus == ABORT)
@@ -824,7 +817,7 @@ int ProjectMercury::clbkConsumeBufferedKey(DWORD key, bool down, char* kstate)
 			else if (VesselStatus == FLIGHT)
 			{
 				// Engage reentry-mode
-				prepareReentryAction = true;
+				QueueAction(ACTION_PREPAREREENTRY);
 			}
 			else if (VesselStatus == ABORTNORETRO) // If on-pad abort, where just tower and capsule eject
 			{
@@ -841,7 +834,7 @@ int ProjectMercury::clbkConsumeBufferedKey(DWORD key, bool down, char* kstate)
 			else if (VesselStatus == REENTRY && drogueDeployed)
 			{
 				autoPilot = false;
-				separateDrogueAction = true;
+				QueueAction(ACTION_SEPARATEDROGUE);
 			}
 			else if (VesselStatus == REENTRYNODROGUE && !mainChuteDeployed && !mainChuteSeparated)
 			{
@@ -855,7 +848,7 @@ int ProjectMercury::clbkConsumeBufferedKey(DWORD key, bool down, char* kstate)
 			}
 			else if (VesselStatus == REENTRYNODROGUE && mainChuteDeployed && !mainChuteSeparated)
 			{
-				separateMainChuteAction = true;
+				QueueAction(ACTION_SEPARATEMAINCHUTE);
 				//oapiWriteLog("SepMainKey");
 			}
 			else if (VesselStatus == REENTRYNODROGUE && mainChuteSeparated && !reserveChuteDeployed)
@@ -905,7 +898,7 @@ int ProjectMercury::clbkConsumeBufferedKey(DWORD key, bool down, char* kstate)
 		case OAPI_KEY_K:
 			if (VesselStatus == LAUNCH && GetThrusterLevel(th_castor[0]) == 0.0 && GetThrusterLevel(th_castor[1]) == 0.0) // C++ should exit if first condition is false, omiting a crash for when th_main is deleted
 			{
-				separateTowerAction = true;
+				QueueAction(ACTION_SEPARATETOWER);
 			}
 
 			return 1;
@@ -1000,9 +993,12 @@ int ProjectMercury::clbkConsumeBufferedKey(DWORD key, bool down, char* kstate)
 
 bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketchpad* skp)
 {
+	PROFILE_SCOPE(PROF_DRAWHUD);
 	char cbuf[256];
 	int yIndex = 0;
 
+	PROFILE_DRAW_HUD(skp, TextX0, int(ScreenHeight) - (PROF_NUM_SCOPES + 4) * LineSpacing, LineSpacing);
+
 	if (oapiCockpitMode() == COCKPIT_PANELS && panelView)
 	{
 		if (showInfoOnHud < 2)
@@ -1018,86 +1014,78 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 	if (showInfoOnHud == 0)
 	{
 		// ==== Buttons text ====
-		sprintf(cbuf, "Key commands:");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "Key commands:");
 		yIndex += 1;
 
 		// Button Ctrl+T
-		sprintf(cbuf, "Ctrl+T:Hide on-screen text");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "Ctrl+T:Hide on-screen text");
 		yIndex += 1;
 
 		// Button Ctrl+R
-		sprintf(cbuf, "Ctrl+R:Reload missing meshes");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "Ctrl+R:Reload missing meshes");
 		yIndex += 1;
 
+#if MERCURY_PROFILE
+		// Button Ctrl+Y
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "Ctrl+Y:Show profiler");
+		yIndex += 1;
+#endif
+
 
 		// Key J
 		if (VesselStatus == LAUNCH)
 		{
-			sprintf(cbuf, "J:     ABORT");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     ABORT");
 			yIndex += 1;
 		}
 		else if (VesselStatus == TOWERSEP)
 		{
-			sprintf(cbuf, "J:     Separate capsule");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate capsule");
 			yIndex += 1;
 		}
 		else if (VesselStatus == ABORT)
 		{
-			sprintf(cbuf, "J:     Separate escape tower");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate escape tower");
 			yIndex += 1;
 		}
 		else if (VesselStatus == FLIGHT)
 		{
-			sprintf(cbuf, "J:     Separate retropack");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate retropack");
 			yIndex += 1;
 		}
 		else if (VesselStatus == ABORTNORETRO)
 		{
-			sprintf(cbuf, "J:     Separate escape tower");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate escape tower");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRY && !drogueDeployed)
 		{
-			sprintf(cbuf, "J:     Deploy drogue chute");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Deploy drogue chute");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRY && drogueDeployed)
 		{
-			sprintf(cbuf, "J:     Separate drogue chute");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate drogue chute");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRYNODROGUE && !mainChuteDeployed && !mainChuteSeparated)
 		{
-			sprintf(cbuf, "J:     Deploy main chute");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Deploy main chute");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRYNODROGUE && !landingBagDeployed)
 		{
-			sprintf(cbuf, "J:     Deploy landing bag");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Deploy landing bag");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRYNODROGUE && mainChuteDeployed && !mainChuteSeparated)
 		{
-			sprintf(cbuf, "J:     Separate main chute");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate main chute");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRYNODROGUE && mainChuteSeparated && !reserveChuteDeployed)
 		{
-			sprintf(cbuf, "J:     Deploy reserve chute");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Deploy reserve chute");
 			yIndex += 1;
 		}
 
@@ -1106,31 +1094,27 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		{
 			if (!spaceLaunch)
 			{
-				sprintf(cbuf, "SPACE: Engine on");
-				skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "SPACE: Engine on");
 				yIndex += 1;
 			}
 		}
 		else if (VesselStatus == FLIGHT)
 		{
-			sprintf(cbuf, "SPACE: Fire retros");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "SPACE: Fire retros");
 			yIndex += 1;
 		}
 
 		// Key P
 		if (GroundContact() && VesselStatus == LAUNCH)
 		{
-			sprintf(cbuf, "P:     Automatic launch");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "P:     Automatic launch");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRYNODROGUE)
 		{
 			if (!engageFuelDump)
 			{
-				sprintf(cbuf, "P:     Fuel dump");
-				skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "P:     Fuel dump");
 				yIndex += 1;
 			}
 
@@ -1139,43 +1123,37 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		// Key K
 		if (VesselStatus == LAUNCH && GetThrusterLevel(th_castor[0]) == 0.0 && GetThrusterLevel(th_castor[1]) == 0.0) // C++ should exit if first condition is false, omiting a crash for when th_main is deleted
 		{
-			sprintf(cbuf, "K:     Separate escape tower");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "K:     Separate escape tower");
 			yIndex += 1;
 		}
 
 		// Key M
-		sprintf(cbuf, "M:     Disengage autopilot");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "M:     Disengage autopilot");
 		yIndex += 1;
 
 
 		// Key C
 		if (VesselStatus == LAUNCH && GroundContact() && GetAttachmentStatus(padAttach) == NULL)
 		{
-			sprintf(cbuf, "C:     Set focus on launch ramp");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "C:     Set focus on launch ramp");
 			yIndex += 1;
 		}
 		else if (periscope)
 		{
-			if (narrowField) sprintf(cbuf, "C:     Set periscope WIDE aperture");
-			else  sprintf(cbuf, "C:     Set periscope NARROW aperture");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			if (narrowField) hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "C:     Set periscope WIDE aperture");
+			else hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "C:     Set periscope NARROW aperture");
 			yIndex += 1;
 		}
 		else if (rocketCam)
 		{
-			sprintf(cbuf, "C:     Switch rocket camera view");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "C:     Switch rocket camera view");
 			yIndex += 1;
 		}
 
 		// Key V and B
 		if (periscope)
 		{
-			sprintf(cbuf, "B/V:   Set periscope altitude +/-");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "B/V:   Set periscope altitude +/-");
 			yIndex += 1;
 		}
 	}
@@ -1212,43 +1190,36 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		int metM = (int)floor(metAbs / 60.0);
 		int metS = (int)floor((metAbs - metM * 60.0));
 
-		sprintf(cbuf, "T%s%02i %02i", signChar, metM, metS);
-		skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "T%s%02i %02i", signChar, metM, metS);
 		yIndex += 1;
 
 		// ==== Autopilot status ====
 		if (autoPilot && VesselStatus != REENTRYNODROGUE)
 		{
-			sprintf(cbuf, "Autopilot: ON");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Autopilot: ON");
 			yIndex += 1;
 		}
 		else if (!autoPilot && VesselStatus != REENTRYNODROGUE)
 		{
-			sprintf(cbuf, "Autopilot: OFF");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Autopilot: OFF");
 			yIndex += 1;
 		}
 
 		if (VesselStatus == FLIGHT)
 		{
-			sprintf(cbuf, "Retrosequence time:");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Retrosequence time:");
 			yIndex += 1;
 
-			sprintf(cbuf, "  %02i %02i", 4, 44);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  %02i %02i", 4, 44);
 			yIndex += 1;
 		}
 
 		if ((VesselStatus == FLIGHT || VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE) && fuel_manual != NULL) // there's a pesky crash if one checks for propellant level of a non-created propellant source
 		{
-			sprintf(cbuf, "Manual fuel: %.1f %%", GetPropellantMass(fuel_manual) / MERCURY_FUEL_MASS_MAN * 100.0);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Manual fuel: %.1f %%", flightState.fuelManual / MERCURY_FUEL_MASS_MAN * 100.0);
 			yIndex += 1;
 
-			sprintf(cbuf, "Auto fuel: %.1f %%", GetPropellantMass(fuel_auto) / MERCURY_FUEL_MASS_AUTO * 100.0);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Auto fuel: %.1f %%", flightState.fuelAuto / MERCURY_FUEL_MASS_AUTO * 100.0);
 			yIndex += 1;
 		}
 
@@ -1260,33 +1231,28 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		double longAcc = (F - W).z / m;
 		if (longAcc > 21.0 * G) longAcc = 21.0 * G;
 		if (longAcc < -9.0 * G) longAcc = -9.0 * G;
-		sprintf(cbuf, "Longitudinal acceleration: %.1f g", longAcc / G);
-		skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Longitudinal acceleration: %.1f g", longAcc / G);
 		yIndex += 1;
 
 		// Descent rate
-		VECTOR3 groundSpeedVec;
-		GetAirspeedVector(FRAME_HORIZON, groundSpeedVec);
-		double descRate = groundSpeedVec.y;
+		double descRate = flightState.airspeedHorizon.y;
 		if (descRate > 0.0) descRate = 0.0;
 		if (descRate < -43.0) descRate = -43.0;
-		if (GetAltitude() > 5e4) descRate = 0.0;
+		if (flightState.altitude > 5e4) descRate = 0.0;
 		DWORD previousTextColour; // red
 		previousTextColour = skp->SetTextColor(0x0000FF); // red
 		if (descRate > -9.754) skp->SetTextColor(0x00FF00); // green
-		sprintf(cbuf, "Descent: %.1f m/s", -descRate);
-		skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Descent: %.1f m/s", -descRate);
 		yIndex += 1;
 		skp->SetTextColor(previousTextColour);
 
 		// Altitude
-		double airAltitude = GetAltitude();
+		double airAltitude = flightState.altitude;
 		if (airAltitude > 30480.0) airAltitude = 30480.0;
 		previousTextColour = skp->SetTextColor(0x00FF00); // green
 		if (airAltitude < 3048.0) skp->SetTextColor(0x0000FF); // red
 		else if (airAltitude < 6401.0) skp->SetTextColor(0x00FFFF); // yellow
-		sprintf(cbuf, "Altitude: %.0f m", floor(airAltitude / 10.0) * 10.0);
-		skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Altitude: %.0f m", floor(airAltitude / 10.0) * 10.0);
 		yIndex += 1;
 		skp->SetTextColor(previousTextColour);
 
@@ -1296,21 +1262,18 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		{
 			if (AutopilotStatus == AUTOLAUNCH)
 			{
-				sprintf(cbuf, "Awaiting cutoff");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Awaiting cutoff");
 				yIndex += 1;
 			}
 			else
 			{
-				sprintf(cbuf, "Separate escape tower in %.2f s", 0.5 + boosterShutdownTime - simt);
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Separate escape tower in %.2f s", 0.5 + boosterShutdownTime - simt);
 				yIndex += 1;
 			}
 		}
 		else if (autoPilot && VesselStatus == TOWERSEP)
 		{
-			sprintf(cbuf, "Separate capsule in %.2f s", 9.5 + boosterShutdownTime - simt);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Separate capsule in %.2f s", 9.5 + boosterShutdownTime - simt);
 			yIndex += 1;
 		}
 		else
@@ -1321,48 +1284,40 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		// Launch target pitch and yaw
 		if (autoPilot && VesselStatus == LAUNCH)
 		{
-			sprintf(cbuf, "Current pitch:");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Current pitch:");
 			yIndex += 1;
 
-			sprintf(cbuf, "  %.2f\u00B0", GetPitch() * DEG);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  %.2f\u00B0", flightState.pitch * DEG);
 			yIndex += 1;
 		}
 		else if (VesselStatus == LAUNCH)
 		{
-			VECTOR3 angVel;
-			GetAngularVel(angVel);
+			VECTOR3 angVel = flightState.angVel;
 
-			sprintf(cbuf, "Pitch rate: %.2f\u00B0/s", angVel.x * DEG);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Pitch rate: %.2f\u00B0/s", angVel.x * DEG);
 			yIndex += 1;
 
-			sprintf(cbuf, "Yaw rate: %.2f\u00B0/s", angVel.y * DEG);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Yaw rate: %.2f\u00B0/s", angVel.y * DEG);
 			yIndex += 1;
 		}
 
 		// Chute status
 		if (VesselStatus == REENTRY && drogueDeployed)
 		{
-			sprintf(cbuf, "Drogue chute deployed");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Drogue chute deployed");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRYNODROGUE)
 		{
 			if (mainChuteDeployed)
 			{
-				sprintf(cbuf, "Main chute deploy (%.2f)", GetAnimation(MainChuteDeployAnim));
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Main chute deploy (%.2f)", GetAnimation(MainChuteDeployAnim));
 				yIndex += 1;
 			}
 
 			if (landingBagDeployed)
 			{
-				sprintf(cbuf, "Landing bag deploy (%.2f)", GetAnimation(LandingBagDeployAnim));
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Landing bag deploy (%.2f)", GetAnimation(LandingBagDeployAnim));
 				yIndex += 1;
 			}
 		}
@@ -1371,63 +1326,54 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		{
 			if (switchASCSMode == -1 && switchControlMode == -1)
 			{
-				sprintf(cbuf, "ASCS auto attitude");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "ASCS auto attitude");
 				yIndex += 1;
 			}
 
 			if (switchASCSMode == 0 && switchControlMode == -1)
 			{
-				sprintf(cbuf, "AUX damp");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "AUX damp");
 				yIndex += 1;
 			}
 
 			if (switchASCSMode == 1)
 			{
-				sprintf(cbuf, "Fly By Wire");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Fly By Wire");
 				yIndex += 1;
 			}
 
 			if (!tHandlePitchPushed)
 			{
-				sprintf(cbuf, "  Auto pitch thrusters OFF");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  Auto pitch thrusters OFF");
 				yIndex += 1;
 			}
 			if (!tHandleYawPushed)
 			{
-				sprintf(cbuf, "  Auto yaw thrusters OFF");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  Auto yaw thrusters OFF");
 				yIndex += 1;
 			}
 
 			if (!tHandleRollPushed)
 			{
-				sprintf(cbuf, "  Auto roll thrusters OFF");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  Auto roll thrusters OFF");
 				yIndex += 1;
 			}
 
 			if (!tHandleManualPushed)
 			{
-				sprintf(cbuf, "Manual direct");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Manual direct");
 				yIndex += 1;
 			}
 
 			if (tHandleManualPushed && switchControlMode == 1)
 			{
-				sprintf(cbuf, "Rate command (RSCS)");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Rate command (RSCS)");
 				yIndex += 1;
 			}
 
 			if (engageFuelDump)
 			{
-				sprintf(cbuf, "Dumping attitude fuel");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Dumping attitude fuel");
 				yIndex += 1;
 			}
 		}
@@ -1445,154 +1391,122 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 
 void ProjectMercury::clbkLoadStateEx(FILEHANDLE scn, void* status)
 {
-	int i = 0;
-	char* cbuf;
-
-	while (oapiReadScenario_nextline(scn, cbuf))
-	{
-		if (!_strnicmp(cbuf, "STATE", 5))
-		{
-			sscanf_s(cbuf + 5, "%i", &VesselStatus); // consider changing back to normal sscanf (opposed to sscanf_s)
-		}
-		else if (!_strnicmp(cbuf, "CAPSULE", 7))
-		{
-			LoadCapsule(cbuf + 8); // don't send space after "CAPSULE "
-		}
-		else if (!_strnicmp(cbuf, "CASTORFIRETIME", 14))
-		{
-			sscanf_s(cbuf + 14, "%lf", &castorFireTime);
-		}
-		else if (!_strnicmp(cbuf, "AUTOMODE", 8))
-		{
-			sscanf_s(cbuf + 8, "%i", &AutopilotStatus);
-		}
-		else if (!_strnicmp(cbuf, "SUBORBITAL", 10))
-		{
-			int readToBool;
-			sscanf_s(cbuf + 10, "%i", &readToBool);
-			suborbitalMission = (bool)readToBool;
-		}
-		else if (!_strnicmp(cbuf, "ABORTBUS", 8))
-		{
-			int readToBool;
-			sscanf_s(cbuf + 8, "%i", &readToBool);
-			enableAbortConditions = (bool)readToBool;
-		}
-		else if (!_strnicmp(cbuf, "MET", 3))
-		{
-			int metTime;
-			sscanf_s(cbuf + 3, "%i", &metTime);
-			launchTime = oapiGetSimTime() - (double)metTime;
-		}
-		else if (!_strnicmp(cbuf, "FAILURE", 7)) // input -1 for random failure (or possibly none if HARDMODE is not defined)
-		{
-			int inputFailure;
-			sscanf_s(cbuf + 7, "%i", &inputFailure);
-			if (inputFailure == -1)
-			{
-				inputFailure = rand() % ((int)LASTENTRY - 1) + 1; // this should return a "random" integer between 1 and 12 (or the number of total modes in FailureMode enum)
-			}
-
-			FailureMode = (failure)inputFailure;
-			// Actual failure determination is done in clbkPostCreation, as we then have result from HARDMODE
-		}
-		else if (!_strnicmp(cbuf, "HARDMODE", 8))
-		{
-			difficultyHard = true;
-		}
-		else if (!_strnicmp(cbuf, "LOGERROR", 8))
-		{
-			logError = true;
-		}
-		else if (!_strnicmp(cbuf, "REPLACETEXTURE", 14))
-		{
-			scenarioTextureUserEnable = true; // Load textures
-			ReadCapsuleTextureReplacement(cbuf + 15); // don't send space char after REPLACETEXTURE
-		}
-		else if (!_strnicmp(cbuf, "SWITCHAUTRETJET", 15))
-		{
-			switchAutoRetroJet = atoi(cbuf + 15);
-		}
-		else if (!_strnicmp(cbuf, "SWITCHRETRODELA", 15))
-		{
-			switchRetroDelay = atoi(cbuf + 15);
-		}
-		else if (!_strnicmp(cbuf, "SWITCHRETROATTI", 15))
-		{
-			switchRetroAttitude = atoi(cbuf + 15);
-		}
-		else if (!_strnicmp(cbuf, "SWITCHASCSMODE", 14))
-		{
-			switchASCSMode = atoi(cbuf + 14);
-		}
-		else if (!_strnicmp(cbuf, "SWITCHCONTRMODE", 15))
-		{
-			switchControlMode = atoi(cbuf + 15);
-		}
-		else if (!_strnicmp(cbuf, "THANDLEMANUAL", 13))
-		{
-			tHandleManualPushed = bool(atoi(cbuf + 13));
-		}
-		else if (!_strnicmp(cbuf, "THANDLEPITCH", 12))
-		{
-			tHandlePitchPushed = bool(atoi(cbuf + 12));
-		}
-		else if (!_strnicmp(cbuf, "THANDLEYAW", 10))
-		{
-			tHandleYawPushed = bool(atoi(cbuf + 10));
-		}
-		else if (!_strnicmp(cbuf, "THANDLEROLL", 11))
-		{
-			tHandleRollPushed = bool(atoi(cbuf + 11));
-		}
-		else ParseScenarioLineEx(cbuf, status);
-	}
+	LoadScenarioKeys(scn, status); // see ScenarioKeys
 }
 
-void ProjectMercury::clbkSaveState(FILEHANDLE scn)
+// Scenario keywords, in the order they are saved. See LoadScenarioKeys in MercuryCapsule.h
+const SCENARIOKEY* ProjectMercury::ScenarioKeys(int* numKeys)
 {
-	VESSELVER::clbkSaveState(scn); // write default parameters (orbital elements etc.)
-
-	oapiWriteScenario_int(scn, "STATE", VesselStatus);
-
-	if (configTextureUserEnable) oapiWriteScenario_string(scn, "CAPSULE", configTextureUserName[configTextureUserNum]);
-	else oapiWriteScenario_int(scn, "CAPSULE", CapsuleVersion);
-
-	oapiWriteScenario_int(scn, "AUTOMODE", AutopilotStatus);
-
-	oapiWriteScenario_int(scn, "SUBORBITAL", suborbitalMission);
+	static const SCENARIOKEY keys[] = {
+		ScenarioSpecial("STATE", SCN_STATE, true),
+		ScenarioSpecial("CAPSULE", SCN_CAPSULE, true),
+		ScenarioSpecial("AUTOMODE", SCN_AUTOMODE, true),
+		ScenarioBool("SUBORBITAL", &ProjectMercury::suborbitalMission, true),
+		ScenarioBool("ABORTBUS", &ProjectMercury::enableAbortConditions, true),
+		ScenarioSpecial("MET", SCN_MET, true),
+		ScenarioSpecial("FAILURE", SCN_FAILURE, true),
+		ScenarioFlag("HARDMODE", &ProjectMercury::difficultyHard, true),
+		ScenarioInt("SWITCHAUTRETJET", &ProjectMercury::switchAutoRetroJet, true),
+		ScenarioInt("SWITCHRETRODELA", &ProjectMercury::switchRetroDelay, true),
+		ScenarioInt("SWITCHRETROATTI", &ProjectMercury::switchRetroAttitude, true),
+		ScenarioInt("SWITCHASCSMODE", &ProjectMercury::switchASCSMode, true),
+		ScenarioInt("SWITCHCONTRMODE", &ProjectMercury::switchControlMode, true),
+		ScenarioBool("THANDLEMANUAL", &ProjectMercury::tHandleManualPushed, true),
+		ScenarioBool("THANDLEPITCH", &ProjectMercury::tHandlePitchPushed, true),
+		ScenarioBool("THANDLEYAW", &ProjectMercury::tHandleYawPushed, true),
+		ScenarioBool("THANDLEROLL", &ProjectMercury::tHandleRollPushed, true),
+		ScenarioSpecial("REPLACETEXTURE", SCN_REPLACETEXTURE, true),
+		ScenarioSpecial("CHECKPOINT", SCN_CHECKPOINT, true), // binary file with the internal state, see CheckpointFields
+		// Only read
+		ScenarioDouble("CASTORFIRETIME", &ProjectMercury::castorFireTime, false),
+		ScenarioFlag("LOGERROR", &ProjectMercury::logError, false),
+	};
 
-	oapiWriteScenario_int(scn, "ABORTBUS", enableAbortConditions);
+	*numKeys = sizeof(keys) / sizeof(keys[0]);
+	return keys;
+}
 
-	if (launchTime != 0.0) // if we have launched using autopilot
-	{
-		oapiWriteScenario_int(scn, "MET", int(oapiGetSimTime() - launchTime));
-	}
+// Internal state saved in the binary checkpoint, see SaveCheckpoint in MercuryCapsule.h.
+// Changing this list makes old checkpoints unreadable (they are then ignored).
+const SCENARIOKEY* ProjectMercury::CheckpointFields(int* numFields)
+{
+	static const SCENARIOKEY fields[] = {
+		// Flight history
+		ScenarioDouble("historyMaxAltitude", &ProjectMercury::historyMaxAltitude, true),
+		ScenarioDouble("historyPerigee", &ProjectMercury::historyPerigee, true),
+		ScenarioDouble("historyPeriod", &ProjectMercury::historyPeriod, true),
+		ScenarioDouble("historyBottomPrev", &ProjectMercury::historyBottomPrev, true),
+		ScenarioDouble("historyBottomPrevPrev", &ProjectMercury::historyBottomPrevPrev, true),
+		ScenarioDouble("historyInclination", &ProjectMercury::historyInclination, true),
+		ScenarioDouble("historyCutOffAlt", &ProjectMercury::historyCutOffAlt, true),
+		ScenarioDouble("historyCutOffVel", &ProjectMercury::historyCutOffVel, true),
+		ScenarioDouble("historyCutOffAngl", &ProjectMercury::historyCutOffAngl, true),
+		ScenarioDouble("historyCutOffLat", &ProjectMercury::historyCutOffLat, true),
+		ScenarioDouble("historyCutOffLong", &ProjectMercury::historyCutOffLong, true),
+		ScenarioDouble("historyMaxEarthSpeed", &ProjectMercury::historyMaxEarthSpeed, true),
+		ScenarioDouble("historyMaxSpaceSpeed", &ProjectMercury::historyMaxSpaceSpeed, true),
+		ScenarioDouble("historyMaxLaunchAcc", &ProjectMercury::historyMaxLaunchAcc, true),
+		ScenarioDouble("historyMaxReentryAcc", &ProjectMercury::historyMaxReentryAcc, true),
+		ScenarioDouble("historyLaunchLat", &ProjectMercury::historyLaunchLat, true),
+		ScenarioDouble("historyLaunchLong", &ProjectMercury::historyLaunchLong, true),
+		ScenarioDouble("historyLandLat", &ProjectMercury::historyLandLat, true),
+		ScenarioDouble("historyLandLong", &ProjectMercury::historyLandLong, true),
+		ScenarioDouble("historyLaunchHeading", &ProjectMercury::historyLaunchHeading, true),
+		ScenarioDouble("historyWeightlessTime", &ProjectMercury::historyWeightlessTime, true),
+		ScenarioDouble("maxVesselAcceleration", &ProjectMercury::maxVesselAcceleration, true),
+		ScenarioDouble("minVesselAcceleration", &ProjectMercury::minVesselAcceleration, true),
+		// Event times
+		ScenarioSimTime("launchTime", &ProjectMercury::launchTime, true),
+		ScenarioSimTime("boosterShutdownTime", &ProjectMercury::boosterShutdownTime, true),
+		ScenarioSimTime("retroStartTime", &ProjectMercury::retroStartTime, true),
+		ScenarioSimTime("abortTime", &ProjectMercury::abortTime, true),
+		ScenarioSimTime("towerJetTime", &ProjectMercury::towerJetTime, true),
+		ScenarioSimTime("posigradeDampingTime", &ProjectMercury::posigradeDampingTime, true),
+		ScenarioSimTime("drogueDeployTime", &ProjectMercury::drogueDeployTime, true),
+		ScenarioSimTime("drogueReefedTime", &ProjectMercury::drogueReefedTime, true),
+		ScenarioSimTime("mainChuteDeployTime", &ProjectMercury::mainChuteDeployTime, true),
+		ScenarioSimTime("mainChuteReefedTime", &ProjectMercury::mainChuteReefedTime, true),
+		ScenarioDouble("castorFireTime", &ProjectMercury::castorFireTime, true),
+		// Autopilot and attitude
+		ScenarioDouble("currentPitchAim", &ProjectMercury::currentPitchAim, true),
+		ScenarioDouble("eulerPitch", &ProjectMercury::eulerPitch, true),
+		ScenarioDouble("eulerYaw", &ProjectMercury::eulerYaw, true),
+		ScenarioDouble("escapeLevel", &ProjectMercury::escapeLevel, true),
+		ScenarioDouble("oldAngle", &ProjectMercury::oldAngle, true),
+		// Retro and reentry solution
+		ScenarioDouble("lowGLat", &ProjectMercury::lowGLat, true),
+		ScenarioDouble("lowGLong", &ProjectMercury::lowGLong, true),
+		ScenarioDouble("lowGHeading", &ProjectMercury::lowGHeading, true),
+		ScenarioDouble("entryAng", &ProjectMercury::entryAng, true),
+		ScenarioDouble("entryAngleToBase", &ProjectMercury::entryAngleToBase, true),
+		// Sequencing
+		ScenarioBool("engageRetro", &ProjectMercury::engageRetro, true),
+		ScenarioBool("posigradeDampingActivated", &ProjectMercury::posigradeDampingActivated, true),
+		ScenarioBool("turnAroundFinished", &ProjectMercury::turnAroundFinished, true),
+		ScenarioBool("passedBase", &ProjectMercury::passedBase, true),
+		// Orbit
+		ScenarioInt("orbitCount", &ProjectMercury::orbitCount, true),
+	};
 
-	oapiWriteScenario_int(scn, "FAILURE", FailureMode);
+	*numFields = sizeof(fields) / sizeof(fields[0]);
+	return fields;
+}
 
-	if (difficultyHard)
-	{
-		oapiWriteScenario_string(scn, "HARDMODE", "");
-	}
+void ProjectMercury::LoadScenarioSpecial(int special, const char* value)
+{
+	LoadScenarioCommon(special, value);
+}
 
-	oapiWriteScenario_int(scn, "SWITCHAUTRETJET", switchAutoRetroJet);
-	oapiWriteScenario_int(scn, "SWITCHRETRODELA", switchRetroDelay);
-	oapiWriteScenario_int(scn, "SWITCHRETROATTI", switchRetroAttitude);
-	oapiWriteScenario_int(scn, "SWITCHASCSMODE", switchASCSMode);
-	oapiWriteScenario_int(scn, "SWITCHCONTRMODE", switchControlMode);
+void ProjectMercury::SaveScenarioSpecial(FILEHANDLE scn, int special, const char* key)
+{
+	SaveScenarioCommon(scn, special, key);
+}
 
-	oapiWriteScenario_int(scn, "THANDLEMANUAL", (int)tHandleManualPushed);
-	oapiWriteScenario_int(scn, "THANDLEPITCH", (int)tHandlePitchPushed);
-	oapiWriteScenario_int(scn, "THANDLEYAW", (int)tHandleYawPushed);
-	oapiWriteScenario_int(scn, "THANDLEROLL", (int)tHandleRollPushed);
+void ProjectMercury::clbkSaveState(FILEHANDLE scn)
+{
+	VESSELVER::clbkSaveState(scn); // write default parameters (orbital elements etc.)
 
-	int i = 0;
-	while (scenarioTextureUserEnable && i < numTextures)
-	{
-		oapiWriteScenario_string(scn, "REPLACETEXTURE", textureString[i]);
-		i++;
-	}
+	SaveScenarioKeys(scn); // see ScenarioKeys
 }
 
 
@@ -1728,12 +1642,12 @@ void ProjectMercury::CheckAbortConditions(double simt, double simdt) // These co
 	if (abs(angVel.x * DEG) > 10.0)
 	{
 		abortConditionsMet = true;
-		oapiWriteLogV("Abort due to error in pitch rate at T+%.1f. It was %.1f deg/s", met, angVel.x * DEG);
+		MLOG_WARN_EVERY(1.0, "Abort due to error in pitch rate at T+%.1f. It was %.1f deg/s", met, angVel.x * DEG);
 	}
 	if (abs(angVel.y * DEG) > 10.0)
 	{
 		abortConditionsMet = true;
-		oapiWriteLogV("Abort due to error in yaw rate at T+%.1f. It was %.1f deg/s", met, angVel.y * DEG);
+		MLOG_WARN_EVERY(1.0, "Abort due to error in yaw rate at T+%.1f. It was %.1f deg/s", met, angVel.y * DEG);
 	}
 
 }
@@ -1838,6 +1752,43 @@ MATRIX3 ProjectMercury::RotationMatrix(VECTOR3 angles, bool xyz)
 	return m;
 }
 
+void ProjectMercury::PerformAction(int action)
+{
+	switch (action)
+	{
+	case ACTION_SEPARATETOWER:
+		TowerSeparation();
+		break;
+	case ACTION_SEPARATECAPSULE:
+		CapsuleSeparate();
+		break;
+	case ACTION_PREPAREREENTRY:
+		PrepareReentry();
+		break;
+	case ACTION_SEPARATERETROCOVER1:
+		SeparateRetroCoverN(1);
+		break;
+	case ACTION_SEPARATERETROCOVER2:
+		SeparateRetroCoverN(2);
+		break;
+	case ACTION_SEPARATERETROCOVER3:
+		SeparateRetroCoverN(3);
+		break;
+	case ACTION_SEPARATEDROGUECOVER:
+		SeparateDrogueCover();
+		break;
+	case ACTION_SEPARATEDROGUE:
+		SeparateDrogue();
+		break;
+	case ACTION_SEPARATEMAINCHUTE:
+		SeparateMainChute();
+		break;
+	default:
+		oapiWriteLogV("Unknown action %i", action);
+		break;
+	}
+}
+
 void ProjectMercury::SeparateTower(bool noAbortSep)
 {
 	VESSELSTATUS2 vs;
@@ -1873,7 +1824,7 @@ void ProjectMercury::SeparateTower(bool noAbortSep)
 		vs.fuel->idx = 1;
 		vs.fuel->level = 1.0;
 
-		createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_AbortNominal", &vs);
+		debris.Create(name, "ProjectMercury\\Mercury_AbortNominal", &vs);
 	}
 	else
 	{
@@ -1881,12 +1832,9 @@ void ProjectMercury::SeparateTower(bool noAbortSep)
 		vs.fuel->level = 0.0;
 		AutopilotStatus = LOWG;
 
-		createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_Abort", &vs);
+		debris.Create(name, "ProjectMercury\\Mercury_Abort", &vs);
 	}
 
-	//if (GetAltitude() > 5e4)
-	//	createdAbove50km[stuffCreated] = true;
-	stuffCreated += 1;
 	DelMesh(Tower);
 	DelPropellantResource(escape_tank);
 	DelThruster(escape_engine);
@@ -1960,13 +1908,10 @@ void ProjectMercury::SeparateLittleJoe(void)
 		strcat(name, "1");
 	}
 
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "Vessels\\ProjectMercury\\LittleJoeBooster", &vs);;
-	//if (GetAltitude() > 5e4)
-	//	createdAbove50km[stuffCreated] = true;
-	stuffCreated += 1;
+	debris.Create(name, "Vessels\\ProjectMercury\\LittleJoeBooster", &vs);
 
 	// The thrusterlist spec doesnt seem to work, sadly
-	VESSEL* v = oapiGetVesselInterface(createdVessel[stuffCreated - 1]);
+	VESSEL* v = oapiGetVesselInterface(debris.Last());
 	double levl = GetPropellantMass(castor_propellant[1]);
 	v->SetPropellantMass(v->GetPropellantHandleByIndex(0), levl);
 	if (GetThrusterLevel(th_castor[0]) != 0.0 || GetThrusterLevel(th_castor[1]) != 0.0)
@@ -2014,10 +1959,7 @@ void ProjectMercury::SeparateRingsAndAdapters(VECTOR3 redstoneDirection)
 	vs.rvel += vel2;
 	strcpy(name, GetName());
 	strcat(name, " Adapter Cover 1");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_AdaptCover1", &vs);
-	//if (GetAltitude() > 5e4)
-		//createdAbove50km[stuffCreated] = true;
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\Mercury_AdaptCover1", &vs);
 	DelMesh(Adaptcover1);
 
 	vel = _V(-0.823, -0.475, 0);
@@ -2029,10 +1971,7 @@ void ProjectMercury::SeparateRingsAndAdapters(VECTOR3 redstoneDirection)
 	vs.rvel += vel2;
 	strcpy(name, GetName());
 	strcat(name, " Adapter Cover 2");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_AdaptCover2", &vs);
-	//if (GetAltitude() > 5e4)
-		//createdAbove50km[stuffCreated] = true;
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\Mercury_AdaptCover2", &vs);
 	DelMesh(Adaptcover2);
 
 	vel = _V(0.823, -0.475, 0);
@@ -2044,10 +1983,7 @@ void ProjectMercury::SeparateRingsAndAdapters(VECTOR3 redstoneDirection)
 	vs.rvel += vel2;
 	strcpy(name, GetName());
 	strcat(name, " Adapter Cover 3");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_AdaptCover3", &vs);
-	//if (GetAltitude() > 5e4)
-	//	createdAbove50km[stuffCreated] = true;
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\Mercury_AdaptCover3", &vs);
 	DelMesh(Adaptcover3);
 
 	vel = _V(-0.823, 0.475, 0);
@@ -2059,10 +1995,7 @@ void ProjectMercury::SeparateRingsAndAdapters(VECTOR3 redstoneDirection)
 	vs.rvel += vel2;
 	strcpy(name, GetName());
 	strcat(name, " Adapter Ring 1");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_AdaptRing1", &vs);
-	//if (GetAltitude() > 5e4)
-	//	createdAbove50km[stuffCreated] = true;
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\Mercury_AdaptRing1", &vs);
 	DelMesh(Adaptring1);
 
 	vel = _V(0.0, -0.95, 0);
@@ -2074,10 +2007,7 @@ void ProjectMercury::SeparateRingsAndAdapters(VECTOR3 redstoneDirection)
 	vs.rvel += vel2;
 	strcpy(name, GetName());
 	strcat(name, " Adapter Ring 2");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_AdaptRing2", &vs);
-	//if (GetAltitude() > 5e4)
-	//	createdAbove50km[stuffCreated] = true;
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\Mercury_AdaptRing2", &vs);
 	DelMesh(Adaptring2);
 
 	vel = _V(0.823, 0.475, 0);
@@ -2089,10 +2019,7 @@ void ProjectMercury::SeparateRingsAndAdapters(VECTOR3 redstoneDirection)
 	vs.rvel += vel2;
 	strcpy(name, GetName());
 	strcat(name, " Adapter Ring 3");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_AdaptRing3", &vs);
-	//if (GetAltitude() > 5e4)
-	//	createdAbove50km[stuffCreated] = true;
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\Mercury_AdaptRing3", &vs);
 	DelMesh(Adaptring3);
 }
 
@@ -2158,6 +2085,7 @@ DLLCLBK void ovcExit(VESSEL* vessel)
 
 void ProjectMercury::vliftLittleJoe(VESSEL* v, double aoa, double M, double Re, void* context, double* cl, double* cm, double* cd)
 {
+	PROFILE_SCOPE(PROF_AERO);
 	// The papers on Little Joe aerodynamics are strangely classified. The Little Joe II (Apollo) aerodynamics are luckily not, so we use them here.
 
 	// 19680013484 page 73, the pitching moment is approximately linear, with slope 0.16 * aoa(deg).
@@ -2177,6 +2105,7 @@ void ProjectMercury::vliftLittleJoe(VESSEL* v, double aoa, double M, double Re,
 
 void ProjectMercury::hliftLittleJoe(VESSEL* v, double beta, double M, double Re, void* context, double* cl, double* cm, double* cd)
 {
+	PROFILE_SCOPE(PROF_AERO);
 	// The papers on Little Joe aerodynamics are strangely classified. The Little Joe II (Apollo) aerodynamics are luckily not, so we use them here.
 
 	// 19680013484 page 73, the pitching moment is approximately linear, with slope 0.16 * aoa(deg).
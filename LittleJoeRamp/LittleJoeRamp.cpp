@@ -10,6 +10,8 @@
 
 const double LC_MASS = 1e5; // guesstimate
 const double LC_COG = 2.33;
+const double PAD_ROCKET_MIN_MASS = 1e3; // kg. Must be large enough to fit to pad
+const int PAD_MAX_CANDIDATES = 10; // rockets near the pad that are checked every timestep
 const VECTOR3 ROCKET_POS = _V(0.0, LC_COG, 0.0);
 const VECTOR3 ROCKET_DIR = _V(0.0, 0.0, 1.0);
 const VECTOR3 PAD_OFFSET = _V(0, 0.0, 0.0);
@@ -60,6 +62,7 @@ public:
 	void SwitchCamera(int camera);
 	void AttachRocket(double simt, OBJHANDLE closestVessel, VESSEL* v);
 	void GetClosestVessel(OBJHANDLE* closestVessel, double* distance);
+	void RefreshPadCandidates(double simt);
 	VECTOR3 NormalXY(VECTOR3 vIn);
 	//void DefineAnimation(void);
 
@@ -82,6 +85,10 @@ private:
 	UINT LaunchPad;
 	MESHHANDLE launchPad;
 	ATTACHMENTHANDLE rocketAttach;
+	OBJHANDLE padCandidate[PAD_MAX_CANDIDATES]; // see LaunchComplexCommon.h
+	int padCandidateNum = 0;
+	DWORD padVesselCount = 0;
+	double padCandidateRefreshTime = -1e10;
 	UINT TowerMoveAway, TowerMoveIn;
 	int cameraMode = 0; // smlTwrDwn, lrgTwrDwn, lrgTwrFar, undrRckt, farAwy, farAwy2
 
@@ -96,6 +103,7 @@ private:
 };
 
 #include "..\FunctionsForOrbiter2010.h"
+#include "..\LaunchComplexCommon.h"
 
 ProjectMercury::ProjectMercury(OBJHANDLE hVessel, int flightmodel) : VESSELVER(hVessel, flightmodel)
 {
@@ -629,22 +637,6 @@ void ProjectMercury::AttachRocket(double simt, OBJHANDLE closestVessel, VESSEL*
 	}
 }
 
-void ProjectMercury::GetClosestVessel(OBJHANDLE* closestVessel, double* distance)
-{
-	VECTOR3 pos;
-	OBJHANDLE vesselI;
-	for (int i = 0; i < (int)oapiGetVesselCount(); i++)
-	{
-		vesselI = oapiGetVesselByIndex(i);
-		GetRelativePos(vesselI, pos);
-		if (vesselI != GetHandle() && length(pos) < *distance && oapiGetMass(vesselI) > 1e3) // must be large enough to fit to pad
-		{
-			*closestVessel = vesselI;
-			*distance = length(pos);
-		}
-	}
-}
-
 VECTOR3 ProjectMercury::NormalXY(VECTOR3 vIn)
 {
 	VECTOR3 vOut;
@@ -7,6 +7,7 @@
 #define VESSELVER VESSEL4
 
 #include "orbitersdk.h"
+#include "..\\..\\HudTextCache.h"
 
 const VECTOR3 OFS_AB = { 0.0, 0.0, -1.9 };
 const double THRUST_VAC_ESC = 231308.0; // Totalling 52000 lb (or 58500 lb), burn time 0.78
@@ -60,6 +61,7 @@ private:
 	bool jettisonAfterAbort = false;
 
 	int TextX0, secondColumnHUDx, LineSpacing, TextY0;
+	HudTextCache hudText; // only for VersionDependentPadHUD. Empty until used
 	
 	PROPELLANT_HANDLE main_tank = NULL;
 	THRUSTER_HANDLE main_engine = NULL;
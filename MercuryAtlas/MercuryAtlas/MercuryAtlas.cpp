@@ -20,10 +20,18 @@
 
 #include "orbitersdk.h"
 
+#include "..\..\DebrisManager.h"
+#include "..\..\HudTextCache.h"
+#include "..\..\MercurySettings.h"
+#include "..\..\TextureCache.h"
+#include "..\..\AsyncTextureLoader.h"
+#include "..\..\FlightRecorder.h"
+#include "..\..\FlightHistory.h"
+#include "..\..\MercuryLog.h"
+#include "..\..\MercuryProfiler.h"
 #include "MercuryAtlas.h"
 #include "..\..\FunctionsForOrbiter2016.h"
 #include "..\..\MercuryCapsule.h"
-#include <fstream> // debug, for appending entry data to file
 
 
 ProjectMercury::ProjectMercury(OBJHANDLE hVessel, int flightmodel)
@@ -650,10 +658,47 @@ void ProjectMercury::clbkPostCreation()
 		coreSeparated = true;
 		towerJettisoned = true;
 	}
+
+	// Load everything we may separate now, instead of at separation
+	PrewarmCapsuleSeparations();
+	if (!towerJettisoned)
+	{
+		debris.Prewarm("ProjectMercury\\Mercury_Abort");
+		debris.Prewarm("ProjectMercury\\Mercury_AbortNominal");
+	}
+	if (!boosterSeparated)
+		debris.Prewarm("ProjectMercury\\Mercury_atlas_booster");
+	if (!coreSeparated)
+	{
+		if (conceptManouverUnit)
+		{
+			debris.Prewarm("Vessels\\ProjectMercury\\Mercury_AtlasCoreConcept");
+			debris.Prewarm("ProjectMercury\\ConceptAdapter");
+			debris.Prewarm("ProjectMercury\\ConceptCover1");
+			debris.Prewarm("ProjectMercury\\ConceptCover2");
+		}
+		else
+		{
+			debris.Prewarm("Vessels\\ProjectMercury\\Mercury_AtlasCore");
+		}
+		debris.Prewarm("Vessels\\ProjectMercury\\Mercury_AtlasCoreB");
+	}
+	debris.Prewarm("ProjectMercury\\Mercury_AdaptCover1");
+	debris.Prewarm("ProjectMercury\\Mercury_AdaptCover2");
+	debris.Prewarm("ProjectMercury\\Mercury_AdaptCover3");
+	debris.Prewarm("ProjectMercury\\Mercury_AdaptRing1");
+	debris.Prewarm("ProjectMercury\\Mercury_AdaptRing2");
+	debris.Prewarm("ProjectMercury\\Mercury_AdaptRing3");
 }
 
 void ProjectMercury::clbkPreStep(double simt, double simdt, double mjd)
 {
+	PROFILE_FRAME(); // see MercuryProfiler.h
+	PROFILE_SCOPE(PROF_PRESTEP);
+	UpdateFlightState(simt); // read once, used by HUD, panel and retro calculations
+	textureQueue.Update(); // apply replacement textures that have been read
+	TextureCache::Global().ReleaseIdle(oapiGetSysTime()); // replacement textures no vessel has needed for a while
+
 	if (simt - launchTime > 2.0 && simdt > timeStepLimit && !rollProgram && autoPilot && (VesselStatus == LAUNCH || VesselStatus == LAUNCHCORE || VesselStatus == TOWERSEP || VesselStatus == LAUNCHCORETOWERSEP))
 	{
 		AimEulerAngle(eulerPitch, eulerYaw); // SetGlobalOrientation must be in prestep ?
@@ -672,66 +717,7 @@ void ProjectMercury::clbkPreStep(double simt, double simdt, double mjd)
 	}
 
 	// Actions
-	if (separateTowerAction)
-	{
-		TowerSeparation();
-		separateTowerAction = false;
-	}
-	else if (separateBoosterAction)
-	{
-		SeparateAtlasBooster(true);
-		separateBoosterAction = false;
-	}
-	else if (separateCapsuleAction)
-	{
-		CapsuleSeparate();
-		separateCapsuleAction = false;
-	}
-	else if (prepareReentryAction)
-	{
-		PrepareReentry();
-		prepareReentryAction = false;
-	}
-	else if (separateRetroCoverAction[0])
-	{
-		SeparateRetroCoverN(1);
-		separateRetroCoverAction[1 - 1] = false;
-	}
-	else if (separateRetroCoverAction[1])
-	{
-		SeparateRetroCoverN(2);
-		separateRetroCoverAction[2 - 1] = false;
-	}
-	else if (separateRetroCoverAction[2])
-	{
-		SeparateRetroCoverN(3);
-		separateRetroCoverAction[3 - 1] = false;
-	}
-	else if (separateDrogueCoverAction)
-	{
-		SeparateDrogueCover();
-		separateDrogueCoverAction = false;
-	}
-	else if (separateDrogueAction)
-	{
-		SeparateDrogue();
-		separateDrogueAction = false;
-	}
-	else if (separateMainChuteAction)
-	{
-		SeparateMainChute();
-		separateMainChuteAction = false;
-	}
-	else if (separateConceptAdapterAction)
-	{
-		SeparateConceptAdapter();
-		separateConceptAdapterAction = false;
-	}
-	else if (separateConceptCoverAction)
-	{
-		SeparateConceptCovers();
-		separateConceptCoverAction = false;
-	}
+	ProcessActionQueue(simt, simdt);
 
 	SetEmptyMass(EmptyMass()); // calculate drymass of current setting (launch, abort, flight ...)
 
@@ -904,13 +890,13 @@ void ProjectMercury::clbkPreStep(double simt, double simdt, double mjd)
 		}
 		else if (!mainChuteSeparated && GroundContact())
 		{
-			separateMainChuteAction = true;
+			QueueAction(ACTION_SEPARATEMAINCHUTE);
 			oapiWriteLog("sep main on contact");
 		}
 		else if (reserveChuteDeployed && !reserveChuteSeparated && GroundContact())
 		{
 			oapiWriteLog("Sep reserve on contact");
-			separateMainChuteAction = true;
+			QueueAction(ACTION_SEPARATEMAINCHUTE);
 		}
 
 		if (mainChuteDeployed)
@@ -1015,7 +1001,7 @@ void ProjectMercury::clbkPreStep(double simt, double simdt, double mjd)
 		break;
 	}
 
-	DeleteRogueVessels();
+	debris.Update(GetHandle());
 
 	if (periscope && PeriscopeStatus != P_DEPLOYED)
 	{
@@ -1051,6 +1037,7 @@ void ProjectMercury::clbkPreStep(double simt, double simdt, double mjd)
 
 void ProjectMercury::clbkPostStep(double simt, double simdt, double mjd)
 {
+	PROFILE_SCOPE(PROF_POSTSTEP);
 	if (VesselStatus == LAUNCH || VesselStatus == LAUNCHCORE || VesselStatus == LAUNCHCORETOWERSEP || VesselStatus == TOWERSEP)
 	{
 		if (!GroundContact())
@@ -1092,9 +1079,7 @@ void ProjectMercury::clbkPostStep(double simt, double simdt, double mjd)
 		if (currentSustainerLevel == 0.0 && previousSustainerLevel != 0.0)
 		{
 			// Ran dry, or general cutoff
-			char cbuf[256];
-			sprintf(cbuf, "Sustainer engine turned off T+%.1f", simt - launchTime); // debug
-			oapiWriteLog(cbuf);
+			MLOG_INFO("Sustainer engine turned off T+%.1f", simt - launchTime); // debug
 
 			historyCutOffAlt = GetAltitude();
 			VECTOR3 currentSpaceVelocity;
@@ -1191,10 +1176,10 @@ void ProjectMercury::clbkPostStep(double simt, double simdt, double mjd)
 		}
 		else if (VesselStatus == TOWERSEP || VesselStatus == LAUNCHCORETOWERSEP)
 		{
-			if (boosterShutdownTime != 0.0 && simt > boosterShutdownTime + 1.0 && vesselAcceleration < 0.25 * G) // capsule sep at 1 sec after cutoff (19620004691 page 34)
+			if (boosterShutdownTime != 0.0 && simt + simdt > boosterShutdownTime + 1.0 && vesselAcceleration < 0.25 * G) // capsule sep at 1 sec after cutoff (19620004691 page 34)
 			{
 				oapiWriteLog("Automatic capsule separate +1 second after shutdown");
-				separateCapsuleAction = true;
+				QueueActionAt(ACTION_SEPARATECAPSULE, boosterShutdownTime + 1.0);
 			}
 		}
 	}
@@ -1248,7 +1233,7 @@ void ProjectMercury::clbkPostStep(double simt, double simdt, double mjd)
 		if (conceptCoverAttached && GetThrusterLevel(conceptRetrograde[0]) != 0.0)
 		{
 			// If with tank, firing thruster, and has covers attached
-			separateConceptCoverAction = true;
+			QueueAction(ACTION_SEPARATECONCEPTCOVER);
 		}
 
 		conceptThrusterLevel[0] = GetThrusterLevel(conceptPosigrade[0]);
@@ -1291,6 +1276,11 @@ int ProjectMercury::clbkConsumeBufferedKey(DWORD key, bool down, char* kstate)
 				showInfoOnHud = 0;
 			}
 			return 1;
+#if MERCURY_PROFILE
+		case OAPI_KEY_Y: // profiler on HUD
+			PROFILE_TOGGLE_HUD();
+			return 1;
+#endif
 		case OAPI_KEY_R: // refresh dynamic meshes. A pity that this has to be done
 			if (VesselStatus == LAUNCH || VesselStatus == LAUNCHCORE || VesselStatus == LAUNCHCORETOWERSEP || VesselStatus == TOWERSEP) // Set Atlas mesh
 			{
@@ -1364,12 +1354,12 @@ int ProjectMercury::clbkConsumeBufferedKey(DWORD key, bool down, char* kstate)
 			}
 			else if (VesselStatus == TOWERSEP && GetThrusterGroupLevel(THGROUP_MAIN) != 0.0) // some engine must be running. This is basically a catch for Big Joe
 			{
-				separateBoosterAction = true;
+				QueueAction(ACTION_SEPARATEBOOSTER);
 				autoPilot = false;
 			}
 			else if (VesselStatus == LAUNCHCORETOWERSEP || (VesselStatus == TOWERSEP && GetThrusterGroupLevel(THGROUP_MAIN) == 0.0)) // or a catch for Big Joe
 			{
-				separateCapsuleAction = true;
+				QueueAction(ACTION_SEPARATECAPSULE);
 				//autoPilot = false;
 			}
 			else if (VesselStatus == ABORT)
@@ -1382,12 +1372,12 @@ int ProjectMercury::clbkConsumeBufferedKey(DWORD key, bool down, char* kstate)
 			else if (VesselStatus == FLIGHT && conceptManouverUnit && conceptManouverUnitAttached)
 			{
 				// Separate concept adapter
-				separateConceptAdapterAction = true;
+				QueueAction(ACTION_SEPARATECONCEPTADAPTER);
 			}
 			else if (VesselStatus == FLIGHT)
 			{
 				// Engage reentry-mode
-				prepareReentryAction = true;
+				QueueAction(ACTION_PREPAREREENTRY);
 			}
 			else if (VesselStatus == ABORTNORETRO) // If on-pad abort, where just tower and capsule eject
 			{
@@ -1404,7 +1394,7 @@ int ProjectMercury::clbkConsumeBufferedKey(DWORD key, bool down, char* kstate)
 			else if (VesselStatus == REENTRY && drogueDeployed)
 			{
 				autoPilot = false;
-				separateDrogueAction = true;
+				QueueAction(ACTION_SEPARATEDROGUE);
 			}
 			else if (VesselStatus == REENTRYNODROGUE && !mainChuteDeployed && !mainChuteSeparated)
 			{
@@ -1416,7 +1406,7 @@ int ProjectMercury::clbkConsumeBufferedKey(DWORD key, bool down, char* kstate)
 			}
 			else if (VesselStatus == REENTRYNODROGUE && mainChuteDeployed && !mainChuteSeparated)
 			{
-				separateMainChuteAction = true;
+				QueueAction(ACTION_SEPARATEMAINCHUTE);
 			}
 			else if (VesselStatus == REENTRYNODROGUE && mainChuteSeparated && !reserveChuteDeployed)
 			{
@@ -1545,15 +1535,15 @@ int ProjectMercury::clbkConsumeBufferedKey(DWORD key, bool down, char* kstate)
 		case OAPI_KEY_K:
 			if (VesselStatus == LAUNCH || VesselStatus == TOWERSEP) // TOWERSEP should never happen, but oh well ...
 			{
-				separateBoosterAction = true;
+				QueueAction(ACTION_SEPARATEBOOSTER);
 			}
 			else if (VesselStatus == LAUNCHCORE) // C++ should exit if first condition is false, omiting a crash for when th_main is deleted
 			{
-				separateTowerAction = true;
+				QueueAction(ACTION_SEPARATETOWER);
 			}
 			else if (VesselStatus == ABORT)
 			{
-				separateTowerAction = true;
+				QueueAction(ACTION_SEPARATETOWER);
 			}
 
 			return 1;
@@ -1681,6 +1671,7 @@ bool NumOrbitsInput(void* id, char* str, void* data)
 
 bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketchpad* skp)
 {
+	PROFILE_SCOPE(PROF_DRAWHUD);
 	char cbuf[256];
 	int yIndex = 0;
 	double simt = oapiGetSimTime();
@@ -1747,6 +1738,8 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		}
 	}
 
+	PROFILE_DRAW_HUD(skp, TextX0, int(ScreenHeight) - (PROF_NUM_SCOPES + 4) * LineSpacing, LineSpacing);
+
 	if (oapiCockpitMode() == COCKPIT_PANELS && panelView)
 	{
 		if (showInfoOnHud < 2)
@@ -1762,86 +1755,78 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 	if (showInfoOnHud == 0)
 	{
 		// ==== Buttons text ====
-		sprintf(cbuf, "Key commands:");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "Key commands:");
 		yIndex += 1;
 
 		// Button Ctrl+T
-		sprintf(cbuf, "Ctrl+T:Hide on-screen text");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "Ctrl+T:Hide on-screen text");
 		yIndex += 1;
 
 		// Button Ctrl+R
-		sprintf(cbuf, "Ctrl+R:Reload missing meshes");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "Ctrl+R:Reload missing meshes");
+		yIndex += 1;
+
+#if MERCURY_PROFILE
+		// Button Ctrl+Y
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "Ctrl+Y:Show profiler");
 		yIndex += 1;
+#endif
 
 
 		// Key J
 		if (VesselStatus == LAUNCH || VesselStatus == LAUNCHCORE)
 		{
-			sprintf(cbuf, "J:     ABORT");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     ABORT");
 			yIndex += 1;
 		}
 		else if (VesselStatus == TOWERSEP || VesselStatus == LAUNCHCORETOWERSEP)
 		{
-			sprintf(cbuf, "J:     Separate capsule");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate capsule");
 			yIndex += 1;
 		}
 		else if (VesselStatus == ABORT)
 		{
-			sprintf(cbuf, "J:     Separate escape tower");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate escape tower");
 			yIndex += 1;
 		}
 		else if (VesselStatus == FLIGHT)
 		{
-			sprintf(cbuf, "J:     Separate retropack");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate retropack");
 			yIndex += 1;
 		}
 		else if (VesselStatus == ABORTNORETRO)
 		{
-			sprintf(cbuf, "J:     Separate escape tower");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate escape tower");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRY && !drogueDeployed)
 		{
-			sprintf(cbuf, "J:     Deploy drogue chute");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Deploy drogue chute");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRY && drogueDeployed)
 		{
-			sprintf(cbuf, "J:     Separate drogue chute");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate drogue chute");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRYNODROGUE && !mainChuteDeployed && !mainChuteSeparated)
 		{
-			sprintf(cbuf, "J:     Deploy main chute");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Deploy main chute");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRYNODROGUE && !landingBagDeployed)
 		{
-			sprintf(cbuf, "J:     Deploy landing bag");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Deploy landing bag");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRYNODROGUE && mainChuteDeployed && !mainChuteSeparated)
 		{
-			sprintf(cbuf, "J:     Separate main chute");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate main chute");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRYNODROGUE && mainChuteSeparated && !reserveChuteDeployed)
 		{
-			sprintf(cbuf, "J:     Deploy reserve chute");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Deploy reserve chute");
 			yIndex += 1;
 		}
 
@@ -1850,37 +1835,32 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		{
 			if (spaceLaunch)
 			{
-				sprintf(cbuf, "SPACE: Engine off");
-				skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "SPACE: Engine off");
 				yIndex += 1;
 			}
 			else
 			{
-				sprintf(cbuf, "SPACE: Engine on");
-				skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "SPACE: Engine on");
 				yIndex += 1;
 			}
 		}
 		else if (VesselStatus == FLIGHT)
 		{
-			sprintf(cbuf, "SPACE: Fire retros");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "SPACE: Fire retros");
 			yIndex += 1;
 		}
 
 		// Key P
 		if (GroundContact() && VesselStatus == LAUNCH)
 		{
-			sprintf(cbuf, "P:     Automatic launch");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "P:     Automatic launch");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRYNODROGUE)
 		{
 			if (!engageFuelDump)
 			{
-				sprintf(cbuf, "P:     Fuel dump");
-				skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "P:     Fuel dump");
 				yIndex += 1;
 			}
 		}
@@ -1888,43 +1868,37 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		// Key K
 		if ((VesselStatus == LAUNCH || VesselStatus == TOWERSEP))
 		{
-			sprintf(cbuf, "K:     Separate booster stage");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "K:     Separate booster stage");
 			yIndex += 1;
 		}
 		else if (VesselStatus == LAUNCHCORE)
 		{
-			sprintf(cbuf, "K:     Separate escape tower");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "K:     Separate escape tower");
 			yIndex += 1;
 		}
 
 		// Key M
 		if (VesselStatus == LAUNCH || VesselStatus == LAUNCHCORE || VesselStatus == TOWERSEP || VesselStatus == LAUNCHCORETOWERSEP)
 		{
-			sprintf(cbuf, "M:     Disengage autopilot");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "M:     Disengage autopilot");
 			yIndex += 1;
 		}
 
 		// Key C
 		if (VesselStatus == LAUNCH && GroundContact() && GetAttachmentStatus(padAttach) == NULL)
 		{
-			sprintf(cbuf, "C:     Set focus on launch pad");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "C:     Set focus on launch pad");
 			yIndex += 1;
 		}
 		else if (periscope)
 		{
-			if (narrowField) sprintf(cbuf, "C:     Set periscope WIDE aperture");
-			else  sprintf(cbuf, "C:     Set periscope NARROW aperture");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			if (narrowField) hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "C:     Set periscope WIDE aperture");
+			else hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "C:     Set periscope NARROW aperture");
 			yIndex += 1;
 		}
 		else if (rocketCam)
 		{
-			sprintf(cbuf, "C:     Switch rocket camera view");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "C:     Switch rocket camera view");
 			yIndex += 1;
 		}
 
@@ -1936,30 +1910,26 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		}
 		else if (VesselStatus == LAUNCH || VesselStatus == LAUNCHCORE || VesselStatus == TOWERSEP || VesselStatus == LAUNCHCORETOWERSEP)
 		{
-			sprintf(cbuf, "B:     Set launch target");
-			skp->Text(TextX0, yIndex* LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex* LineSpacing + TextY0, "B:     Set launch target");
 			yIndex += 1;
 		}
 		else
 		{
-			sprintf(cbuf, "B:     Set landing target");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "B:     Set landing target");
 			yIndex += 1;
 		}
 
 		// Key V and B
 		if (periscope)
 		{
-			sprintf(cbuf, "B/V:   Set periscope altitude +/-");
-			skp->Text(TextX0, yIndex* LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex* LineSpacing + TextY0, "B/V:   Set periscope altitude +/-");
 			yIndex += 1;
 		}
 
 		// Key N
 		if (VesselStatus == LAUNCH)
 		{
-			sprintf(cbuf, "N:     Set mission number of orbits");
-			skp->Text(TextX0, yIndex* LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex* LineSpacing + TextY0, "N:     Set mission number of orbits");
 			yIndex += 1;
 		}
 
@@ -1996,30 +1966,28 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		int metM = (int)floor((metAbs - metH * 3600.0) / 60.0);
 		int metS = (int)floor((metAbs - metH * 3600.0 - metM * 60.0));
 
-		sprintf(cbuf, "T%s%02i %02i %02i", signChar, metH, metM, metS);
-		skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "T%s%02i %02i %02i", signChar, metH, metM, metS);
 		yIndex += 1;
 
 		// ==== Autopilot status ====
 		if (autoPilot && VesselStatus != REENTRYNODROGUE)
 		{
-			sprintf(cbuf, "Autopilot: ON");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Autopilot: ON");
 			yIndex += 1;
 		}
 		else if (!autoPilot && VesselStatus != REENTRYNODROGUE)
 		{
-			sprintf(cbuf, "Autopilot: OFF");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Autopilot: OFF");
 			yIndex += 1;
 		}
 
 		if (VesselStatus == FLIGHT)
 		{
-			sprintf(cbuf, "Orbit number %i", orbitCount);
-			skp->Text(secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, "Orbit number %i", orbitCount);
 			yIndex += 1;
 
+			WriteHUDRadioPasses(skp, simt, &yIndex, cbuf);
+
 			if (landingComputing)
 			{
 				// New method for retrosequence time
@@ -2032,11 +2000,9 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 				double landingLong, landingLat;
 
 				// Current state:
-				ELEMENTS el;
-				ORBITPARAM prm;
-				GetElements(GetSurfaceRef(), el, &prm, oapiGetSimMJD(), FRAME_EQU);
-				double longAtNow, latAtNow, radAtNow;
-				GetEquPos(longAtNow, latAtNow, radAtNow);
+				ELEMENTS el = flightState.el;
+				ORBITPARAM prm = flightState.prm;
+				double longAtNow = flightState.longitude;
 
 				while (time < 5500.0 && !closeSolution && (!engageRetro || simt < retroStartTime))
 				{
@@ -2108,27 +2074,23 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 					}
 				}
 
-				sprintf(cbuf, "Retrosequence:");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Retrosequence:");
 				yIndex += 1;
 
 				if (noMissionLandLat)
 				{
-					sprintf(cbuf, "  Long: %.2f\u00B0", missionLandLong);
-					skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+					hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  Long: %.2f\u00B0", missionLandLong);
 					yIndex += 1;
 				}
 				else
 				{
-					sprintf(cbuf, "  Lat: %.2f\u00B0, long: %.2f\u00B0", missionLandLat, missionLandLong);
-					skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+					hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  Lat: %.2f\u00B0, long: %.2f\u00B0", missionLandLat, missionLandLong);
 					yIndex += 1;
 				}
 
 				if (FailureMode == RETROCALCOFF && simt - launchTime > timeOfError)
 				{
-					sprintf(cbuf, "  ERROR ERROR ERROR");
-					skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+					hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  ERROR ERROR ERROR");
 					yIndex += 1;
 				}
 				else if (minAngDistTime != 0.0)
@@ -2138,14 +2100,12 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 					int ret3H = (int)floor(metRetroTime / 3600.0);
 					int ret3M = (int)floor((metRetroTime - ret3H * 3600.0) / 60.0);
 					int ret3S = (int)floor((metRetroTime - ret3H * 3600.0 - ret3M * 60.0));
-					sprintf(cbuf, "  %02i %02i %02i (%.0f km)", ret3H, ret3M, ret3S, minAngDist * oapiGetSize(GetSurfaceRef()) / 1e3);
-					skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+					hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  %02i %02i %02i (%.0f km)", ret3H, ret3M, ret3S, minAngDist * flightState.refSize / 1e3);
 					yIndex += 1;
 				}
 				else
 				{
-					sprintf(cbuf, "  NO SOLUTION FOUND");
-					skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+					hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  NO SOLUTION FOUND");
 					yIndex += 1;
 				}
 			}
@@ -2163,27 +2123,23 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 				}
 			}
 
-			sprintf(cbuf, "Next retrosequence time:");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Next retrosequence time:");
 			yIndex += 1;
 
 			int retH = (int)floor(retroseqTime / 3600.0);
 			int retM = (int)floor((retroseqTime - retH * 3600.0) / 60.0);
 			int retS = (int)floor((retroseqTime - retH * 3600.0 - retM * 60.0));
 
-			sprintf(cbuf, "  %02i %02i %02i (%s)", retH, retM, retS, retroseqName);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  %02i %02i %02i (%s)", retH, retM, retS, retroseqName);
 			yIndex += 1;
 		}
 
 		if ((VesselStatus == FLIGHT || VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE) && fuel_manual != NULL) // there's a pesky crash if one checks for propellant level of a non-created propellant source
 		{
-			sprintf(cbuf, "Manual fuel: %.1f %%", GetPropellantMass(fuel_manual) / MERCURY_FUEL_MASS_MAN * 100.0);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Manual fuel: %.1f %%", flightState.fuelManual / MERCURY_FUEL_MASS_MAN * 100.0);
 			yIndex += 1;
 
-			sprintf(cbuf, "Auto fuel: %.1f %%", GetPropellantMass(fuel_auto) / MERCURY_FUEL_MASS_AUTO * 100.0);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Auto fuel: %.1f %%", flightState.fuelAuto / MERCURY_FUEL_MASS_AUTO * 100.0);
 			yIndex += 1;
 		}
 
@@ -2192,19 +2148,16 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		{
 			if (AutopilotStatus == AUTOLAUNCH)
 			{
-				sprintf(cbuf, "Awaiting cutoff");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Awaiting cutoff");
 				yIndex += 1;
 
-				sprintf(cbuf, "  remaining impulse: %.1f m/s", integratedSpeedLimit - integratedSpeed);
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  remaining impulse: %.1f m/s", integratedSpeedLimit - integratedSpeed);
 				yIndex += 1;
 			}
 		}
 		else if (autoPilot && VesselStatus == LAUNCHCORETOWERSEP)
 		{
-			sprintf(cbuf, "Separate capsule in %.2f s", 1.0 + boosterShutdownTime - simt);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Separate capsule in %.2f s", 1.0 + boosterShutdownTime - simt);
 			yIndex += 1;
 		}
 		else
@@ -2214,11 +2167,10 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 
 		if (VesselStatus == LAUNCH || VesselStatus == LAUNCHCORE || VesselStatus == LAUNCHCORETOWERSEP || VesselStatus == TOWERSEP)
 		{
-			VECTOR3 angVel;
-			GetAngularVel(angVel);
+			VECTOR3 angVel = flightState.angVel;
 
-			double planetRad = oapiGetSize(GetSurfaceRef());
-			double targetOrbitalVelocity = sqrt(GGRAV * oapiGetMass(GetSurfaceRef()) * (2.0 / (missionPerigee * 1000.0 + planetRad) - 2.0 / (missionApogee * 1000.0 + planetRad + missionPerigee * 1000.0 + planetRad))); // switch from currentRadius to missionPerigee
+			double planetRad = flightState.refSize;
+			double targetOrbitalVelocity = sqrt(GGRAV * flightState.refMass * (2.0 / (missionPerigee * 1000.0 + planetRad) - 2.0 / (missionApogee * 1000.0 + planetRad + missionPerigee * 1000.0 + planetRad))); // switch from currentRadius to missionPerigee
 			double cutoffAlt = missionPerigee * 1000.0;
 			if (missileMission)
 			{
@@ -2227,45 +2179,35 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 			}
 			double targetPitchRate = AtlasPitchControl(cutoffAlt, targetOrbitalVelocity);
 			if (VesselStatus == LAUNCHCORETOWERSEP)
-				sprintf(cbuf, "Pitch rate: %.2f\u00B0/s (targ.: %.2f\u00B0/s)", angVel.x * DEG, targetPitchRate * DEG);
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Pitch rate: %.2f\u00B0/s (targ.: %.2f\u00B0/s)", angVel.x * DEG, targetPitchRate * DEG);
 			else
-				sprintf(cbuf, "Pitch rate: %.2f\u00B0/s", angVel.x * DEG);
-
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Pitch rate: %.2f\u00B0/s", angVel.x * DEG);
 			yIndex += 1;
 
-			sprintf(cbuf, "Yaw rate: %.2f\u00B0/s", angVel.y * DEG);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Yaw rate: %.2f\u00B0/s", angVel.y * DEG);
 			yIndex += 1;
 
-			sprintf(cbuf, "Roll rate: %.2f\u00B0/s", angVel.z* DEG);
-			skp->Text(secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, "Roll rate: %.2f\u00B0/s", angVel.z* DEG);
 			yIndex += 1;
 
-			double longi, lati, radi;
-			GetEquPos(longi, lati, radi);
-			radi = oapiGetSize(GetSurfaceRef());
+			double longi = flightState.longitude, lati = flightState.latitude, radi = flightState.refSize;
 			if (launchTargetPosition)
 			{
-				sprintf(cbuf, "Lat: %.2f\u00B0, long: %.2f\u00B0 (%i)", missionLandLat, missionLandLong, missionOrbitNumber);
-				skp->Text(secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, "Lat: %.2f\u00B0, long: %.2f\u00B0 (%i)", missionLandLat, missionLandLong, missionOrbitNumber);
 				yIndex += 1;
 
-				sprintf(cbuf, "Target heading: %.1f\u00B0", AtlasTargetCutOffAzimuth(simt, radi + missionPerigee * 1e3, longi * DEG, lati * DEG, false));
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Target heading: %.1f\u00B0", AtlasTargetCutOffAzimuth(simt, radi + missionPerigee * 1e3, longi * DEG, lati * DEG, false));
 				yIndex += 1;
 			}
 			else
 			{
-				sprintf(cbuf, "Inc: %.2f\u00B0", targetInclination);
-				skp->Text(secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, "Inc: %.2f\u00B0", targetInclination);
 				yIndex += 1;
 
 				double targetAzimuth = asin(cos(targetInclination * RAD) / cos(lati)) * DEG;
 				if (targetInclination < 0.0)
 					targetAzimuth = 180.0 - targetAzimuth;
-				sprintf(cbuf, "Target heading: %.1f\u00B0", targetAzimuth);
-				skp->Text(secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, "Target heading: %.1f\u00B0", targetAzimuth);
 				yIndex += 1;
 			}
 		}
@@ -2273,23 +2215,20 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		// Chute status
 		if (VesselStatus == REENTRY && drogueDeployed)
 		{
-			sprintf(cbuf, "Drogue chute deployed");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Drogue chute deployed");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRYNODROGUE)
 		{
 			if (mainChuteDeployed)
 			{
-				sprintf(cbuf, "Main chute deploy (%.2f)", GetAnimation(MainChuteDeployAnim));
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Main chute deploy (%.2f)", GetAnimation(MainChuteDeployAnim));
 				yIndex += 1;
 			}
 
 			if (landingBagDeployed)
 			{
-				sprintf(cbuf, "Landing bag deploy (%.2f)", GetAnimation(LandingBagDeployAnim));
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Landing bag deploy (%.2f)", GetAnimation(LandingBagDeployAnim));
 				yIndex += 1;
 			}
 		}
@@ -2298,63 +2237,54 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		{
 			if (switchASCSMode == -1 && switchControlMode == -1)
 			{
-				sprintf(cbuf, "ASCS auto attitude");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "ASCS auto attitude");
 				yIndex += 1;
 			}
 
 			if (switchASCSMode == 0 && switchControlMode == -1)
 			{
-				sprintf(cbuf, "AUX damp");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "AUX damp");
 				yIndex += 1;
 			}
 
 			if (switchASCSMode == 1)
 			{
-				sprintf(cbuf, "Fly By Wire");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Fly By Wire");
 				yIndex += 1;
 			}
 
 			if (!tHandlePitchPushed)
 			{
-				sprintf(cbuf, "  Auto pitch thrusters OFF");
-				skp->Text(secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, "  Auto pitch thrusters OFF");
 				yIndex += 1;
 			}
 			if (!tHandleYawPushed)
 			{
-				sprintf(cbuf, "  Auto yaw thrusters OFF");
-				skp->Text(secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, "  Auto yaw thrusters OFF");
 				yIndex += 1;
 			}
 
 			if (!tHandleRollPushed)
 			{
-				sprintf(cbuf, "  Auto roll thrusters OFF");
-				skp->Text(secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, "  Auto roll thrusters OFF");
 				yIndex += 1;
 			}
 
 			if (!tHandleManualPushed)
 			{
-				sprintf(cbuf, "Manual direct");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Manual direct");
 				yIndex += 1;
 			}
 
 			if (tHandleManualPushed && switchControlMode == 1)
 			{
-				sprintf(cbuf, "Rate command (RSCS)");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Rate command (RSCS)");
 				yIndex += 1;
 			}
 
 			if (engageFuelDump)
 			{
-				sprintf(cbuf, "Dumping attitude fuel");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Dumping attitude fuel");
 				yIndex += 1;
 			}
 		}
@@ -2372,173 +2302,193 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 
 void ProjectMercury::clbkLoadStateEx(FILEHANDLE scn, void* status)
 {
-	int i = 0;
-	char* cbuf;
+	LoadScenarioKeys(scn, status); // see ScenarioKeys
+}
 
-	while (oapiReadScenario_nextline(scn, cbuf))
-	{
-		if (!_strnicmp(cbuf, "STATE", 5))
-		{
-			sscanf_s(cbuf + 5, "%i", &VesselStatus);
-		}
-		else if (!_strnicmp(cbuf, "CAPSULE", 7))
-		{
-			LoadCapsule(cbuf + 8); // don't send space after "CAPSULE "
-		}
-		else if (!_strnicmp(cbuf, "AUTOMODE", 8))
-		{
-			sscanf_s(cbuf + 8, "%i", &AutopilotStatus);
-			autoPilot = true;
-		}
-		else if (!_strnicmp(cbuf, "SUBORBITAL", 10))
-		{
-			int readToBool;
-			sscanf_s(cbuf + 10, "%i", &readToBool);
-			suborbitalMission = (bool)readToBool;
-		}
-		else if (!_strnicmp(cbuf, "ABORTBUS", 8))
-		{
-			int readToBool;
-			sscanf_s(cbuf + 8, "%i", &readToBool);
-			enableAbortConditions = (bool)readToBool;
-		}
-		else if (!_strnicmp(cbuf, "HIGHROLLLIMIT", 13)) // for launching towards high latitudes, so that we need to roll faster
-		{
-			rollLimit = 10.0;
-		}
-		else if (!_strnicmp(cbuf, "HOLDTIME", 8))
-		{
-			sscanf_s(cbuf + 8, "%lf", &holdDownTime);
-			char oLog[50];
-			sprintf(oLog, "Atlas hold-down time set to %.1f seconds.", holdDownTime);
-			oapiWriteLog(oLog);
-		}
-		else if (!_strnicmp(cbuf, "BECOTIME", 8))
-		{
-			sscanf_s(cbuf + 8, "%lf", &becoTime);
-			char oLog[50];
-			sprintf(oLog, "BECO time set to T+%.1f seconds.", becoTime);
-			oapiWriteLog(oLog);
-		}
-		else if (!_strnicmp(cbuf, "MET", 3))
-		{
-			int metTime;
-			sscanf_s(cbuf + 3, "%i", &metTime);
-			launchTime = oapiGetSimTime() - (double)metTime;
-		}
-		else if (!_strnicmp(cbuf, "ORBITNR", 7)) // maybe obsolete. will have to figure out later (depending on next retrosequence calculation)
-		{
-			sscanf_s(cbuf + 7, "%i", &orbitCount);
-		}
-		else if (!_strnicmp(cbuf, "INCLINATION", 11))
-		{
-			sscanf_s(cbuf + 11, "%lf", &targetInclination);
-			launchTargetPosition = false;
-		}
-		else if (!_strnicmp(cbuf, "APOGEE", 6))
-		{
-			sscanf_s(cbuf + 6, "%lf", &missionApogee);
-			limitApogee = true;
-		}
-		else if (!_strnicmp(cbuf, "PERIGEE", 7))
-		{
-			sscanf_s(cbuf + 7, "%lf", &missionPerigee);
-		}
-		else if (!_strnicmp(cbuf, "MISSIONORBITNR", 14))
-		{
-			sscanf_s(cbuf + 14, "%i", &missionOrbitNumber);
-		}
-		else if (!_strnicmp(cbuf, "MISSIONLANDLAT", 14))
-		{
-			sscanf_s(cbuf + 14, "%lf", &missionLandLat);
-		}
-		else if (!_strnicmp(cbuf, "MISSIONLANDLONG", 15))
-		{
-			double userInput;
-			sscanf_s(cbuf + 15, "%lf", &userInput);
-			missionLandLong = fmod(userInput, 360.0); // range 0 to 360 deg
+// Scenario keywords, in the order they are saved. See LoadScenarioKeys in MercuryCapsule.h
+const SCENARIOKEY* ProjectMercury::ScenarioKeys(int* numKeys)
+{
+	static const SCENARIOKEY keys[] = {
+		ScenarioSpecial("STATE", SCN_STATE, true),
+		ScenarioSpecial("CAPSULE", SCN_CAPSULE, true),
+		ScenarioSpecial("AUTOMODE", SCN_AUTOMODE, true),
+		ScenarioBool("SUBORBITAL", &ProjectMercury::suborbitalMission, true),
+		ScenarioBool("ABORTBUS", &ProjectMercury::enableAbortConditions, true),
+		ScenarioSpecial("MET", SCN_MET, true),
+		ScenarioSpecial("ORBITNR", SCN_ORBITNR, true), // maybe obsolete. will have to figure out later (depending on next retrosequence calculation)
+		ScenarioSpecial("FAILURE", SCN_FAILURE, true),
+		ScenarioFlag("HARDMODE", &ProjectMercury::difficultyHard, true),
+		ScenarioInt("SWITCHAUTRETJET", &ProjectMercury::switchAutoRetroJet, true),
+		ScenarioInt("SWITCHRETRODELA", &ProjectMercury::switchRetroDelay, true),
+		ScenarioInt("SWITCHRETROATTI", &ProjectMercury::switchRetroAttitude, true),
+		ScenarioInt("SWITCHASCSMODE", &ProjectMercury::switchASCSMode, true),
+		ScenarioInt("SWITCHCONTRMODE", &ProjectMercury::switchControlMode, true),
+		ScenarioBool("THANDLEMANUAL", &ProjectMercury::tHandleManualPushed, true),
+		ScenarioBool("THANDLEPITCH", &ProjectMercury::tHandlePitchPushed, true),
+		ScenarioBool("THANDLEYAW", &ProjectMercury::tHandleYawPushed, true),
+		ScenarioBool("THANDLEROLL", &ProjectMercury::tHandleRollPushed, true),
+		ScenarioSpecial("REPLACETEXTURE", SCN_REPLACETEXTURE, true),
+		ScenarioSpecial("CONCEPTATTACHED", SCN_CONCEPTATTACHED, true),
+		ScenarioSpecial("CONCEPTCOVER", SCN_CONCEPTCOVER, true),
+		ScenarioSpecial("CHECKPOINT", SCN_CHECKPOINT, true), // binary file with the internal state, see CheckpointFields
+		// Only read
+		ScenarioSpecial("HIGHROLLLIMIT", SCN_HIGHROLLLIMIT, false), // for launching towards high latitudes, so that we need to roll faster
+		ScenarioSpecial("HOLDTIME", SCN_HOLDTIME, false),
+		ScenarioSpecial("BECOTIME", SCN_BECOTIME, false),
+		ScenarioSpecial("INCLINATION", SCN_INCLINATION, false),
+		ScenarioSpecial("APOGEE", SCN_APOGEE, false),
+		ScenarioDouble("PERIGEE", &ProjectMercury::missionPerigee, false),
+		ScenarioInt("MISSIONORBITNR", &ProjectMercury::missionOrbitNumber, false),
+		ScenarioDouble("MISSIONLANDLAT", &ProjectMercury::missionLandLat, false),
+		ScenarioSpecial("MISSIONLANDLONG", SCN_MISSIONLANDLONG, false),
+		ScenarioSpecial("MISSILESPEED", SCN_MISSILESPEED, false),
+		ScenarioDouble("MISSILEANGLE", &ProjectMercury::missileCutoffAngle, false),
+		ScenarioDouble("MISSILEALTITUDE", &ProjectMercury::missileCutoffAltitude, false),
+	};
 
-			launchTargetPosition = true; // we (probably) have all input data to initiate a target position launch
-		}
-		else if (!_strnicmp(cbuf, "FAILURE", 7)) // input -1 for random failure (or possibly none if HARDMODE is not defined)
-		{
-			int inputFailure;
-			sscanf_s(cbuf + 7, "%i", &inputFailure);
-			if (inputFailure == -1)
-			{
-				inputFailure = rand() % ((int)LASTENTRY - 1) + 1; // this should return a "random" integer between 1 and 12 (or the number of total modes in FailureMode enum)
-			}
+	*numKeys = sizeof(keys) / sizeof(keys[0]);
+	return keys;
+}
 
-			FailureMode = (failure)inputFailure;
-			// Actual failure determination is done in clbkPostCreation, as we then have result from HARDMODE
-		}
-		else if (!_strnicmp(cbuf, "HARDMODE", 8))
-		{
-			difficultyHard = true;
-		}
-		else if (!_strnicmp(cbuf, "MISSILESPEED", 12))
-		{
-			missileMission = true;
-			sscanf_s(cbuf + 12, "%lf", &missileCutoffVelocity);
-		}
-		else if (!_strnicmp(cbuf, "MISSILEANGLE", 12))
-		{
-			sscanf_s(cbuf + 12, "%lf", &missileCutoffAngle);
-		}
-		else if (!_strnicmp(cbuf, "MISSILEALTITUDE", 15))
-		{
-			sscanf_s(cbuf + 15, "%lf", &missileCutoffAltitude);
-		}
-		else if (!_strnicmp(cbuf, "REPLACETEXTURE", 14))
-		{
-			scenarioTextureUserEnable = true; // Load textures
-			ReadCapsuleTextureReplacement(cbuf + 15); // don't send space char after REPLACETEXTURE
-		}
-		else if (!_strnicmp(cbuf, "CONCEPTATTACHED", 15))
-		{
-			conceptManouverUnitAttached = bool(atoi(cbuf + 15)); // 0 is false, anything else true
-		}
-		else if (!_strnicmp(cbuf, "CONCEPTCOVER", 12))
-		{
-			conceptCoverAttached = bool(atoi(cbuf + 12)); // 0 is false, anything else true
-		}
-		else if (!_strnicmp(cbuf, "SWITCHAUTRETJET", 15))
-		{
-			switchAutoRetroJet = atoi(cbuf + 15);
-		}
-		else if (!_strnicmp(cbuf, "SWITCHRETRODELA", 15))
-		{
-			switchRetroDelay = atoi(cbuf + 15);
-		}
-		else if (!_strnicmp(cbuf, "SWITCHRETROATTI", 15))
-		{
-			switchRetroAttitude = atoi(cbuf + 15);
-		}
-		else if (!_strnicmp(cbuf, "SWITCHASCSMODE", 14))
-		{
-			switchASCSMode = atoi(cbuf + 14);
-		}
-		else if (!_strnicmp(cbuf, "SWITCHCONTRMODE", 15))
-		{
-			switchControlMode = atoi(cbuf + 15);
-		}
-		else if (!_strnicmp(cbuf, "THANDLEMANUAL", 13))
-		{
-			tHandleManualPushed = bool(atoi(cbuf + 13));
-		}
-		else if (!_strnicmp(cbuf, "THANDLEPITCH", 12))
-		{
-			tHandlePitchPushed = bool(atoi(cbuf + 12));
-		}
-		else if (!_strnicmp(cbuf, "THANDLEYAW", 10))
-		{
-			tHandleYawPushed = bool(atoi(cbuf + 10));
-		}
-		else if (!_strnicmp(cbuf, "THANDLEROLL", 11))
-		{
-			tHandleRollPushed = bool(atoi(cbuf + 11));
-		}
-		else ParseScenarioLineEx(cbuf, status);
+// Internal state saved in the binary checkpoint, see SaveCheckpoint in MercuryCapsule.h.
+// Changing this list makes old checkpoints unreadable (they are then ignored).
+const SCENARIOKEY* ProjectMercury::CheckpointFields(int* numFields)
+{
+	static const SCENARIOKEY fields[] = {
+		// Flight history
+		ScenarioDouble("historyMaxAltitude", &ProjectMercury::historyMaxAltitude, true),
+		ScenarioDouble("historyPerigee", &ProjectMercury::historyPerigee, true),
+		ScenarioDouble("historyBottomPrev", &ProjectMercury::historyBottomPrev, true),
+		ScenarioDouble("historyBottomPrevPrev", &ProjectMercury::historyBottomPrevPrev, true),
+		ScenarioDouble("historyInclination", &ProjectMercury::historyInclination, true),
+		ScenarioDouble("historyCutOffAlt", &ProjectMercury::historyCutOffAlt, true),
+		ScenarioDouble("historyCutOffVel", &ProjectMercury::historyCutOffVel, true),
+		ScenarioDouble("historyCutOffAngl", &ProjectMercury::historyCutOffAngl, true),
+		ScenarioDouble("historyCutOffLat", &ProjectMercury::historyCutOffLat, true),
+		ScenarioDouble("historyCutOffLong", &ProjectMercury::historyCutOffLong, true),
+		ScenarioDouble("historyMaxEarthSpeed", &ProjectMercury::historyMaxEarthSpeed, true),
+		ScenarioDouble("historyMaxSpaceSpeed", &ProjectMercury::historyMaxSpaceSpeed, true),
+		ScenarioDouble("historyMaxLaunchAcc", &ProjectMercury::historyMaxLaunchAcc, true),
+		ScenarioDouble("historyMaxReentryAcc", &ProjectMercury::historyMaxReentryAcc, true),
+		ScenarioDouble("historyLaunchLat", &ProjectMercury::historyLaunchLat, true),
+		ScenarioDouble("historyLaunchLong", &ProjectMercury::historyLaunchLong, true),
+		ScenarioDouble("historyLandLat", &ProjectMercury::historyLandLat, true),
+		ScenarioDouble("historyLandLong", &ProjectMercury::historyLandLong, true),
+		ScenarioDouble("historyLaunchHeading", &ProjectMercury::historyLaunchHeading, true),
+		ScenarioDouble("historyWeightlessTime", &ProjectMercury::historyWeightlessTime, true),
+		ScenarioDouble("maxVesselAcceleration", &ProjectMercury::maxVesselAcceleration, true),
+		ScenarioDouble("minVesselAcceleration", &ProjectMercury::minVesselAcceleration, true),
+		// Event times
+		ScenarioSimTime("launchTime", &ProjectMercury::launchTime, true),
+		ScenarioSimTime("boosterShutdownTime", &ProjectMercury::boosterShutdownTime, true),
+		ScenarioSimTime("retroStartTime", &ProjectMercury::retroStartTime, true),
+		ScenarioSimTime("abortTime", &ProjectMercury::abortTime, true),
+		ScenarioSimTime("towerJetTime", &ProjectMercury::towerJetTime, true),
+		ScenarioSimTime("posigradeDampingTime", &ProjectMercury::posigradeDampingTime, true),
+		ScenarioSimTime("drogueDeployTime", &ProjectMercury::drogueDeployTime, true),
+		ScenarioSimTime("drogueReefedTime", &ProjectMercury::drogueReefedTime, true),
+		ScenarioSimTime("mainChuteDeployTime", &ProjectMercury::mainChuteDeployTime, true),
+		ScenarioSimTime("mainChuteReefedTime", &ProjectMercury::mainChuteReefedTime, true),
+		// Autopilot and attitude
+		ScenarioDouble("integratedSpeed", &ProjectMercury::integratedSpeed, true),
+		ScenarioDouble("integratedPitch", &ProjectMercury::integratedPitch, true),
+		ScenarioDouble("integratedYaw", &ProjectMercury::integratedYaw, true),
+		ScenarioDouble("integratedRoll", &ProjectMercury::integratedRoll, true),
+		ScenarioDouble("currentPitchAim", &ProjectMercury::currentPitchAim, true),
+		ScenarioDouble("currentYawAim", &ProjectMercury::currentYawAim, true),
+		ScenarioDouble("currentRollAim", &ProjectMercury::currentRollAim, true),
+		ScenarioDouble("eulerPitch", &ProjectMercury::eulerPitch, true),
+		ScenarioDouble("eulerYaw", &ProjectMercury::eulerYaw, true),
+		ScenarioDouble("escapeLevel", &ProjectMercury::escapeLevel, true),
+		ScenarioDouble("previousFrameLatitude", &ProjectMercury::previousFrameLatitude, true),
+		ScenarioDouble("oldAngle", &ProjectMercury::oldAngle, true),
+		// Retro and reentry solution
+		ScenarioDouble("lowGLat", &ProjectMercury::lowGLat, true),
+		ScenarioDouble("lowGLong", &ProjectMercury::lowGLong, true),
+		ScenarioDouble("lowGHeading", &ProjectMercury::lowGHeading, true),
+		ScenarioDouble("entryAng", &ProjectMercury::entryAng, true),
+		ScenarioDouble("entryAngleToBase", &ProjectMercury::entryAngleToBase, true),
+		// Sequencing
+		ScenarioBool("engageRetro", &ProjectMercury::engageRetro, true),
+		ScenarioBool("posigradeDampingActivated", &ProjectMercury::posigradeDampingActivated, true),
+		ScenarioBool("turnAroundFinished", &ProjectMercury::turnAroundFinished, true),
+		ScenarioBool("rollProgram", &ProjectMercury::rollProgram, true),
+		ScenarioBool("pitchProgram", &ProjectMercury::pitchProgram, true),
+		ScenarioBool("passedBase", &ProjectMercury::passedBase, true),
+		// Orbit
+		ScenarioInt("orbitCount", &ProjectMercury::orbitCount, true),
+	};
+
+	*numFields = sizeof(fields) / sizeof(fields[0]);
+	return fields;
+}
+
+void ProjectMercury::LoadScenarioSpecial(int special, const char* value)
+{
+	switch (special)
+	{
+	case SCN_AUTOMODE:
+		LoadScenarioCommon(special, value);
+		autoPilot = true;
+		break;
+	case SCN_ORBITNR:
+		orbitCount = atoi(value);
+		break;
+	case SCN_HIGHROLLLIMIT:
+		rollLimit = 10.0;
+		break;
+	case SCN_HOLDTIME:
+		holdDownTime = atof(value);
+		oapiWriteLogV("Atlas hold-down time set to %.1f seconds.", holdDownTime);
+		break;
+	case SCN_BECOTIME:
+		becoTime = atof(value);
+		oapiWriteLogV("BECO time set to T+%.1f seconds.", becoTime);
+		break;
+	case SCN_INCLINATION:
+		targetInclination = atof(value);
+		launchTargetPosition = false;
+		break;
+	case SCN_APOGEE:
+		missionApogee = atof(value);
+		limitApogee = true;
+		break;
+	case SCN_MISSIONLANDLONG:
+		missionLandLong = fmod(atof(value), 360.0); // range 0 to 360 deg
+		launchTargetPosition = true; // we (probably) have all input data to initiate a target position launch
+		break;
+	case SCN_MISSILESPEED:
+		missileMission = true;
+		missileCutoffVelocity = atof(value);
+		break;
+	case SCN_CONCEPTATTACHED:
+		conceptManouverUnitAttached = (atoi(value) != 0); // 0 is false, anything else true
+		break;
+	case SCN_CONCEPTCOVER:
+		conceptCoverAttached = (atoi(value) != 0); // 0 is false, anything else true
+		break;
+	default:
+		LoadScenarioCommon(special, value);
+		break;
+	}
+}
+
+void ProjectMercury::SaveScenarioSpecial(FILEHANDLE scn, int special, const char* key)
+{
+	switch (special)
+	{
+	case SCN_ORBITNR:
+		if (VesselStatus == FLIGHT) oapiWriteScenario_int(scn, (char*)key, orbitCount);
+		break;
+	case SCN_CONCEPTATTACHED:
+		if (conceptManouverUnit) oapiWriteScenario_int(scn, (char*)key, conceptManouverUnitAttached);
+		break;
+	case SCN_CONCEPTCOVER:
+		if (conceptManouverUnit && !conceptCoverAttached) oapiWriteScenario_int(scn, (char*)key, conceptCoverAttached);
+		break;
+	default:
+		SaveScenarioCommon(scn, special, key);
+		break;
 	}
 }
 
@@ -2666,54 +2616,7 @@ void ProjectMercury::clbkSaveState(FILEHANDLE scn)
 {
 	VESSELVER::clbkSaveState(scn); // write default parameters (orbital elements etc.)
 
-	oapiWriteScenario_int(scn, "STATE", VesselStatus);
-
-	if (configTextureUserEnable) oapiWriteScenario_string(scn, "CAPSULE", configTextureUserName[configTextureUserNum]);
-	else oapiWriteScenario_int(scn, "CAPSULE", CapsuleVersion);
-
-	oapiWriteScenario_int(scn, "AUTOMODE", AutopilotStatus);
-
-	oapiWriteScenario_int(scn, "SUBORBITAL", suborbitalMission);
-
-	oapiWriteScenario_int(scn, "ABORTBUS", enableAbortConditions);
-
-	if (launchTime != 0.0) // if we have launched using autopilot
-	{
-		oapiWriteScenario_int(scn, "MET", int(oapiGetSimTime() - launchTime));
-	}
-
-	if (VesselStatus == FLIGHT)
-	{
-		oapiWriteScenario_int(scn, "ORBITNR", orbitCount);
-	}
-
-	oapiWriteScenario_int(scn, "FAILURE", FailureMode);
-
-	if (difficultyHard)
-	{
-		oapiWriteScenario_string(scn, "HARDMODE", "");
-	}
-
-	oapiWriteScenario_int(scn, "SWITCHAUTRETJET", switchAutoRetroJet);
-	oapiWriteScenario_int(scn, "SWITCHRETRODELA", switchRetroDelay);
-	oapiWriteScenario_int(scn, "SWITCHRETROATTI", switchRetroAttitude);
-	oapiWriteScenario_int(scn, "SWITCHASCSMODE", switchASCSMode);
-	oapiWriteScenario_int(scn, "SWITCHCONTRMODE", switchControlMode);
-
-	oapiWriteScenario_int(scn, "THANDLEMANUAL", (int)tHandleManualPushed);
-	oapiWriteScenario_int(scn, "THANDLEPITCH", (int)tHandlePitchPushed);
-	oapiWriteScenario_int(scn, "THANDLEYAW", (int)tHandleYawPushed);
-	oapiWriteScenario_int(scn, "THANDLEROLL", (int)tHandleRollPushed);
-
-	int i = 0;
-	while (scenarioTextureUserEnable && i < numTextures)
-	{
-		oapiWriteScenario_string(scn, "REPLACETEXTURE", textureString[i]);
-		i++;
-	}
-
-	if (conceptManouverUnit) oapiWriteScenario_int(scn, "CONCEPTATTACHED", conceptManouverUnitAttached);
-	if (conceptManouverUnit && !conceptCoverAttached) oapiWriteScenario_int(scn, "CONCEPTCOVER", conceptCoverAttached);
+	SaveScenarioKeys(scn); // see ScenarioKeys
 }
 
 bool ProjectMercury::SetTargetBaseIdx(char* rstr, bool launch)
@@ -2854,6 +2757,7 @@ bool ProjectMercury::SetNumberOfOrbits(char* rstr)
 
 void ProjectMercury::AtlasAutopilot(double simt, double simdt)
 {
+	PROFILE_SCOPE(PROF_AUTOPILOT);
 	SetADCtrlMode(0); // disable adc
 
 	double pitch = integratedPitch;
@@ -2893,14 +2797,14 @@ void ProjectMercury::AtlasAutopilot(double simt, double simdt)
 		pitch = GetPitch() * DEG; // integrated pitch becomes off by up to five degrees
 	}
 
-	if (met > BECO + 4.0 && VesselStatus == LAUNCH && !GroundContact()) // time from 19930074071 page 54. Big Joe failed to separate booster stage
+	if (met + simdt > BECO + 4.0 && VesselStatus == LAUNCH && !GroundContact()) // time from 19930074071 page 54. Big Joe failed to separate booster stage
 	{
-		separateBoosterAction = true;
+		QueueActionAt(ACTION_SEPARATEBOOSTER, launchTime + BECO + 4.0); // queued one step ahead, so that it can land at the right time
 	}
 
-	if (met > BECO + 20.0 && VesselStatus == LAUNCHCORE && !GroundContact()) // time from 19930074071 page 25
+	if (met + simdt > BECO + 20.0 && VesselStatus == LAUNCHCORE && !GroundContact()) // time from 19930074071 page 25
 	{
-		separateTowerAction = true;
+		QueueActionAt(ACTION_SEPARATETOWER, launchTime + BECO + 20.0);
 	}
 
 	double bottomPitch = -4.0;
@@ -3274,12 +3178,10 @@ void ProjectMercury::AtlasAutopilot(double simt, double simdt)
 
 	if (targetOrbitalVelocity + speedError < currentOrbitalVelocity + 3.4) // posigrades give additional 3.4 m/s dV
 	{
-		char cbuf[256];
 		SetThrusterGroupLevel(THGROUP_MAIN, 0.0);
 		AutopilotStatus = POSIGRADEDAMP;
 		boosterShutdownTime = simt;
-		sprintf(cbuf, "SECO T+%.1f", met);
-		oapiWriteLog(cbuf);
+		MLOG_INFO("SECO T+%.1f", met);
 	}
 }
 
@@ -3451,9 +3353,10 @@ inline VECTOR3 ProjectMercury::Equ2Ecl(VECTOR3 Equ)
 
 bool ProjectMercury::GetLandingPointIfRetroInXSeconds(double t, ELEMENTS el, ORBITPARAM prm, double longAtNow, double* longitude, double* latitude)
 {
+	PROFILE_SCOPE(PROF_RETROSEARCH);
 	// Constants
-	double planetMu = oapiGetMass(GetSurfaceRef()) * GGRAV;
-	double planetRad = oapiGetSize(GetSurfaceRef());
+	double planetMu = flightState.refMass * GGRAV;
+	double planetRad = flightState.refSize;
 
 	// First calculate state vector at retroburn
 	// Propagate TrA to the set time
@@ -3521,7 +3424,7 @@ bool ProjectMercury::GetLandingPointIfRetroInXSeconds(double t, ELEMENTS el, ORB
 	double postBurnMnA = TrA2MnA(postBurnTrA, postBurnEcc);
 
 	// Entry interface at altitude 87 550 m
-	double entryRadius = 87550.0 + oapiGetSize(GetSurfaceRef());
+	double entryRadius = 87550.0 + planetRad;
 	if (abs((postBurnSMa / entryRadius * (1.0 - postBurnEcc * postBurnEcc) - 1.0) / postBurnEcc) > 1.0)
 	{
 		return false; // no entry, because the perigee is above entry interface
@@ -3746,23 +3649,17 @@ void ProjectMercury::CheckAbortConditions(double simt, double simdt) // These co
 	if (abs(angVel.x * DEG) > 3.0)
 	{
 		abortConditionsMet = true;
-		char cbuf[256];
-		sprintf(cbuf, "Abort due to error in pitch rate at T+%.1f. It was %.1f deg/s", met, angVel.x * DEG);
-		oapiWriteLog(cbuf);
+		MLOG_WARN_EVERY(1.0, "Abort due to error in pitch rate at T+%.1f. It was %.1f deg/s", met, angVel.x * DEG);
 	}
 	if (abs(angVel.y * DEG) > 3.0)
 	{
 		abortConditionsMet = true;
-		char cbuf[256];
-		sprintf(cbuf, "Abort due to error in yaw rate at T+%.1f. It was %.1f deg/s", met, angVel.y * DEG);
-		oapiWriteLog(cbuf);
+		MLOG_WARN_EVERY(1.0, "Abort due to error in yaw rate at T+%.1f. It was %.1f deg/s", met, angVel.y * DEG);
 	}
 	if (abs(angVel.z * DEG) > rollLimit) // Wiki for MA-8 says it encountered a roll of 7.83 deg/s, which was "20 % from abort condition". Indicating limit 10 deg. Don't know what limit was before MA-9. MA-9 report also reports oscillations of 6 deg/s, but are probably so small that they are not considered
 	{
 		abortConditionsMet = true;
-		char cbuf[256];
-		sprintf(cbuf, "Abort due to error in roll rate at T+%.1f. It was %.1f deg/s", met, angVel.z * DEG);
-		oapiWriteLog(cbuf);
+		MLOG_WARN_EVERY(1.0, "Abort due to error in roll rate at T+%.1f. It was %.1f deg/s", met, angVel.z * DEG);
 	}
 
 	if (met < 0.1) // don't accumulate angular velocity when landed
@@ -3772,23 +3669,17 @@ void ProjectMercury::CheckAbortConditions(double simt, double simdt) // These co
 	if (!GroundContact() && GetAttachmentStatus(padAttach) == NULL && autoPilot && VesselStatus == LAUNCH && abs(GetPitch() * DEG - currentPitchAim) > 5.0)
 	{
 		abortConditionsMet = true;
-		char cbuf[256];
-		sprintf(cbuf, "Abort due to error in pitch at T+%.1f. It was %.1f deg. Target was %.2f deg", met, GetPitch() * DEG, currentPitchAim);
-		oapiWriteLog(cbuf);
+		MLOG_WARN_EVERY(1.0, "Abort due to error in pitch at T+%.1f. It was %.1f deg. Target was %.2f deg", met, GetPitch() * DEG, currentPitchAim);
 	}/*
 	if (autoPilot && abs(integratedYaw - currentYawAim) > 5.0)
 	{
 		abortConditionsMet = true;
-		char cbuf[256];
-		sprintf(cbuf, "Abort due to error in yaw at T+%.1f. It was %.1f deg. Target was %.2f deg", met, integratedYaw, currentYawAim);
-		oapiWriteLog(cbuf);
+		MLOG_WARN_EVERY(1.0, "Abort due to error in yaw at T+%.1f. It was %.1f deg. Target was %.2f deg", met, integratedYaw, currentYawAim);
 	}
 	if (autoPilot && !rollProgram && abs(integratedRoll - currentRollAim) > 10.0)
 	{
 		abortConditionsMet = true;
-		char cbuf[256];
-		sprintf(cbuf, "Abort due to error in roll at T+%.1f. It was %.1f deg. Target was %.2f deg", met, integratedRoll, currentRollAim);
-		oapiWriteLog(cbuf);
+		MLOG_WARN_EVERY(1.0, "Abort due to error in roll at T+%.1f. It was %.1f deg. Target was %.2f deg", met, integratedRoll, currentRollAim);
 	}*/
 }
 
@@ -3912,6 +3803,52 @@ MATRIX3 ProjectMercury::RotationMatrix(VECTOR3 angles, bool xyz)
 	return m;
 }
 
+void ProjectMercury::PerformAction(int action)
+{
+	switch (action)
+	{
+	case ACTION_SEPARATETOWER:
+		TowerSeparation();
+		break;
+	case ACTION_SEPARATEBOOSTER:
+		SeparateAtlasBooster(true);
+		break;
+	case ACTION_SEPARATECAPSULE:
+		CapsuleSeparate();
+		break;
+	case ACTION_PREPAREREENTRY:
+		PrepareReentry();
+		break;
+	case ACTION_SEPARATERETROCOVER1:
+		SeparateRetroCoverN(1);
+		break;
+	case ACTION_SEPARATERETROCOVER2:
+		SeparateRetroCoverN(2);
+		break;
+	case ACTION_SEPARATERETROCOVER3:
+		SeparateRetroCoverN(3);
+		break;
+	case ACTION_SEPARATEDROGUECOVER:
+		SeparateDrogueCover();
+		break;
+	case ACTION_SEPARATEDROGUE:
+		SeparateDrogue();
+		break;
+	case ACTION_SEPARATEMAINCHUTE:
+		SeparateMainChute();
+		break;
+	case ACTION_SEPARATECONCEPTADAPTER:
+		SeparateConceptAdapter();
+		break;
+	case ACTION_SEPARATECONCEPTCOVER:
+		SeparateConceptCovers();
+		break;
+	default:
+		oapiWriteLogV("Unknown action %i", action);
+		break;
+	}
+}
+
 void ProjectMercury::SeparateTower(bool noAbortSep)
 {
 	VESSELSTATUS2 vs;
@@ -3947,7 +3884,7 @@ void ProjectMercury::SeparateTower(bool noAbortSep)
 		vs.fuel->idx = 1;
 		vs.fuel->level = 1.0;
 
-		createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_AbortNominal", &vs);
+		debris.Create(name, "ProjectMercury\\Mercury_AbortNominal", &vs);
 	}
 	else
 	{
@@ -3955,10 +3892,9 @@ void ProjectMercury::SeparateTower(bool noAbortSep)
 		vs.fuel->level = 0.0;
 		AutopilotStatus = REENTRYATTITUDE;
 
-		createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_Abort", &vs);
+		debris.Create(name, "ProjectMercury\\Mercury_Abort", &vs);
 	}
 
-	stuffCreated += 1;
 	DelMesh(Tower);
 	DelPropellantResource(escape_tank);
 	DelThruster(escape_engine);
@@ -4011,12 +3947,9 @@ void ProjectMercury::SeparateAtlasBooster(bool noAbortSep)
 		strcpy(name, GetName());
 		strcat(name, " Atlas booster");
 
-		createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_atlas_booster", &vs);
-		stuffCreated += 1;
+		debris.Create(name, "ProjectMercury\\Mercury_atlas_booster", &vs);
 
-		char buff[256];
-		sprintf(buff, "Booster stage separated at T+%.1f", oapiGetSimTime() - launchTime);
-		oapiWriteLog(buff);
+		MLOG_INFO("Booster stage separated at T+%.1f", oapiGetSimTime() - launchTime);
 
 		if (VesselStatus == LAUNCH)
 		{
@@ -4119,12 +4052,12 @@ void ProjectMercury::SeparateAtlasCore(void)
 
 	if (VesselStatus == LAUNCHCORE || VesselStatus == LAUNCHCORETOWERSEP)
 	{
-		if (conceptManouverUnit) createdVessel[stuffCreated] = oapiCreateVesselEx(name, "Vessels\\ProjectMercury\\Mercury_AtlasCoreConcept", &vs); // no adapter, as we keep it attached to capsule
-		else createdVessel[stuffCreated] = oapiCreateVesselEx(name, "Vessels\\ProjectMercury\\Mercury_AtlasCore", &vs); // regular SECO with adapter and without booster
+		if (conceptManouverUnit) debris.Create(name, "Vessels\\ProjectMercury\\Mercury_AtlasCoreConcept", &vs); // no adapter, as we keep it attached to capsule
+		else debris.Create(name, "Vessels\\ProjectMercury\\Mercury_AtlasCore", &vs); // regular SECO with adapter and without booster
 	}
 	else
 	{
-		createdVessel[stuffCreated] = oapiCreateVesselEx(name, "Vessels\\ProjectMercury\\Mercury_AtlasCoreB", &vs); // with booster attached
+		debris.Create(name, "Vessels\\ProjectMercury\\Mercury_AtlasCoreB", &vs); // with booster attached
 		if (conceptManouverUnit)
 		{
 			DelPropellantResource(conceptPropellant);
@@ -4136,14 +4069,10 @@ void ProjectMercury::SeparateAtlasCore(void)
 		DelMesh(AtlasBooster); // Remove booster mesh as we're in LAUNCH or TOWERSEP, and therefore had it attached
 	}
 
-	stuffCreated += 1;
-
-	char buff[256];
-	sprintf(buff, "Core stage separated at T+%.1f", oapiGetSimTime() - launchTime);
-	oapiWriteLog(buff);
+	MLOG_INFO("Core stage separated at T+%.1f", oapiGetSimTime() - launchTime);
 
 	// The thrusterlist spec doesnt seem to work, sadly
-	VESSEL* v = oapiGetVesselInterface(createdVessel[stuffCreated - 1]);
+	VESSEL* v = oapiGetVesselInterface(debris.Last());
 	double levl = GetPropellantMass(atlas_propellant);
 	v->SetPropellantMass(v->GetPropellantHandleByIndex(0), levl);
 	if (GetThrusterLevel(th_main) != 0.0 && oapiGetSimTime() - launchTime < 30.0)
@@ -4196,8 +4125,7 @@ void ProjectMercury::SeparateRingsAndAdapters(double offZ)
 	vs.rvel += vel2;
 	strcpy(name, GetName());
 	strcat(name, " Adapter Cover 1");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_AdaptCover1", &vs);
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\Mercury_AdaptCover1", &vs);
 	DelMesh(Adaptcover1);
 
 	vel = _V(-0.823, -0.475, 0);
@@ -4209,8 +4137,7 @@ void ProjectMercury::SeparateRingsAndAdapters(double offZ)
 	vs.rvel += vel2;
 	strcpy(name, GetName());
 	strcat(name, " Adapter Cover 2");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_AdaptCover2", &vs);
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\Mercury_AdaptCover2", &vs);
 	DelMesh(Adaptcover2);
 
 	vel = _V(0.823, -0.475, 0);
@@ -4222,8 +4149,7 @@ void ProjectMercury::SeparateRingsAndAdapters(double offZ)
 	vs.rvel += vel2;
 	strcpy(name, GetName());
 	strcat(name, " Adapter Cover 3");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_AdaptCover3", &vs);
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\Mercury_AdaptCover3", &vs);
 	DelMesh(Adaptcover3);
 
 	vel = _V(-0.823, 0.475, 0);
@@ -4235,8 +4161,7 @@ void ProjectMercury::SeparateRingsAndAdapters(double offZ)
 	vs.rvel += vel2;
 	strcpy(name, GetName());
 	strcat(name, " Adapter Ring 1");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_AdaptRing1", &vs);
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\Mercury_AdaptRing1", &vs);
 	DelMesh(Adaptring1);
 
 	vel = _V(0.0, -0.95, 0);
@@ -4248,8 +4173,7 @@ void ProjectMercury::SeparateRingsAndAdapters(double offZ)
 	vs.rvel += vel2;
 	strcpy(name, GetName());
 	strcat(name, " Adapter Ring 2");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_AdaptRing2", &vs);
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\Mercury_AdaptRing2", &vs);
 	DelMesh(Adaptring2);
 
 	vel = _V(0.823, 0.475, 0);
@@ -4261,8 +4185,7 @@ void ProjectMercury::SeparateRingsAndAdapters(double offZ)
 	vs.rvel += vel2;
 	strcpy(name, GetName());
 	strcat(name, " Adapter Ring 3");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_AdaptRing3", &vs);
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\Mercury_AdaptRing3", &vs);
 	DelMesh(Adaptring3);
 
 	//capsuleSepTime = oapiGetSimTime();
@@ -4295,8 +4218,7 @@ void ProjectMercury::SeparateConceptAdapter(void)
 		char name[100];
 		strcpy(name, GetName());
 		strcat(name, " Concept Adapter");
-		createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\ConceptAdapter", &vs);
-		stuffCreated += 1;
+		debris.Create(name, "ProjectMercury\\ConceptAdapter", &vs);
 
 		// Delete thrusters
 		DelThruster(conceptPosigrade[0]);
@@ -4345,8 +4267,7 @@ void ProjectMercury::SeparateConceptCovers(void)
 	char name[100];
 	strcpy(name, GetName());
 	strcat(name, " Concept Cover 1");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\ConceptCover1", &vs);
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\ConceptCover1", &vs);
 
 	// Create cover vessel2
 	Local2Rel(CONCEPT_RETROGRADE_COVER2_OFFSET - MERCURY_OFS_CAPSULE, vs.rpos);
@@ -4356,8 +4277,7 @@ void ProjectMercury::SeparateConceptCovers(void)
 
 	strcpy(name, GetName());
 	strcat(name, " Concept Cover 2");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\ConceptCover2", &vs);
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\ConceptCover2", &vs);
 
 	// Update bool
 	conceptCoverAttached = false;
@@ -4438,6 +4358,7 @@ DLLCLBK void ovcExit(VESSEL* vessel)
 
 void ProjectMercury::vliftAtlas(VESSEL* v, double aoa, double M, double Re, void* context, double* cl, double* cm, double* cd)
 {
+	PROFILE_SCOPE(PROF_AERO);
 	static const double step = RAD * 22.5;
 	static const double istep = 1.0 / step;
 	static const int nabsc = 17;
@@ -4485,6 +4406,7 @@ void ProjectMercury::vliftAtlas(VESSEL* v, double aoa, double M, double Re, void
 
 void ProjectMercury::hliftAtlas(VESSEL* v, double beta, double M, double Re, void* context, double* cl, double* cm, double* cd)
 {
+	PROFILE_SCOPE(PROF_AERO);
 	static const double step = RAD * 22.5;
 	static const double istep = 1.0 / step;
 	static const int nabsc = 17;
@@ -4566,11 +4488,9 @@ inline void ProjectMercury::GetPanelRetroTimes(double met, int* rH, int* rM, int
 		double landingLong, landingLat;
 
 		// Current state:
-		ELEMENTS el;
-		ORBITPARAM prm;
-		GetElements(GetSurfaceRef(), el, &prm, oapiGetSimMJD(), FRAME_EQU);
-		double longAtNow, latAtNow, radAtNow;
-		GetEquPos(longAtNow, latAtNow, radAtNow);
+		ELEMENTS el = flightState.el;
+		ORBITPARAM prm = flightState.prm;
+		double longAtNow = flightState.longitude;
 
 		while (time < 5500.0 && !closeSolution && (!engageRetro || simt < retroStartTime))
 		{
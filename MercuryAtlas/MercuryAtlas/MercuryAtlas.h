@@ -193,6 +193,80 @@ const char retroNames[][256] =							{	"1Bravo",		"1Charlie",		"1Delta",		"1Echo
 
 const int NUMBER_SUPPORTED_CONFIG_CAPSULES = 10;
 
+// Radio contact prediction
+typedef struct radiopass {
+	int base; // index in radioBasePos
+	double aos; // simt
+	double los;
+} RADIOPASS;
+const int RADIO_MAX_BASES = 40;
+const int RADIO_MAX_PASSES = 100;
+const int RADIO_HUD_PASSES = 3;
+const double RADIO_PREDICTION_ORBITS = 2.0; // how far to predict, in number of orbital periods
+const double RADIO_PREDICTION_STEP = 10.0; // seconds. Shortest real pass is much longer than this
+const double RADIO_PREDICTION_MIN_ALT = 100e3; // below this, use InRadioContact directly
+const double RADIO_PREDICTION_MAX_THRUST_ACC = 0.05; // m/s^2. Thrusting harder than this invalidates prediction
+const double RADIO_PREDICTION_MAX_DRIFT = 10e3; // m
+const double RADIO_PREDICTION_DRIFT_INTERVAL = 10.0; // seconds between checking prediction against actual position
+
+// Separation and staging actions. Performed in time order by ProcessActionQueue. For equal times, in this order
+const enum ACTION_ID { ACTION_SEPARATETOWER, ACTION_SEPARATEBOOSTER, ACTION_SEPARATECAPSULE, ACTION_PREPAREREENTRY,
+ACTION_SEPARATERETROCOVER1, ACTION_SEPARATERETROCOVER2, ACTION_SEPARATERETROCOVER3,
+ACTION_SEPARATEDROGUECOVER, ACTION_SEPARATEDROGUE, ACTION_SEPARATEMAINCHUTE,
+ACTION_SEPARATECONCEPTADAPTER, ACTION_SEPARATECONCEPTCOVER
+};
+const int MAX_QUEUED_ACTIONS = 12; // each action is only queued once, so never more than the number of actions
+
+typedef struct
+{
+	int action;
+	double time; // intended simt
+} QUEUEDACTION;
+
+const int GLOBE_MAX_VERTICES = 1000; // globe mesh has 1 + 12 * 72 = 865
+const int GLOBE_MAX_RINGS = 36;
+const int GLOBE_MAX_SPOKES = 360;
+const double GLOBE_TEXEL_ANGLE = 3.0 * PI / 4096.0; // texture covers 540 deg. Assume 4096 px wide, which is conservative
+
+const int BUTTON_WHEEL_SLOTS = 8; // timer wheel for button lights, see AdvanceButtonWheel
+
+const int MAX_DIAL_EDITS = 50; // more than the number of arm groups
+const float DIAL_PIXEL_THRESHOLD = 0.3f; // panel mesh units (1440 high), so below one pixel on any normal screen
+
+typedef struct
+{
+	int group;
+	NTVERTEX vtx[5];
+} DIALEDIT;
+
+// Instrument groups in AnimateDials, each with its own refresh rate. See PANEL_SCHEDULE in VirtualCockpit.h
+const enum PANEL_INSTRUMENT { PANEL_GMETER, PANEL_FUEL, PANEL_DESCENT, PANEL_ALTITUDE, PANEL_ATTITUDE, PANEL_CLOCK, PANEL_RATE,
+PANEL_GLOBE, PANEL_MET, PANEL_RETROTIMES, PANEL_INDICATORS, PANEL_INSTRUMENT_COUNT
+};
+const enum PANEL_COST { PANEL_COST_CHEAP, PANEL_COST_EXPENSIVE };
+
+// Vessel state read from Orbiter once per timestep (UpdateFlightState, from clbkPreStep).
+// The HUD, panel and retro calculations read this instead of querying Orbiter again.
+typedef struct
+{
+	double simt; // when it was read
+	OBJHANDLE ref; // surface reference
+	double refSize, refMass, refPeriod; // radius, mass and rotation period of ref
+	double longitude, latitude, radius;
+	double altitude;
+	double pitch, bank, slip; // raw, without the attitude offsets
+	VECTOR3 angVel;
+	VECTOR3 airspeedHorizon, groundspeedHorizon;
+	VECTOR3 relPos, relVel; // relative to ref
+	double atmPressure;
+	double fuelAuto, fuelManual; // kg
+	ELEMENTS el; // equatorial frame
+	ORBITPARAM prm;
+	bool valid;
+} FLIGHTSTATE;
+
+struct SCENARIOKEY; // see MercuryCapsule.h
+
 class ProjectMercury : public VESSELVER {
 public:
 	ProjectMercury(OBJHANDLE hVessel, int flightmodel);
@@ -267,6 +341,10 @@ public:
 	void InflightAbortSeparate(void);
 	void OffPadAbortSeparate(void);
 	void CapsuleSeparate(void);
+	void QueueAction(int action);
+	void QueueActionAt(int action, double time);
+	void ProcessActionQueue(double simt, double simdt);
+	void PerformAction(int action);
 	void CreatePosigradeRockets(void);
 	void CreateRetroRockets(void);
 	void PrepareReentry(void);
@@ -312,6 +390,11 @@ public:
 	void AnimateLandingBag(double simt, double simdt);
 
 	bool InRadioContact(OBJHANDLE planet);
+	bool PredictedRadioContact(OBJHANDLE planet, double simt);
+	void PredictRadioPasses(OBJHANDLE planet, double simt);
+	double RadioPredictionAlpha(double t, VECTOR3* radLatOut);
+	VECTOR3 RadioPredictionPos(double t);
+	bool RadioBaseVisible(int baseIdx, VECTOR3 pos);
 
 	// Periscope altitude indicators
 	void GetPixelDeviationForAltitude(double inputAltitude, double *deg0Pix, double *deg5Pix);
@@ -322,12 +405,18 @@ public:
 	void CreatePanelSwitchClick(int ID_L, int ID_R, int x, int y, PANELHANDLE hPanel);
 	void CreatePanelTHandleClick(int ID, int x, int y, PANELHANDLE hPanel);
 	void FitPanelToScreen(int w, int h);
+	bool PanelInstrumentDue(int instrument);
 	void AnimateDials(void);
 	void RotateArmGroup(int groupNum, float x0, float y0, float length, float width, float angleR, float pointiness, float negLength = 0.0f, bool includeLatency = true);
+	void FlushDialEdits(void);
 	float ValueToAngle(float value, float minValue, float maxValue, float minAngle, float maxAngle);
+	void PrepareGlobeTables(float angularResolution, float viewAngularRadius);
 	void RotateGlobe(float angularResolution, float viewAngularRadius, float longitude0, float latitude0, float rotationAngle = 0.0f);
 	void ChangePanelNumber(int group, int num);
 	void ChangeIndicatorStatus(void);
+	void ApplyPanelState(unsigned long long state, unsigned long long changed);
+	void PressIndicatorButton(int button, double simt);
+	void AdvanceButtonWheel(double simt);
 	void SetIndicatorStatus(int indicatorNr, int status);
 	void SetIndicatorButtonStatus(int buttonNr, int status);
 	void SetPhysicalSwitchStatus(int switchNr, int status);
@@ -350,19 +439,33 @@ public:
 	void CreateCapsuleFuelTanks(void);
 	void AddDefaultMeshes(void);
 	void CapsuleGenericPostCreation(void);
-	void DeleteRogueVessels(void);
+	void PrewarmCapsuleSeparations(void);
 	void CapsuleAttitudeControl(double simt, double simdt);
 	void FlyByWireControlSingleDirection(double thrustLevel, THRUSTER_HANDLE high, THRUSTER_HANDLE low, bool tHandlePushed);
 	void MercuryCapsuleGenericTimestep(double simt, double simdt, double latit, double longit, double getAlt);
+	void UpdateFlightState(double simt);
+	void RecordFlightData(double simt);
 	void WriteHUDAutoFlightReentry(oapi::Sketchpad* skp, double simt, int *yIndexUpdate, char *cbuf);
 	void WriteHUDIndicators(oapi::Sketchpad* skp, double simt, int* yIndexUpdate, char* cbuf);
+	void WriteHUDRadioPasses(oapi::Sketchpad* skp, double simt, int* yIndexUpdate, char* cbuf);
 	void LoadCapsule(const char *cbuf);
+	void LoadScenarioKeys(FILEHANDLE scn, void* status);
+	void SaveScenarioKeys(FILEHANDLE scn);
+	bool LoadScenarioCommon(int special, const char* value);
+	bool SaveScenarioCommon(FILEHANDLE scn, int special, const char* key);
 	void ReadCapsuleTextureReplacement(const char* cbuf);
 	bool ReadTextureString(const char* cbuf, const int len, char* texturePath, int* textureWidth, int* textureHeight);
 	void LoadCapsuleTextureReplacement(void);
 	void LoadTextureFile(ATEX tex, const char* type, MESHHANDLE mesh, DWORD meshTexIdx);
 	// Rocket specific similar functions
 	bool ReadRocketTextureReplacement(const char* flag, const char* cbuf, int len);
+	const SCENARIOKEY* ScenarioKeys(int* numKeys);
+	void LoadScenarioSpecial(int special, const char* value);
+	void SaveScenarioSpecial(FILEHANDLE scn, int special, const char* key);
+	const SCENARIOKEY* CheckpointFields(int* numFields);
+	void SaveCheckpoint(FILEHANDLE scn, const char* key);
+	void LoadCheckpoint(const char* file);
+	void ApplyCheckpoint(void);
 	void LoadRocketTextureReplacement(void);
 
 	// Config settings
@@ -548,17 +651,18 @@ private:
 	bool configTextureUserEnable = false; // by default, don't load textures defined in config. Only if actual capsule is called
 	bool scenarioTextureUserEnable = false;
 
+	// Checkpoint
+	char checkpointFile[MAX_PATH] = "";
+	bool checkpointPending = false; // read in scenario, applied in CapsuleGenericPostCreation
+	bool metFromScenario = false; // launchTime set by MET, not taken from the checkpoint
+
 
 	// Actions
-	bool separateTowerAction = false;
-	bool separateBoosterAction = false;
-	bool separateCapsuleAction = false;
-	bool separateRetroCoverAction[3] = { false, false, false };
-	bool separateRetroPackAction = false;
-	bool prepareReentryAction = false;
-	bool separateDrogueCoverAction = false;
-	bool separateDrogueAction = false;
-	bool separateMainChuteAction = false;
+	QUEUEDACTION actionQueue[MAX_QUEUED_ACTIONS];
+	int actionQueueNum = 0;
+	bool actionWarpReduction = false; // lower time acceleration when an action is due within the next step, so that it is not performed late
+	double actionWarpRestore = 0.0; // time acceleration before it was lowered. 0 when not lowered
+	double actionWarpSet = 0.0; // time acceleration we lowered to. If the user has changed it since, actionWarpRestore is dropped
 
 	bool capsuleDefined = false;
 	bool abort = false;
@@ -611,6 +715,18 @@ private:
 							   2 = Nothing (only stock HUD)*/
 	char contactBase[50];
 	bool radioContact = true;
+	OBJHANDLE radioPredictionPlanet = NULL;
+	bool radioPredictionValid = false;
+	double radioPredictionEpoch = 0.0;
+	double radioPredictionEnd = 0.0;
+	double radioNextTransition = 0.0;
+	double radioNextDriftCheck = 0.0;
+	double radioPredSMa, radioPredEcc, radioPredInc, radioPredLAN, radioPredAPe, radioPredMnA, radioPredPer, radioPredLong0, radioPredAlpha0;
+	int radioBaseNum = 0;
+	VECTOR3 radioBasePos[RADIO_MAX_BASES]; // planet fixed, same frame as RadioPredictionPos
+	char radioBaseName[RADIO_MAX_BASES][25];
+	int radioPassNum = 0;
+	RADIOPASS radioPass[RADIO_MAX_PASSES]; // sorted by AOS
 	bool leftMFDwasOn = false;
 	bool rightMFDwasOn = false;
 	bool MercuryNetwork = true;
@@ -659,19 +775,53 @@ private:
 	bool rocketCam = false;
 	int rocketCamMode = 0;
 	bool panelView = false;
-	int armGroups[50] = { NULL }; // Support up to 50 for now. Real number more like 15
+	std::vector<int> armGroups; // from FitPanelToScreen. Real number around 16
 	int totalArmGroups = 0;
-	int panelMeshGroupSide[100] = { 0 }; // 0 empty, 1 left, 2 right, -1 ignore
+	std::vector<int> panelMeshGroupSide; // 1 left, 2 right, -1 ignore
 	//float addScreenWidthValue = 0.0;
 	int globeGroup = NULL;
 	int globeVertices = NULL;
+	NTVERTEX globeVertex[GLOBE_MAX_VERTICES]; // persistent, so we don't build it on the stack every frame
+	WORD globeVertexIndex[GLOBE_MAX_VERTICES];
+	double globeSinRing[GLOBE_MAX_RINGS], globeCosRing[GLOBE_MAX_RINGS];
+	double globeSinSpoke[GLOBE_MAX_SPOKES], globeCosSpoke[GLOBE_MAX_SPOKES];
+	int globeRings = 0;
+	int globeSpokes = 0;
+	float globeTableResolution = 0.0f; // 0 means tables not made
+	float globeTableRadius = 0.0f;
+	bool globeEdited = false;
+	float globeLastLongitude = 0.0f;
+	float globeLastLatitude = 0.0f;
+	float globeLastRotation = 0.0f;
 	float previousDialAngle[200] = { 0.0f }; // must be longer than total mesh group number
 	float dialAngularSpeed = float(180.0 * RAD); // Degrees per second
+	bool dialDrawn[200] = { false }; // last drawn dial position, to skip edits that wouldn't be visible
+	float dialDrawnX[200] = { 0.0f };
+	float dialDrawnY[200] = { 0.0f };
+	float dialDrawnAngle[200] = { 0.0f };
+	DIALEDIT dialEdit[MAX_DIAL_EDITS];
+	int dialEditNum = 0;
+	int dialEditsTotal = 0;
+	int dialEditsMax = 0;
+	int dialEditFrames = 0;
+	double panelInstrumentNext[PANEL_INSTRUMENT_COUNT] = { 0.0 }; // system time
+	double panelInstrumentSimt[PANEL_INSTRUMENT_COUNT] = { 0.0 }; // last update
+	int panelInstrumentUpdates[PANEL_INSTRUMENT_COUNT] = { 0 };
+	bool panelForceAll = true;
+	double panelSysTime = 0.0;
+	int panelExpensiveThisFrame = 0;
+	float dialStepTime = 0.0f;
+	double panelMaxRate = 0.0; // Hz, 0 is no limit
+	double panelCostTotal = 0.0; // ms
+	double panelCostMax = 0.0;
+	int panelFrames = 0;
 	int abortIndicatorGroup = NULL;
-	int previousIndicatorStatus[13] = { 0 };
+	unsigned long long panelDrawnState = 0; // bitset of what the lights, buttons and switches show now. See ChangeIndicatorStatus
+	bool panelDrawnStateValid = false;
 	bool retroWarnLight = false;
-	double indicatorButtonPressTime[20]; // right now support 20 buttons, but this limit is arbitrary. Increase if needed
-	int indicatorButtonPressState[20] = { -1 };
+	unsigned int buttonLightsOn = 0; // bit per button
+	unsigned int buttonWheel[BUTTON_WHEEL_SLOTS] = { 0 }; // buttons to extinguish at each tick
+	long long buttonWheelTick = 0;
 	int indicatorButtonFirstGroup = 13; // right now it's 13, but doesn't matter what we set to, as it will be correctly assigned every frame
 	//int physicalSwitchState[5] = { -2 }; // -1 left, 0 centre, 1 right. -2 is reset
 	int physicalSwitchFirstGroup = 17; // right now it's 17, but doesn't matter what we set to, as it will be correctly assigned every frame
@@ -696,6 +846,7 @@ private:
 	//SURFHANDLE panelTexture = NULL;
 
 
+	FLIGHTSTATE flightState = { 0 }; // see UpdateFlightState
 	double vesselAcceleration;
 	double longitudinalAcc;
 	double maxVesselAcceleration = -1e9; // random initialiser value (neg inft.)
@@ -768,8 +919,14 @@ private:
 	int retroErrorNum = 10; // the retro to be failed. 10 is "infinity", must be either 0, 1 or 2
 	int attitudeThrusterErrorNum = 100; // "infinity". Must be between 0 and 17
 
-	int stuffCreated = 0;
-	OBJHANDLE createdVessel[25]; // number is close to 20, but don't bother counting exactly
+	DebrisManager debris; // everything we have separated. See DebrisManager.h
+	HudTextCache hudText; // formatted HUD lines. See HudTextCache.h
+	OrbiterTextureLoader textureLoader; // copies replacement textures from TextureCache.h into the meshes
+	TextureQueue textureQueue{ &textureLoader }; // replacement textures not yet applied. See AsyncTextureLoader.h
+	FlightRecorder recorder; // telemetry file. See FlightRecorder.h
+	unsigned int recorderChannels = REC_ALL;
+	double recorderRate = 0.0; // Hz, 0 is off
+	FlightHistory flightHistory; // decimated altitude, G-load and velocity. See FlightHistory.h
 
 	bool capsuleOnly = false; // Is possibly overloaded at SetClassCaps. If set to true spawns a capsule in FLIGHT stage
 	bool capsuleTowerRetroOnly = false; // Is possibly overloaded at SetClassCaps. If set to true, spawns a capsule in ABORT stage, with LES and retropack
@@ -778,8 +935,6 @@ private:
 	bool conceptManouverUnit = false;
 	bool conceptManouverUnitAttached = true;
 	bool conceptCoverAttached = true;
-	bool separateConceptAdapterAction = false;
-	bool separateConceptCoverAction = false;
 	MESHHANDLE conceptRetrogradeThrusters;
 	MESHHANDLE conceptCover1, conceptCover2;
 	UINT ConceptRetrogradeThrusters;
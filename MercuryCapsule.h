@@ -3,6 +3,7 @@
 #include <time.h> // for seed in random function
 #include "VirtualCockpit.h"
 #include "ProjectMercuryGeneric.h"
+#include "RadioContactPredictor.h"
 #include "..\..\Sound\OrbiterSound_SDK\VESSELSOUND_SDK\ShuttlePB_project\OrbiterSoundSDK50.h"
 
 // ==============================================================
@@ -127,6 +128,7 @@ inline void ProjectMercury::DisableAutopilot(bool turnOff)
 
 void ProjectMercury::AuxDampingAuto(bool highThrust) // return number of active engines
 {
+	PROFILE_SCOPE(PROF_AUTOPILOT);
 	THRUSTER_HANDLE py0, py1, py2, py3, roll0, roll1;
 
 	if (!rcsExists) return; // no RCS, so not damping
@@ -218,6 +220,7 @@ void ProjectMercury::AuxDampingAuto(bool highThrust) // return number of active
 
 void ProjectMercury::RetroAttitudeAuto(double simt, double simdt, bool highTorque) // finished
 {
+	PROFILE_SCOPE(PROF_AUTOPILOT);
 	//bool highTorque = false;
 
 	if (oapiGetTimeAcceleration() < 15.0) // for high time acc things get unstable
@@ -595,6 +598,7 @@ bool ProjectMercury::SetRollAuto(bool highTorque)
 
 void ProjectMercury::ReentryAttitudeAuto(double simt, double simdt)
 {
+	PROFILE_SCOPE(PROF_AUTOPILOT);
 	bool highTorque = true; // always high torque ...
 
 	if (oapiGetTimeAcceleration() >= 2.0) // ... unless in TimeAcc
@@ -625,6 +629,7 @@ void ProjectMercury::ReentryAttitudeAuto(double simt, double simdt)
 
 void ProjectMercury::GRollAuto(double simt, double simdt)
 {
+	PROFILE_SCOPE(PROF_AUTOPILOT);
 	VECTOR3 angVel;
 	GetNoisyAngularVel(angVel, ASCSstdDev * RAD);
 
@@ -695,7 +700,7 @@ inline void ProjectMercury::FireRetroRocket(int rckNum)
 
 	if (!retroCoverSeparated[rckNum] && RETRO_THRUST_LEVEL[rckNum] > 0.0) // only blow away cover if actually fired
 	{
-		separateRetroCoverAction[rckNum] = true;
+		QueueAction(ACTION_SEPARATERETROCOVER1 + rckNum);
 	}
 }
 
@@ -1113,10 +1118,7 @@ void ProjectMercury::SeparateRetroPack(bool deleteThrusters) // only false if no
 	vs.rvel += vel2;
 	strcpy(name, GetName());
 	strcat(name, " Retro");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_Retro", &vs);
-	//if (GetAltitude() > 5e4)
-	//	createdAbove50km[stuffCreated] = true;
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\Mercury_Retro", &vs);
 	DelMesh(Retro);
 
 	vel = _V(0.0, 0.75, -1.0);
@@ -1133,10 +1135,7 @@ void ProjectMercury::SeparateRetroPack(bool deleteThrusters) // only false if no
 	vs.vrot.y = 0.0;
 	strcpy(name, GetName());
 	strcat(name, " Retrostrap 1");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_Retrostrap1", &vs);
-	//if (GetAltitude() > 5e4)
-	//	createdAbove50km[stuffCreated] = true;
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\Mercury_Retrostrap1", &vs);
 	DelMesh(Retrostrap1);
 
 	vel = _V(-0.65, -0.375, -1.0);
@@ -1153,10 +1152,7 @@ void ProjectMercury::SeparateRetroPack(bool deleteThrusters) // only false if no
 	vs.vrot.y = -0.66;
 	strcpy(name, GetName());
 	strcat(name, " Retrostrap 2");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_Retrostrap2", &vs);
-	//if (GetAltitude() > 5e4)
-	//	createdAbove50km[stuffCreated] = true;
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\Mercury_Retrostrap2", &vs);
 	DelMesh(Retrostrap2);
 
 	vel = _V(0.65, -0.375, -1.0);
@@ -1173,10 +1169,7 @@ void ProjectMercury::SeparateRetroPack(bool deleteThrusters) // only false if no
 	vs.vrot.y = 0.66;
 	strcpy(name, GetName());
 	strcat(name, " Retrostrap 3");
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_Retrostrap3", &vs);
-	//if (GetAltitude() > 5e4)
-	//	createdAbove50km[stuffCreated] = true;
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\Mercury_Retrostrap3", &vs);
 	DelMesh(Retrostrap3);
 
 	if (deleteThrusters)
@@ -1247,10 +1240,7 @@ void ProjectMercury::SeparateRetroCoverN(int i) // int 1, 2, 3
 		GlobalRot(vel, vel2);
 		vs.rvel += vel2;
 		sprintf(configName, "ProjectMercury\\Mercury_RetroCover%i", i);
-		createdVessel[stuffCreated] = oapiCreateVesselEx(name, configName, &vs);
-		//if (GetAltitude() > 5e4)
-		//	createdAbove50km[stuffCreated] = true;
-		stuffCreated += 1;
+		debris.Create(name, configName, &vs);
 		DelMesh(meshToDelete);
 	}
 }
@@ -1278,10 +1268,7 @@ void ProjectMercury::SeparateDrogueCover(void)
 		VECTOR3 vel2;
 		GlobalRot(vel, vel2);
 		vs.rvel += vel2;
-		createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_DrogueCover", &vs);
-		//if (GetAltitude() > 5e4)
-		//	createdAbove50km[stuffCreated] = true;
-		stuffCreated += 1;
+		debris.Create(name, "ProjectMercury\\Mercury_DrogueCover", &vs);
 		DelMesh(Droguecover);
 		drogueCoverSeparated = true;
 	}
@@ -1311,14 +1298,11 @@ void ProjectMercury::SeparateDrogue(void)
 		GlobalRot(vel, vel2);
 		vs.rvel += vel2;
 
-		if (CapsuleVersion == CAPSULEBIGJOE) createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_AntennaBJ", &vs);
-		else if (CapsuleVersion == CAPSULELITTLEJOE) createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_AntennaLJ", &vs);
-		else if (CapsuleVersion == CAPSULEBD) createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_AntennaBD", &vs);
-		else createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_Antenna", &vs);
+		if (CapsuleVersion == CAPSULEBIGJOE) debris.Create(name, "ProjectMercury\\Mercury_AntennaBJ", &vs);
+		else if (CapsuleVersion == CAPSULELITTLEJOE) debris.Create(name, "ProjectMercury\\Mercury_AntennaLJ", &vs);
+		else if (CapsuleVersion == CAPSULEBD) debris.Create(name, "ProjectMercury\\Mercury_AntennaBD", &vs);
+		else debris.Create(name, "ProjectMercury\\Mercury_Antenna", &vs);
 
-		//if (GetAltitude() > 5e4)
-		//	createdAbove50km[stuffCreated] = true;
-		stuffCreated += 1;
 		DelMesh(Drogue);
 		DelMesh(Antennahouse);
 		drogueSeparated = true;
@@ -1335,7 +1319,7 @@ void ProjectMercury::SeparateDrogue(void)
 
 void ProjectMercury::DeployDrogue(void)
 {
-	separateDrogueCoverAction = true;
+	QueueAction(ACTION_SEPARATEDROGUECOVER);
 
 	if (!drogueDeployed)
 	{
@@ -1437,10 +1421,7 @@ void ProjectMercury::SeparateMainChute(void)
 	{
 		strcat(name, " Main chute");
 
-		createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_Chute", &vs);
-		//if (GetAltitude() > 5e4)
-		//	createdAbove50km[stuffCreated] = true;
-		stuffCreated += 1;
+		debris.Create(name, "ProjectMercury\\Mercury_Chute", &vs);
 		DelMesh(Mainchute);
 		mainChuteSeparated = true;
 		oapiWriteLog("Separate main chute");
@@ -1449,10 +1430,7 @@ void ProjectMercury::SeparateMainChute(void)
 	{
 		strcat(name, " Reserve chute");
 
-		createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_Chute", &vs);
-		//if (GetAltitude() > 5e4)
-		//	createdAbove50km[stuffCreated] = true;
-		stuffCreated += 1;
+		debris.Create(name, "ProjectMercury\\Mercury_Chute", &vs);
 		DelMesh(Mainchute);
 		reserveChuteSeparated = true;
 		oapiWriteLog("Separate reserve chute");
@@ -1622,6 +1600,13 @@ inline void ProjectMercury::DisableAttitudeThruster(int num)
 	SetThrusterResource(thFail, NULL);
 }
 
+// Vessels of this module that exist. The stats shared by all of them (texture cache, log, profiler) are written when the last one is deleted
+inline int& ModuleVesselCount(void)
+{
+	static int count = 0;
+	return count;
+}
+
 inline void ProjectMercury::MercuryGenericConstructor(void)
 {
 	adaptcover1 = oapiLoadMeshGlobal("ProjectMercury\\merc_adaptcover1");
@@ -1673,16 +1658,15 @@ inline void ProjectMercury::MercuryGenericConstructor(void)
 	UINT seed = UINT(timeSeed * handleSeed);
 	srand(seed);
 	oapiWriteLogV("Vessel random function seeds: time %i, handle %i, combined %i", timeSeed, handleSeed, seed);
-	
+
+	ModuleVesselCount() += 1;
 
 	//panelDynamicTexture = NULL; // debug
 }
 
 inline void ProjectMercury::WriteFlightParameters(void)
 {
-	char cbuf[256];
-	sprintf(cbuf, "%s Flight parameters:", GetName());
-	oapiWriteLog(cbuf);
+	MLOG_INFO("%s Flight parameters:", GetName());
 
 	if (historyReference == NULL || historyLandLat == NULL)
 	{
@@ -1726,6 +1710,34 @@ inline void ProjectMercury::WriteFlightParameters(void)
 	oapiWriteLogV(" > Maximum reentry load factor: %.1f g", historyMaxReentryAcc / G);
 	oapiWriteLogV(" > Earth-fixed velocity: %.0f m/s (%.0f ft/s)", historyMaxEarthSpeed, historyMaxEarthSpeed / 0.3048);
 	oapiWriteLogV(" > Space-fixed velocity: %.0f m/s (%.0f ft/s)", historyMaxSpaceSpeed, historyMaxSpaceSpeed / 0.3048);
+	if (launchTime != 0.0) // only for vessels that have flown, not every pad or menu visit
+	{
+		char historyFile[MAX_PATH];
+		CreateDirectoryA(FLIGHT_OUTPUT_FOLDER, NULL); // fails if it exists, which is fine
+		sprintf(historyFile, "%s\\MercuryHistory_%s_%.0f.csv", FLIGHT_OUTPUT_FOLDER, GetName(), flightHistory.StartMJD() * 86400.0);
+		flightHistory.Export(historyFile, launchTime); // altitude, G-load and velocity vs MET
+	}
+	debris.WriteLogStats();
+	hudText.WriteLogStats();
+	recorder.Stop(); // also writes its stats
+	if (dialEditFrames > 0) oapiWriteLogV(" > Panel dial edits: %.2f per frame (maximum %i), %i frames", double(dialEditsTotal) / double(dialEditFrames), dialEditsMax, dialEditFrames);
+	if (panelFrames > 0)
+	{
+		oapiWriteLogV(" > Panel cost: %.3f ms per frame (maximum %.3f ms), %i frames", panelCostTotal / double(panelFrames), panelCostMax, panelFrames);
+		for (int i = 0; i < PANEL_INSTRUMENT_COUNT; i++)
+		{
+			oapiWriteLogV(" >   %s updated in %.0f %% of frames", PANEL_SCHEDULE[i].name, 100.0 * double(panelInstrumentUpdates[i]) / double(panelFrames));
+		}
+	}
+
+	ModuleVesselCount() -= 1;
+	if (ModuleVesselCount() == 0) // last vessel of this module
+	{
+		TextureCache::Global().ReleaseIdle(oapiGetSysTime(), 0.0); // nobody left to share them with
+		TextureCache::Global().WriteLogStats();
+		MercuryLog::Flush();
+		PROFILE_REPORT();
+	}
 
 	// Spend the opportunity to destroy the panel mesh. If we don't do this, it will be buggy if we relaunch a scenario with panel.
 	//if (cockpitPanelMesh) oapiDeleteMesh(cockpitPanelMesh);
@@ -1734,15 +1746,8 @@ inline void ProjectMercury::WriteFlightParameters(void)
 
 inline void ProjectMercury::ReadConfigSettings(FILEHANDLE cfg)
 {
-	FILEHANDLE commonCfg = oapiOpenFile("Vessels\\ProjectMercury\\ProjectMercuryCommon.cfg", FILE_IN_ZEROONFAIL, CONFIG);
-	bool foundCommonFile = true;
-
-	if (commonCfg == 0)
-	{
-		oapiWriteLog("ProjectMercuryCommon config file missing!");
-		commonCfg = cfg; // maybe there's some data we can read from there, so use it as backup
-		foundCommonFile = false;
-	}
+	// ProjectMercuryCommon.cfg is only read by the first vessel, see MercurySettings.h
+	const MercurySettings& settings = MercurySettings::Get(cfg);
 
 	// Read height over ground from config
 	if (!oapiReadItem_float(cfg, "HeightOverGround", heightOverGround))
@@ -1780,66 +1785,33 @@ inline void ProjectMercury::ReadConfigSettings(FILEHANDLE cfg)
 		oapiWriteLog("Mercury could not read rudder lift coeff config.");
 	}
 
-	// Read HUD x-pos of second column
-	if (!oapiReadItem_int(commonCfg, "HUD2ndColumnPos", secondColumnHUDx))
-	{
-		secondColumnHUDx = 28;
-		oapiWriteLog("Mercury could not read HUD column position config.");
-	}
-
-	if (!oapiReadItem_float(commonCfg, "TimeStepLimit", timeStepLimit))
-	{
-		timeStepLimit = 0.1;
-		oapiWriteLog("Mercury could not read time step limit config for authentic autopilot.");
-	}
-
-	if (!oapiReadItem_bool(commonCfg, "MercuryNetwork", MercuryNetwork))
-	{
-		MercuryNetwork = true;
-		oapiWriteLog("Mercury could not read network contact config.");
-	}
-
-	if (!oapiReadItem_float(commonCfg, "JoysticThrustThresholdLow", joystickThresholdLow))
-	{
-		joystickThresholdLow = 0.33;
-		oapiWriteLog("Mercury could not read joystick low threshold.");
-	}
-
-	if (!oapiReadItem_float(commonCfg, "JoysticThrustThresholdHigh", joystickThresholdHigh))
-	{
-		joystickThresholdHigh = 0.75;
-		oapiWriteLog("Mercury could not read joystick high threshold.");
-	}
-
-	if (!oapiReadItem_float(commonCfg, "StandardDevRateASCS", ASCSstdDev))
-	{
-		ASCSstdDev = 0.25;
-		oapiWriteLog("Mercury could not read standard deviation rate for ASCS.");
-	}
-
-	if (!oapiReadItem_float(commonCfg, "StandardDevRateRSCS", RSCSstdDev))
-	{
-		RSCSstdDev = 1.0;
-		oapiWriteLog("Mercury could not read standard deviation rate for RSCS.");
-	}
-
-	if (!oapiReadItem_float(commonCfg, "RSCSresolution", RSCSresolutionD))
-	{
-		RSCSresolutionD = 3.0;
-		oapiWriteLog("Mercury could not read RSCS resolution.");
-	}
-
-	if (!oapiReadItem_float(commonCfg, "RSCSmaxRate", RSCSmax))
-	{
-		RSCSmax = 10.0;
-		oapiWriteLog("Mercury could not read RSCS maximum angular rate.");
-	}
-
-
-	char caps[NUMBER_SUPPORTED_CONFIG_CAPSULES][1000];
-	if (oapiReadItem_string(commonCfg, "DEFINENEWCAPSULE0", caps[0])) // Is defined
+	// Common settings
+	secondColumnHUDx = settings.hud2ndColumnPos;
+	timeStepLimit = settings.timeStepLimit;
+	MercuryNetwork = settings.mercuryNetwork;
+	joystickThresholdLow = settings.joystickThresholdLow;
+	joystickThresholdHigh = settings.joystickThresholdHigh;
+	ASCSstdDev = settings.ASCSstdDev;
+	RSCSstdDev = settings.RSCSstdDev;
+	RSCSresolutionD = settings.RSCSresolution;
+	RSCSmax = settings.RSCSmax;
+	actionWarpReduction = settings.actionWarpReduction;
+	panelMaxRate = settings.panelMaxRate;
+	recorderChannels = FlightRecorderChannels(settings.recorderChannels);
+	recorderRate = settings.recorderRate;
+
+	// Deletion of separated parts. Distance is the original rule, the rest are off (0) unless set in config
+	debris.SetPolicy("distance", DebrisTooFar, settings.debrisMaxDistance);
+	debris.SetPolicy("age", DebrisTooOld, settings.debrisMaxAge);
+	debris.SetPolicy("landed and at rest", DebrisAtRest, settings.debrisRestSpeed);
+	debris.SetPolicy("below horizon", DebrisBelowHorizon, settings.debrisHorizonDistance);
+
+	// The texture replacements are stored per vessel, so parse the definition every time. Only 0 is supported so far
+	if (settings.capsuleDefined[0]) // Is defined
 	{
 		int newIndex = 0;
+		char caps[NUMBER_SUPPORTED_CONFIG_CAPSULES][1000];
+		strcpy(caps[newIndex], settings.capsuleDefinition[newIndex]);
 
 		oapiWriteLogV("====BEGIN READ CONFIG CAPSULE %i=====", newIndex);
 		oapiWriteLog(caps[newIndex]); // Write out what is stored in config file
@@ -1870,44 +1842,6 @@ inline void ProjectMercury::ReadConfigSettings(FILEHANDLE cfg)
 
 		oapiWriteLogV("====END READ CONFIG CAPSULE %i=====", newIndex);
 	}
-	if (oapiReadItem_string(commonCfg, "DEFINENEWCAPSULE1", caps[1])) // Is defined, DEBUG
-	{
-
-	}
-	if (oapiReadItem_string(commonCfg, "DEFINENEWCAPSULE2", caps[2])) // Is defined
-	{
-
-	}
-	if (oapiReadItem_string(commonCfg, "DEFINENEWCAPSULE3", caps[3])) // Is defined
-	{
-
-	}
-	if (oapiReadItem_string(commonCfg, "DEFINENEWCAPSULE4", caps[4])) // Is defined
-	{
-
-	}
-	if (oapiReadItem_string(commonCfg, "DEFINENEWCAPSULE5", caps[5])) // Is defined
-	{
-
-	}
-	if (oapiReadItem_string(commonCfg, "DEFINENEWCAPSULE6", caps[6])) // Is defined
-	{
-
-	}
-	if (oapiReadItem_string(commonCfg, "DEFINENEWCAPSULE7", caps[7])) // Is defined
-	{
-
-	}
-	if (oapiReadItem_string(commonCfg, "DEFINENEWCAPSULE8", caps[8])) // Is defined
-	{
-
-	}
-	if (oapiReadItem_string(commonCfg, "DEFINENEWCAPSULE9", caps[9])) // Is defined
-	{
-
-	}
-
-	if (foundCommonFile) oapiCloseFile(commonCfg, FILE_IN_ZEROONFAIL); // don't close if the regular cfg file
 }
 
 inline void ProjectMercury::CreateCapsuleFuelTanks(void)
@@ -1973,8 +1907,20 @@ inline void ProjectMercury::CapsuleGenericPostCreation(void)
 	if (configTextureUserEnable || scenarioTextureUserEnable) LoadCapsuleTextureReplacement();
 
 	// Set basic start coordinate for history recording. It requires to be in launch state, so just get the current pos in case we are not in launch.
-	double radNoCare;
-	GetEquPos(historyLaunchLong, historyLaunchLat, radNoCare);
+	UpdateFlightState(oapiGetSimTime());
+	historyLaunchLong = flightState.longitude;
+	historyLaunchLat = flightState.latitude;
+	ApplyCheckpoint(); // exact state from the saved scenario, if any. Overrides the above
+
+	// Flight recorder, see FlightRecorder.h. Only if RecorderRate is set in the config
+	if (recorderRate > 0.0)
+	{
+		char recordFile[MAX_PATH];
+		CreateDirectoryA(FLIGHT_OUTPUT_FOLDER, NULL); // fails if it exists, which is fine
+		sprintf(recordFile, "%s\\MercuryFlight_%s_%.0f.mrec", FLIGHT_OUTPUT_FOLDER, GetName(), oapiGetSimMJD() * 86400.0);
+		recorder.Start(recordFile, recorderChannels, recorderRate, oapiGetSimMJD());
+	}
+	flightHistory.Begin(oapiGetSimMJD()); // see FlightHistory.h
 
 	if (GetDamageModel() == 0) // overwrite any scenario definition
 	{
@@ -2082,6 +2028,113 @@ inline void ProjectMercury::CapsuleGenericPostCreation(void)
 	//RequestLoadVesselWave(OrbiterSoundID, OSATTITUDE, "..\\..\\Vessel\\attfire.wav", INTERNAL_ONLY); // and load the sound for manual playing
 }
 
+// Load config and modules of the capsule parts we may separate, so that retro jettison etc. doesn't hitch
+inline void ProjectMercury::PrewarmCapsuleSeparations(void)
+{
+	debris.Prewarm("ProjectMercury\\Mercury_Retro");
+	debris.Prewarm("ProjectMercury\\Mercury_Retrostrap1");
+	debris.Prewarm("ProjectMercury\\Mercury_Retrostrap2");
+	debris.Prewarm("ProjectMercury\\Mercury_Retrostrap3");
+	debris.Prewarm("ProjectMercury\\Mercury_RetroCover1");
+	debris.Prewarm("ProjectMercury\\Mercury_RetroCover2");
+	debris.Prewarm("ProjectMercury\\Mercury_RetroCover3");
+
+	if (!drogueCoverSeparated)
+		debris.Prewarm("ProjectMercury\\Mercury_DrogueCover");
+
+	if (!drogueSeparated)
+	{
+		if (CapsuleVersion == CAPSULEBIGJOE) debris.Prewarm("ProjectMercury\\Mercury_AntennaBJ");
+		else if (CapsuleVersion == CAPSULELITTLEJOE) debris.Prewarm("ProjectMercury\\Mercury_AntennaLJ");
+		else if (CapsuleVersion == CAPSULEBD) debris.Prewarm("ProjectMercury\\Mercury_AntennaBD");
+		else debris.Prewarm("ProjectMercury\\Mercury_Antenna");
+	}
+
+	if (!mainChuteSeparated || !reserveChuteSeparated)
+		debris.Prewarm("ProjectMercury\\Mercury_Chute");
+}
+
+// Queue an action to be performed as soon as possible
+inline void ProjectMercury::QueueAction(int action)
+{
+	QueueActionAt(action, oapiGetSimTime());
+}
+
+// Queue an action to be performed at given simt. If already queued, the earliest time is kept
+inline void ProjectMercury::QueueActionAt(int action, double time)
+{
+	for (int i = 0; i < actionQueueNum; i++)
+	{
+		if (actionQueue[i].action == action)
+		{
+			if (time >= actionQueue[i].time)
+				return;
+
+			// Remove it, and insert again below with the earlier time
+			for (int j = i; j < actionQueueNum - 1; j++)
+				actionQueue[j] = actionQueue[j + 1];
+			actionQueueNum -= 1;
+			break;
+		}
+	}
+
+	if (actionQueueNum >= MAX_QUEUED_ACTIONS)
+	{
+		oapiWriteLogV("Action queue full. Dropped action %i", action);
+		return;
+	}
+
+	// Keep sorted by time, and then by action (the order of the old else-if chain)
+	int index = actionQueueNum;
+	while (index > 0 && (actionQueue[index - 1].time > time || (actionQueue[index - 1].time == time && actionQueue[index - 1].action > action)))
+	{
+		actionQueue[index] = actionQueue[index - 1];
+		index -= 1;
+	}
+	actionQueue[index].action = action;
+	actionQueue[index].time = time;
+	actionQueueNum += 1;
+}
+
+// Perform every action that is due, in order. Previously only one action was performed per timestep, which at high
+// time acceleration could delay events by several long steps
+inline void ProjectMercury::ProcessActionQueue(double simt, double simdt)
+{
+	int performed = 0;
+	while (actionQueueNum > 0 && actionQueue[0].time <= simt && performed < 2 * MAX_QUEUED_ACTIONS) // guard in case an action keeps queueing itself
+	{
+		int action = actionQueue[0].action;
+		for (int i = 0; i < actionQueueNum - 1; i++)
+			actionQueue[i] = actionQueue[i + 1];
+		actionQueueNum -= 1;
+
+		PerformAction(action); // may queue new actions, which are then performed in the same step if due
+		performed += 1;
+	}
+
+	if (!actionWarpReduction)
+		return;
+
+	// Warp reduction near actions. Orbiter doesn't let us shorten the current step, so an action is still performed at the end
+	// of the step it falls in. But we can lower the time acceleration so that the next steps are short when an action is coming up.
+	// Only ever lowers it. The old value is restored when no action is near, unless the user has changed it in the meantime
+	double warp = oapiGetTimeAcceleration();
+	if (actionWarpRestore != 0.0 && fabs(warp - actionWarpSet) > 1e-6 * actionWarpSet)
+		actionWarpRestore = 0.0; // user has taken over
+
+	if (actionQueueNum > 0 && actionQueue[0].time - simt < simdt && warp > 1.0)
+	{
+		if (actionWarpRestore == 0.0) actionWarpRestore = warp;
+		actionWarpSet = max(1.0, warp * (actionQueue[0].time - simt) / simdt);
+		oapiSetTimeAcceleration(actionWarpSet);
+	}
+	else if (actionWarpRestore != 0.0 && (actionQueueNum == 0 || actionQueue[0].time - simt > simdt * actionWarpRestore / warp))
+	{
+		oapiSetTimeAcceleration(actionWarpRestore);
+		actionWarpRestore = 0.0;
+	}
+}
+
 // Control every attitude setting, from ASCS norm, to aux damp, to fly-by-wire, to rate command, to fully manual
 inline void ProjectMercury::CapsuleAttitudeControl(double simt, double simdt)
 {
@@ -2124,7 +2177,7 @@ inline void ProjectMercury::CapsuleAttitudeControl(double simt, double simdt)
 			// Why have I commented this out? I did this several months ago, but now (Feb. 2021) I have no idea. Now I know (five minutes later): I've moved it to CapsuleGenericTimestep inside the engageRetro loop
 			//if (engageRetro && simt - retroStartTime > 60.0 && switchAutoRetroJet == -1) // both for suborbital and orbital missions (19640056774 page 12 and doi:10.1002/j.2161-4296.1962.tb02524.x page 2)
 			//{
-			//	prepareReentryAction = true;
+			//	QueueAction(ACTION_PREPAREREENTRY);
 			//	AutopilotStatus = REENTRYATT;
 			//}
 		}
@@ -2153,9 +2206,7 @@ inline void ProjectMercury::CapsuleAttitudeControl(double simt, double simdt)
 					if (lowGHeading < 0.0) lowGHeading += PI2;
 					else if (lowGHeading > PI2) lowGHeading -= PI2;
 
-					char cbuf[256];
-					sprintf(cbuf, "0.05 G trigger at T+%.0f. Entry angle: %.3f deg. Entry velocity %.2f m/s. Altitude %.0f m. Angle to target base %.3f deg", simt - launchTime, entryAng, length(entryVel), length(entryLoc) - oapiGetSize(GetSurfaceRef()), entryAngleToBase * DEG);
-					oapiWriteLog(cbuf);
+					MLOG_INFO("0.05 G trigger at T+%.0f. Entry angle: %.3f deg. Entry velocity %.2f m/s. Altitude %.0f m. Angle to target base %.3f deg", simt - launchTime, entryAng, length(entryVel), length(entryLoc) - oapiGetSize(GetSurfaceRef()), entryAngleToBase * DEG);
 					DisableAutopilot(false); // disable stuck thrusters
 					AutopilotStatus = LOWG;
 				}
@@ -2417,13 +2468,114 @@ inline void ProjectMercury::FlyByWireControlSingleDirection(double thrustLevel,
 	}
 }
 
+// Read everything the HUD, panel and retro calculations need in one go. Called first thing in clbkPreStep, and in clbkPostCreation so that it's valid also if we start paused.
+inline void ProjectMercury::UpdateFlightState(double simt)
+{
+	FLIGHTSTATE* fs = &flightState;
+
+	fs->simt = simt;
+	fs->ref = GetEquPos(fs->longitude, fs->latitude, fs->radius);
+	if (fs->ref == NULL) fs->ref = GetSurfaceRef();
+	fs->refSize = oapiGetSize(fs->ref);
+	fs->refMass = oapiGetMass(fs->ref);
+	fs->refPeriod = oapiGetPlanetPeriod(fs->ref);
+	fs->altitude = GetAltitude();
+
+	fs->pitch = GetPitch();
+	fs->bank = GetBank();
+	fs->slip = GetSlipAngle();
+	GetAngularVel(fs->angVel);
+
+	GetAirspeedVector(FRAME_HORIZON, fs->airspeedHorizon);
+	GetGroundspeedVector(FRAME_HORIZON, fs->groundspeedHorizon);
+	GetRelativePos(fs->ref, fs->relPos);
+	GetRelativeVel(fs->ref, fs->relVel);
+	fs->atmPressure = GetAtmPressure();
+
+	// there's a pesky crash if one checks for propellant level of a non-created propellant source
+	fs->fuelAuto = (fuel_auto != NULL) ? GetPropellantMass(fuel_auto) : 0.0;
+	fs->fuelManual = (fuel_manual != NULL) ? GetPropellantMass(fuel_manual) : 0.0;
+
+	GetElements(fs->ref, fs->el, &fs->prm, 0.0, FRAME_EQU);
+
+	fs->valid = true;
+}
+
+// One sample for the flight recorder, in REC_CHANNELS order. Called from clbkPostStep, so the state is read here
+// and not taken from flightState, which is from before the step. Only at RecorderRate, so the extra calls don't matter
+inline void ProjectMercury::RecordFlightData(double simt)
+{
+	double values[REC_MAX_VALUES];
+	int n = 0;
+	unsigned int channels = recorder.Channels();
+
+	if (channels & REC_STATE)
+	{
+		OBJHANDLE ref = GetSurfaceRef();
+		VECTOR3 relPos, relVel;
+		GetRelativePos(ref, relPos);
+		GetRelativeVel(ref, relVel);
+		values[n++] = relPos.x;
+		values[n++] = relPos.y;
+		values[n++] = relPos.z;
+		values[n++] = relVel.x;
+		values[n++] = relVel.y;
+		values[n++] = relVel.z;
+		values[n++] = GetAltitude();
+	}
+
+	if (channels & REC_ATTITUDE)
+	{
+		VECTOR3 angVel;
+		GetAngularVel(angVel);
+		values[n++] = GetPitch() * DEG;
+		values[n++] = GetBank() * DEG;
+		values[n++] = GetSlipAngle() * DEG;
+		values[n++] = angVel.x * DEG;
+		values[n++] = angVel.y * DEG;
+		values[n++] = angVel.z * DEG;
+	}
+
+	if (channels & REC_THRUSTERS)
+	{
+		values[n++] = GetThrusterGroupLevel(THGROUP_MAIN);
+		values[n++] = GetThrusterGroupLevel(THGROUP_RETRO);
+		values[n++] = GetThrusterGroupLevel(THGROUP_ATT_PITCHUP);
+		values[n++] = GetThrusterGroupLevel(THGROUP_ATT_PITCHDOWN);
+		values[n++] = GetThrusterGroupLevel(THGROUP_ATT_YAWLEFT);
+		values[n++] = GetThrusterGroupLevel(THGROUP_ATT_YAWRIGHT);
+		values[n++] = GetThrusterGroupLevel(THGROUP_ATT_BANKLEFT);
+		values[n++] = GetThrusterGroupLevel(THGROUP_ATT_BANKRIGHT);
+	}
+
+	if (channels & REC_GLOAD)
+	{
+		values[n++] = vesselAcceleration / G;
+	}
+
+	if (channels & REC_STATUS)
+	{
+		values[n++] = (double)VesselStatus;
+		values[n++] = (double)AutopilotStatus;
+	}
+
+	if (channels & REC_FUEL)
+	{
+		values[n++] = (fuel_auto != NULL) ? GetPropellantMass(fuel_auto) : 0.0;
+		values[n++] = (fuel_manual != NULL) ? GetPropellantMass(fuel_manual) : 0.0;
+		values[n++] = GetTotalPropellantMass();
+	}
+
+	recorder.Push(simt, values);
+}
+
 // This function always runs every timestep, from clbkPostStep.
 inline void ProjectMercury::MercuryCapsuleGenericTimestep(double simt, double simdt, double latit, double longit, double getAlt)
 {
 	// Check if we're in contact with a base. This is used for hiding MFDs, radio sounds, retrotime calculations and more.
 	OBJHANDLE planetRef = oapiGetGbodyByName("Earth");
 	if (planetRef == NULL) planetRef = GetSurfaceRef();
-	radioContact = InRadioContact(planetRef);
+	radioContact = PredictedRadioContact(planetRef, simt); // only loops through bases when needed
 
 	// If we're in panel mode with 2D panel, then animate. Note that oapiCameraInternal only gives true if in focus object, so first condition is not necessary, but better safe than sorry, especially considering potential later Orbiter verion changing it.
 	if (oapiGetFocusObject() == GetHandle() && oapiCameraInternal() && oapiCockpitMode() == COCKPIT_PANELS && panelView)
@@ -2448,6 +2600,8 @@ inline void ProjectMercury::MercuryCapsuleGenericTimestep(double simt, double si
 	if (longitudinalAcc > maxVesselAcceleration) maxVesselAcceleration = longitudinalAcc;
 	if (longitudinalAcc < minVesselAcceleration) minVesselAcceleration = longitudinalAcc;
 
+	if (recorder.Due(simt)) RecordFlightData(simt);
+
 	// Retrosequence
 	if (engageRetro && simt > retroStartTime && VesselStatus == FLIGHT) // firing starts 30 sec after retrosequence start
 	{
@@ -2463,10 +2617,10 @@ inline void ProjectMercury::MercuryCapsuleGenericTimestep(double simt, double si
 			}
 		}
 
-		if (simt > retroStartTime + 60.0 && switchAutoRetroJet == -1) // both for suborbital and orbital missions (19640056774 page 12 and doi:10.1002/j.2161-4296.1962.tb02524.x page 2)
+		if (simt + simdt > retroStartTime + 60.0 && switchAutoRetroJet == -1) // both for suborbital and orbital missions (19640056774 page 12 and doi:10.1002/j.2161-4296.1962.tb02524.x page 2)
 		{
-			prepareReentryAction = true;
-			AutopilotStatus = REENTRYATTITUDE;
+			QueueActionAt(ACTION_PREPAREREENTRY, retroStartTime + 60.0); // queued one step ahead, so that it can land at the right time
+			if (simt > retroStartTime + 60.0) AutopilotStatus = REENTRYATTITUDE;
 		}
 	}
 
@@ -2479,7 +2633,7 @@ inline void ProjectMercury::MercuryCapsuleGenericTimestep(double simt, double si
 		
 		if (!retroCoverSeparated[retroErrorNum] && RETRO_THRUST_LEVEL[retroErrorNum] > 0.0)
 		{
-			separateRetroCoverAction[retroErrorNum] = true;
+			QueueAction(ACTION_SEPARATERETROCOVER1 + retroErrorNum);
 		}
 	}
 
@@ -2488,7 +2642,7 @@ inline void ProjectMercury::MercuryCapsuleGenericTimestep(double simt, double si
 	if (VesselStatus == FLIGHT && ReentryStresses > 1e6) // roughly five minutes before drogue opening, as indicated by MA6 transscript (~85 km)
 	{
 		oapiWriteLog("High dynamic stress seperate retro");
-		prepareReentryAction = true;
+		QueueAction(ACTION_PREPAREREENTRY);
 	}
 
 	if (engageFuelDump)
@@ -2499,31 +2653,24 @@ inline void ProjectMercury::MercuryCapsuleGenericTimestep(double simt, double si
 	// Deploy drogue
 	if (VesselStatus == REENTRY && GetAtmPressure() > 44700.0 && !drogueDeployed && simt - towerJetTime > 3.0) // below 2.1e4 feet. Chutes deployed no less than 3 sec after towerJett (19630012071 page 269)
 	{
-		char cbuf[256];
-
 		double angleCovered = oapiOrthodome(longit, latit, lowGLong, lowGLat);
 
-		sprintf(cbuf, "Drogue deployed at %.2f ft. Angle covered since 0.05 G is %.3f deg", getAlt / 0.3048, angleCovered * DEG);
-		oapiWriteLog(cbuf);
+		MLOG_INFO("Drogue deployed at %.2f ft. Angle covered since 0.05 G is %.3f deg", getAlt / 0.3048, angleCovered * DEG);
 
-		// Debug
-		std::ofstream outfile;
-		outfile.open("MercuryEntryLog.txt", std::ios_base::app); // app = append
-		outfile << entryAng << " , " << length(entryVel) << " , " << (length(entryLoc) - oapiGetSize(GetSurfaceRef())) << " , " << (entryAngleToBase * DEG) << " , " << (angleCovered * DEG) << " , " << (lowGLat * DEG) << " , " << (lowGHeading * DEG) << "\n";
-		// eAng, eVel, eAlt, ang to targ base, angle covered during reentry, eLat, eHead
+		// Entry summary, previously appended to MercuryEntryLog.txt. The whole entry is in the flight recorder
+		oapiWriteLogV("Entry: angle %f, vel %f, alt %f, angle to target base %f, angle covered %f, lat %f, heading %f",
+			entryAng, length(entryVel), length(entryLoc) - oapiGetSize(GetSurfaceRef()), entryAngleToBase * DEG, angleCovered * DEG, lowGLat * DEG, lowGHeading * DEG);
 
-		separateDrogueCoverAction = true;
+		QueueAction(ACTION_SEPARATEDROGUECOVER);
 		DeployDrogue();
 	}
 	else if (VesselStatus == REENTRY && GetAtmPressure() > 69700.0 && drogueDeployed && simt - drogueDeployTime > 2.0)
 	{
-		separateDrogueAction = true;
+		QueueAction(ACTION_SEPARATEDROGUE);
 	}
 	else if (VesselStatus == REENTRYNODROGUE && GetAtmPressure() > 69700.0 && simt - towerJetTime > 3.0 && !mainChuteDeployed && simt - drogueDeployTime > 2.0) // below 1e4 feet
 	{
-		char cbuf[256];
-		sprintf(cbuf, "Main deployed at %.2f ft", getAlt / 0.3048);
-		oapiWriteLog(cbuf);
+		MLOG_INFO("Main deployed at %.2f ft", getAlt / 0.3048);
 		DeployMainChute();
 	}
 	else if (!landingBagDeployed && mainChuteDeployed && simt - mainChuteDeployTime > 12.0)
@@ -2544,6 +2691,9 @@ inline void ProjectMercury::MercuryCapsuleGenericTimestep(double simt, double si
 	if (currentSpaceSpeed > historyMaxSpaceSpeed)
 		historyMaxSpaceSpeed = currentSpaceSpeed;
 
+	double historyValues[HIST_NUM_CHANNELS] = { getAlt, vesselAcceleration / G, currentSpaceSpeed, GetGroundspeed() }; // HIST_CHANNEL_NAMES order
+	flightHistory.Add(simt, historyValues);
+
 	if ((VesselStatus == LAUNCH || VesselStatus == TOWERSEP || VesselStatus == ABORTNORETRO) && GroundContact() && GetAttachmentStatus(padAttach) == NULL && (GetFuelMass() / GetPropellantMaxMass(GetDefaultPropellantResource())) > 0.9) // TOWERSEP is to catch a Big Joe scenario, ABORTNORETRO is to cactch a Beach Abort scenario. Fuel mass check is to ensure that we are loaded, used to catch MR-BD, which lands in same state as it launches, and therefore would overwrite launchCoord
 	{
 		historyLaunchLong = longit;
@@ -2574,14 +2724,12 @@ inline void ProjectMercury::MercuryCapsuleGenericTimestep(double simt, double si
 	if (VesselStatus == REENTRY && (!OrbiterSoundLowGPlayed || !OrbiterSoundLowG10secPlayed) && radioContact)
 	{
 		// Entry interface at altitude 87 550 m
-		OBJHANDLE refPlanet = GetSurfaceRef();
-		double planetRad = oapiGetSize(refPlanet);
+		double planetRad = flightState.refSize;
 		double entryRadius = 87550.0 + planetRad; // 70568, 70430, 70544, 70342, 70287, 70181, 70503, 70409, 70567
 		if (suborbitalMission) entryRadius = 70500.0 + planetRad; // between 70.2 and 70.6 km for regular Redstone mission, but as we're moving down at 1 km/s, we don't need precission for a fairly accurate time.
 
-		ELEMENTS el;
-		ORBITPARAM prm;
-		GetElements(refPlanet, el, &prm, 0.0, FRAME_EQU);
+		ELEMENTS el = flightState.el;
+		ORBITPARAM prm = flightState.prm;
 		double postBurnPer = prm.T;
 		double postBurnEcc = el.e;
 		double postBurnTrA = prm.TrA;
@@ -2590,8 +2738,7 @@ inline void ProjectMercury::MercuryCapsuleGenericTimestep(double simt, double si
 		double postBurnSMa = el.a;
 		double postBurnInc = el.i;
 		double postBurnMnA = TrA2MnA(postBurnTrA, postBurnEcc);
-		double longAtRetro, latAtRetro, radAtRetro;
-		GetEquPos(longAtRetro, latAtRetro, radAtRetro);
+		double longAtRetro = flightState.longitude, latAtRetro = flightState.latitude, radAtRetro = flightState.radius;
 
 		if (abs((el.a / entryRadius * (1.0 - el.e * el.e) - 1.0) / el.e) > 1.0 || prm.TrA < PI)
 		{
@@ -2716,28 +2863,23 @@ inline void ProjectMercury::WriteHUDAutoFlightReentry(oapi::Sketchpad* skp, doub
 	{
 		if (switchASCSMode == -1 && switchControlMode == -1 && AutopilotStatus == POSIGRADEDAMP)
 		{
-			sprintf(cbuf, "Capsule turnaround in %.2f s", 5.0 + posigradeDampingTime - simt);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Capsule turnaround in %.2f s", 5.0 + posigradeDampingTime - simt);
 			yIndex += 1;
 		}
 		else if (switchASCSMode == -1 && switchControlMode == -1 && AutopilotStatus == TURNAROUND)
 		{
-			sprintf(cbuf, "Hold retro attitude");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Hold retro attitude");
 			yIndex += 1;
 
-			sprintf(cbuf, "  P: %.1f\u00B0, Y: %.1f\u00B0, R: %.1f\u00B0", NormAngleDeg(GetPitch() * DEG + pitchOffset * DEG), NormAngleDeg(GetSlipAngle() * DEG + yawOffset * DEG), NormAngleDeg(GetBank() * DEG + rollOffset * DEG));
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  P: %.1f\u00B0, Y: %.1f\u00B0, R: %.1f\u00B0", NormAngleDeg((flightState.pitch + pitchOffset) * DEG), NormAngleDeg((flightState.slip + yawOffset) * DEG), NormAngleDeg((flightState.bank + rollOffset) * DEG));
 			yIndex += 1;
 		}
 		else if (switchASCSMode == -1 && switchControlMode == -1 && AutopilotStatus == ORBITATTITUDE)
 		{
-			sprintf(cbuf, "Holding retro attitude");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Holding retro attitude");
 			yIndex += 1;
 
-			sprintf(cbuf, "  P: %.1f\u00B0, Y: %.1f\u00B0, R: %.1f\u00B0", NormAngleDeg(GetPitch() * DEG + pitchOffset * DEG), NormAngleDeg(GetSlipAngle() * DEG + yawOffset * DEG), NormAngleDeg(GetBank() * DEG + rollOffset * DEG));
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  P: %.1f\u00B0, Y: %.1f\u00B0, R: %.1f\u00B0", NormAngleDeg((flightState.pitch + pitchOffset) * DEG), NormAngleDeg((flightState.slip + yawOffset) * DEG), NormAngleDeg((flightState.bank + rollOffset) * DEG));
 			yIndex += 1;
 		}
 
@@ -2745,35 +2887,30 @@ inline void ProjectMercury::WriteHUDAutoFlightReentry(oapi::Sketchpad* skp, doub
 		{
 			if (GetThrusterLevel(thruster_retro[0]) != 0.0)
 			{
-				sprintf(cbuf, "  Retro 1 BURNING");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  Retro 1 BURNING");
 				yIndex += 1;
 			}
 
 			if (GetThrusterLevel(thruster_retro[1]) != 0.0)
 			{
-				sprintf(cbuf, "  Retro 2 BURNING");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  Retro 2 BURNING");
 				yIndex += 1;
 			}
 
 			if (GetThrusterLevel(thruster_retro[2]) != 0.0)
 			{
-				sprintf(cbuf, "  Retro 3 BURNING");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  Retro 3 BURNING");
 				yIndex += 1;
 			}
 
 			if (simt - retroStartTime < 0.0)
 			{
-				sprintf(cbuf, "Retrofire in %.1f s", retroStartTime - simt);
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Retrofire in %.1f s", retroStartTime - simt);
 				yIndex += 1;
 			}
 			else
 			{
-				sprintf(cbuf, "Awaiting retropack separation in %.1f s", 60.0 + retroStartTime - simt);
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Awaiting retropack separation in %.1f s", 60.0 + retroStartTime - simt);
 				yIndex += 1;
 			}
 		}
@@ -2782,24 +2919,18 @@ inline void ProjectMercury::WriteHUDAutoFlightReentry(oapi::Sketchpad* skp, doub
 	{
 		if (AutopilotStatus == REENTRYATTITUDE)
 		{
-			sprintf(cbuf, "Holding reentry pitch:");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Holding reentry pitch:");
 			yIndex += 1;
 
-			sprintf(cbuf, "  %.1f\u00B0, %.1f\u00B0, %.1f\u00B0", NormAngleDeg(GetPitch() * DEG + pitchOffset * DEG), NormAngleDeg(GetSlipAngle() * DEG + yawOffset * DEG), NormAngleDeg(GetBank() * DEG + rollOffset * DEG));
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  %.1f\u00B0, %.1f\u00B0, %.1f\u00B0", NormAngleDeg((flightState.pitch + pitchOffset) * DEG), NormAngleDeg((flightState.slip + yawOffset) * DEG), NormAngleDeg((flightState.bank + rollOffset) * DEG));
 			yIndex += 1;
 
-			sprintf(cbuf, "Awaiting 0.05 G sensor");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Awaiting 0.05 G sensor");
 			yIndex += 1;
 		}
 		else if (AutopilotStatus == LOWG)
 		{
-			VECTOR3 angVel;
-			GetAngularVel(angVel);
-			sprintf(cbuf, "Holding reentry roll: %.2f\u00B0/s", angVel.z * DEG);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Holding reentry roll: %.2f\u00B0/s", flightState.angVel.z * DEG);
 			yIndex += 1;
 		}
 	}
@@ -2819,23 +2950,20 @@ inline void ProjectMercury::WriteHUDIndicators(oapi::Sketchpad* skp, double simt
 	// ABORT
 	if (abort) skp->SetTextColor(Red);
 	else skp->SetTextColor(Gray);
-	sprintf(cbuf, "ABORT");
-	skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+	hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "ABORT");
 	yIndex += 1;
 
 	// JETT TOWER
 	if (towerJettisoned) skp->SetTextColor(Green); // I don't implement any failures of tower sep, so don't implement any failure light. This may change when fuses are added
 	else skp->SetTextColor(Gray);
-	sprintf(cbuf, "JETT TOWER");
-	skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+	hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "JETT TOWER");
 	yIndex += 1;
 
 	// SEP CAPSULE
 	if (VesselStatus == FLIGHT || VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE || VesselStatus == ABORT || VesselStatus == ABORTNORETRO) skp->SetTextColor(Green);
 	else if (boosterShutdownTime == 0.0) skp->SetTextColor(Gray); // time between shutdown and sep is red, so gray if not shutdown yet
 	else skp->SetTextColor(Red);
-	sprintf(cbuf, "SEP CAPSULE");
-	skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+	hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "SEP CAPSULE");
 	yIndex += 1;
 
 	// RETRO SEQ
@@ -2843,20 +2971,18 @@ inline void ProjectMercury::WriteHUDIndicators(oapi::Sketchpad* skp, double simt
 	else if (retroStartTime == 0.0) skp->SetTextColor(Gray); // uninitialised
 	else if (VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE || VesselStatus == ABORTNORETRO) skp->SetTextColor(Gray);
 	else skp->SetTextColor(Red);
-	sprintf(cbuf, "RETRO SEQ");
-	skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+	hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "RETRO SEQ");
 	yIndex += 1;
 
 	// RETRO ATT
-	double currP = GetPitch() + pitchOffset;
-	double currY = GetSlipAngle() + yawOffset;
-	double currR = GetBank() + rollOffset;
+	double currP = flightState.pitch + pitchOffset;
+	double currY = flightState.slip + yawOffset;
+	double currR = flightState.bank + rollOffset;
 	if (engageRetro && abs(currP + 34.0 * RAD) < 12.5 * RAD && abs(normangle(currY + PI)) < 30.0 * RAD && abs(currR) < 30.0 * RAD) skp->SetTextColor(Green); // within limits, Familiarization page 229
 	else if (retroStartTime == 0.0) skp->SetTextColor(Gray); // haven't engaged retro
 	else if (VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE || VesselStatus == ABORTNORETRO) skp->SetTextColor(Gray);
 	else skp->SetTextColor(Red);
-	sprintf(cbuf, "RETRO ATT");
-	skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+	hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "RETRO ATT");
 	yIndex += 1;
 
 	// FIRE RETRO
@@ -2866,8 +2992,7 @@ inline void ProjectMercury::WriteHUDIndicators(oapi::Sketchpad* skp, double simt
 	else if (retroStartTime != 0.0 && retroStartTime - 15.0 < simt) skp->SetTextColor(Red); // red 15 sec before retrofire
 	else if (VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE || VesselStatus == ABORTNORETRO) skp->SetTextColor(Green); // green until LOWG
 	else skp->SetTextColor(Gray);
-	sprintf(cbuf, "FIRE RETRO");
-	skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+	hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "FIRE RETRO");
 	yIndex += 1;
 
 	// JETT RETRO
@@ -2875,8 +3000,7 @@ inline void ProjectMercury::WriteHUDIndicators(oapi::Sketchpad* skp, double simt
 	else if (VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE || VesselStatus == ABORTNORETRO) skp->SetTextColor(Green); // Green until LOWG
 	else if (retroStartTime != 0.0 && retroStartTime - 28.0 < simt) skp->SetTextColor(Red);
 	else skp->SetTextColor(Gray);
-	sprintf(cbuf, "JETT RETRO");
-	skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+	hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "JETT RETRO");
 	yIndex += 1;
 
 	// RETRACT SCOPE
@@ -2884,24 +3008,21 @@ inline void ProjectMercury::WriteHUDIndicators(oapi::Sketchpad* skp, double simt
 	else if (PeriscopeStatus != P_CLOSED && (VesselStatus == FLIGHT || VesselStatus == REENTRYNODROGUE || (VesselStatus == LAUNCH && GroundContact()))) skp->SetTextColor(Green);
 	else if (PeriscopeStatus == P_CLOSED) skp->SetTextColor(Gray);
 	else skp->SetTextColor(Red);
-	sprintf(cbuf, "RETRACT SCOPE");
-	skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+	hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "RETRACT SCOPE");
 	yIndex += 1;
 
 	// .05 G
 	if (FailureMode != LOWGDEACTIVE && VesselStatus == REENTRY && vesselAcceleration > 0.05 * G) skp->SetTextColor(Green);
 	else if (AutopilotStatus == LOWG) skp->SetTextColor(Green);
 	else skp->SetTextColor(Gray);
-	sprintf(cbuf, ".05 G");
-	skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+	hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, ".05 G");
 	yIndex += 1;
 
 	// MAIN
 	if (mainChuteDeployed && simt > mainChuteDeployTime + 2.0) skp->SetTextColor(Green);
 	else if (!mainChuteDeployed) skp->SetTextColor(Gray);
 	else skp->SetTextColor(Red);
-	sprintf(cbuf, "MAIN");
-	skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+	hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "MAIN");
 	yIndex += 1;
 
 	// LANDING BAG
@@ -2909,13 +3030,12 @@ inline void ProjectMercury::WriteHUDIndicators(oapi::Sketchpad* skp, double simt
 	else if (mainChuteDeployed && simt - mainChuteDeployTime > 10.0) skp->SetTextColor(Red);
 	else if (!landingBagDeployed) skp->SetTextColor(Gray);
 	else skp->SetTextColor(Red);
-	sprintf(cbuf, "LANDING BAG");
-	skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+	hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "LANDING BAG");
 	yIndex += 1;
 
 	// FUEL QUAN
-	double autoLevel = GetPropellantMass(fuel_auto) / MERCURY_FUEL_MASS_AUTO;
-	double manualLevel = GetPropellantMass(fuel_manual) / MERCURY_FUEL_MASS_MAN;
+	double autoLevel = flightState.fuelAuto / MERCURY_FUEL_MASS_AUTO;
+	double manualLevel = flightState.fuelManual / MERCURY_FUEL_MASS_MAN;
 	//if (!attitudeFuelAuto) // swap (just how I've defined it)
 	//{
 	//	autoLevel = GetPropellantMass(fuel_manual) / MERCURY_FUEL_MASS_AUTO;
@@ -2923,21 +3043,477 @@ inline void ProjectMercury::WriteHUDIndicators(oapi::Sketchpad* skp, double simt
 	//}
 	if (autoLevel < 0.65 || manualLevel < 0.65) skp->SetTextColor(Red);
 	else skp->SetTextColor(Gray);
-	sprintf(cbuf, "FUEL QUAN");
-	skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+	hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "FUEL QUAN");
 	yIndex += 1;
 
 	// RETRO WARN
 	if (VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE) skp->SetTextColor(Gray);
 	else if (retroWarnLight) skp->SetTextColor(Red);
 	else skp->SetTextColor(Gray);
-	sprintf(cbuf, "RETRO WARN");
-	skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+	hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "RETRO WARN");
 	yIndex += 1;
 
 	*yIndexUpdate = yIndex;
 }
 
+// ==============================================================
+//		Scenario keywords
+//
+// Each module lists its keywords in ScenarioKeys, in the order they are saved. clbkLoadStateEx and clbkSaveState both
+// run through that table. On load the whole first word of the line is looked up (binary search in a sorted index),
+// so there are no more prefix collisions where e.g. MET would catch any line starting with MET, and the order of the
+// list doesn't matter.
+// ==============================================================
+
+const enum SCENARIO_TYPE { SCN_INT, SCN_BOOL, SCN_DOUBLE, SCN_FLAG, SCN_SPECIAL, SCN_SIMTIME };
+const enum SCENARIO_SPECIAL { SCN_STATE, SCN_CAPSULE, SCN_AUTOMODE, SCN_MET, SCN_ORBITNR, SCN_FAILURE, SCN_REPLACETEXTURE,
+SCN_HOLDTIME, SCN_BECOTIME, SCN_HIGHROLLLIMIT, SCN_INCLINATION, SCN_APOGEE, SCN_MISSIONLANDLONG, SCN_MISSILESPEED,
+SCN_CONCEPTATTACHED, SCN_CONCEPTCOVER, SCN_SPEEDLIMIT, SCN_CHECKPOINT
+};
+const int MAX_SCENARIO_KEYS = 64;
+
+struct SCENARIOKEY
+{
+	const char* key;
+	int type; // SCENARIO_TYPE
+	int special; // SCENARIO_SPECIAL, handled in LoadScenarioSpecial / SaveScenarioSpecial
+	int ProjectMercury::* i;
+	bool ProjectMercury::* b; // also used for SCN_FLAG, which is set if the keyword is present
+	double ProjectMercury::* d; // also used for SCN_SIMTIME, a simt of an event (0.0 if not happened), saved relative to the save time in checkpoints
+	bool save; // written by clbkSaveState
+};
+
+inline SCENARIOKEY ScenarioInt(const char* key, int ProjectMercury::* field, bool save)
+{
+	SCENARIOKEY k = { key, SCN_INT, 0, field, NULL, NULL, save };
+	return k;
+}
+
+inline SCENARIOKEY ScenarioBool(const char* key, bool ProjectMercury::* field, bool save)
+{
+	SCENARIOKEY k = { key, SCN_BOOL, 0, NULL, field, NULL, save };
+	return k;
+}
+
+inline SCENARIOKEY ScenarioDouble(const char* key, double ProjectMercury::* field, bool save)
+{
+	SCENARIOKEY k = { key, SCN_DOUBLE, 0, NULL, NULL, field, save };
+	return k;
+}
+
+inline SCENARIOKEY ScenarioSimTime(const char* key, double ProjectMercury::* field, bool save)
+{
+	SCENARIOKEY k = { key, SCN_SIMTIME, 0, NULL, NULL, field, save };
+	return k;
+}
+
+inline SCENARIOKEY ScenarioFlag(const char* key, bool ProjectMercury::* field, bool save)
+{
+	SCENARIOKEY k = { key, SCN_FLAG, 0, NULL, field, NULL, save };
+	return k;
+}
+
+inline SCENARIOKEY ScenarioSpecial(const char* key, int special, bool save)
+{
+	SCENARIOKEY k = { key, SCN_SPECIAL, special, NULL, NULL, NULL, save };
+	return k;
+}
+
+// Compare the first len chars of a scenario line with a keyword, case insensitive. Same order as _stricmp.
+inline int ScenarioKeyCompare(const char* word, int len, const char* key)
+{
+	int c = _strnicmp(word, key, len);
+	if (c != 0) return c;
+	return (key[len] == '\0') ? 0 : -1; // word is only a prefix of key
+}
+
+inline void ProjectMercury::LoadScenarioKeys(FILEHANDLE scn, void* status)
+{
+	int numKeys;
+	const SCENARIOKEY* keys = ScenarioKeys(&numKeys);
+
+	// Sorted index into keys, made once
+	static int sorted[MAX_SCENARIO_KEYS];
+	static int numSorted = 0;
+	if (numSorted == 0)
+	{
+		if (numKeys > MAX_SCENARIO_KEYS)
+		{
+			oapiWriteLogV("Too many scenario keywords (%i), increase MAX_SCENARIO_KEYS", numKeys);
+			numKeys = MAX_SCENARIO_KEYS;
+		}
+
+		for (int n = 0; n < numKeys; n++)
+		{
+			int j = n;
+			while (j > 0 && _stricmp(keys[sorted[j - 1]].key, keys[n].key) > 0)
+			{
+				sorted[j] = sorted[j - 1];
+				j--;
+			}
+			sorted[j] = n;
+		}
+		numSorted = numKeys;
+	}
+
+	char* cbuf;
+	while (oapiReadScenario_nextline(scn, cbuf))
+	{
+		int len = 0;
+		while (cbuf[len] != '\0' && cbuf[len] != ' ' && cbuf[len] != '\t') len++;
+		const char* value = cbuf + len;
+		while (*value == ' ' || *value == '\t') value++;
+
+		const SCENARIOKEY* key = NULL;
+		int low = 0, high = numSorted - 1;
+		while (low <= high)
+		{
+			int mid = (low + high) / 2;
+			int c = ScenarioKeyCompare(cbuf, len, keys[sorted[mid]].key);
+			if (c == 0)
+			{
+				key = &keys[sorted[mid]];
+				break;
+			}
+			else if (c < 0) high = mid - 1;
+			else low = mid + 1;
+		}
+
+		if (key == NULL)
+		{
+			ParseScenarioLineEx(cbuf, status);
+			continue;
+		}
+
+		switch (key->type)
+		{
+		case SCN_INT:
+			this->*(key->i) = atoi(value);
+			break;
+		case SCN_BOOL:
+			this->*(key->b) = (atoi(value) != 0);
+			break;
+		case SCN_DOUBLE:
+		case SCN_SIMTIME:
+			this->*(key->d) = atof(value);
+			break;
+		case SCN_FLAG:
+			this->*(key->b) = true;
+			break;
+		case SCN_SPECIAL:
+			LoadScenarioSpecial(key->special, value);
+			break;
+		}
+	}
+}
+
+inline void ProjectMercury::SaveScenarioKeys(FILEHANDLE scn)
+{
+	int numKeys;
+	const SCENARIOKEY* keys = ScenarioKeys(&numKeys);
+
+	for (int n = 0; n < numKeys; n++)
+	{
+		const SCENARIOKEY* key = &keys[n];
+		if (!key->save)
+			continue;
+
+		switch (key->type)
+		{
+		case SCN_INT:
+			oapiWriteScenario_int(scn, (char*)key->key, this->*(key->i));
+			break;
+		case SCN_BOOL:
+			oapiWriteScenario_int(scn, (char*)key->key, (int)(this->*(key->b)));
+			break;
+		case SCN_DOUBLE:
+		case SCN_SIMTIME:
+			oapiWriteScenario_float(scn, (char*)key->key, this->*(key->d));
+			break;
+		case SCN_FLAG:
+			if (this->*(key->b)) oapiWriteScenario_string(scn, (char*)key->key, "");
+			break;
+		case SCN_SPECIAL:
+			SaveScenarioSpecial(scn, key->special, key->key);
+			break;
+		}
+	}
+}
+
+// Keywords that need more than setting a value, and that are the same in all the modules. Returns false if not one of those.
+inline bool ProjectMercury::LoadScenarioCommon(int special, const char* value)
+{
+	switch (special)
+	{
+	case SCN_STATE:
+		VesselStatus = (vesselstate)atoi(value);
+		return true;
+	case SCN_CAPSULE:
+		LoadCapsule(value);
+		return true;
+	case SCN_AUTOMODE:
+		AutopilotStatus = (autopilotstate)atoi(value);
+		return true;
+	case SCN_MET:
+		launchTime = oapiGetSimTime() - (double)atoi(value);
+		metFromScenario = true; // the checkpoint must not override this
+		return true;
+	case SCN_FAILURE: // input -1 for random failure (or possibly none if HARDMODE is not defined)
+	{
+		int inputFailure = atoi(value);
+		if (inputFailure == -1)
+		{
+			inputFailure = rand() % ((int)LASTENTRY - 1) + 1; // this should return a "random" integer between 1 and 12 (or the number of total modes in FailureMode enum)
+		}
+
+		FailureMode = (failure)inputFailure;
+		// Actual failure determination is done in clbkPostCreation, as we then have result from HARDMODE
+		return true;
+	}
+	case SCN_REPLACETEXTURE:
+		scenarioTextureUserEnable = true; // Load textures
+		ReadCapsuleTextureReplacement(value);
+		return true;
+	case SCN_CHECKPOINT:
+		LoadCheckpoint(value);
+		return true;
+	default:
+		return false;
+	}
+}
+
+inline bool ProjectMercury::SaveScenarioCommon(FILEHANDLE scn, int special, const char* key)
+{
+	switch (special)
+	{
+	case SCN_STATE:
+		oapiWriteScenario_int(scn, (char*)key, VesselStatus);
+		return true;
+	case SCN_CAPSULE:
+		if (configTextureUserEnable) oapiWriteScenario_string(scn, (char*)key, configTextureUserName[configTextureUserNum]);
+		else oapiWriteScenario_int(scn, (char*)key, CapsuleVersion);
+		return true;
+	case SCN_AUTOMODE:
+		oapiWriteScenario_int(scn, (char*)key, AutopilotStatus);
+		return true;
+	case SCN_MET:
+		if (launchTime != 0.0) // if we have launched using autopilot
+			oapiWriteScenario_int(scn, (char*)key, int(oapiGetSimTime() - launchTime));
+		return true;
+	case SCN_FAILURE:
+		oapiWriteScenario_int(scn, (char*)key, FailureMode);
+		return true;
+	case SCN_REPLACETEXTURE:
+		for (int i = 0; scenarioTextureUserEnable && i < numTextures; i++)
+			oapiWriteScenario_string(scn, (char*)key, textureString[i]);
+		return true;
+	case SCN_CHECKPOINT:
+		SaveCheckpoint(scn, key);
+		return true;
+	default:
+		return false;
+	}
+}
+
+// ==============================================================
+//		Binary checkpoint
+//
+// The scenario file only has a few text keys, so e.g. flight history, retro timing and the integrated attitude
+// were lost or re-derived on reload. Now clbkSaveState also writes every field in CheckpointFields to a small binary file,
+// and puts its name on a CHECKPOINT line. On load the file is read in one go, and applied at the end of
+// CapsuleGenericPostCreation (so that it overrides the values made there).
+// All values are stored as double, which is exact for the ints and bools too.
+// Simulation time starts at 0 on every scenario load, so event times (SCN_SIMTIME) are stored relative to the save time,
+// and the new simt is added back on load. launchTime is not restored if the scenario has a MET line, as that already sets it.
+// If the field list changes, the layout hash changes, and old checkpoints are ignored (with a log line).
+//
+// Each vessel has CHECKPOINT_SLOTS files, Scenarios\Checkpoints\<vessel>_<slot>.mcp, and a save reuses the oldest one.
+// So also Orbiter's "(Current state)" save at every exit can't fill the folder. A scenario whose checkpoint has since
+// been reused sees another save time in the header, and falls back to the scenario values.
+// ==============================================================
+
+const int CHECKPOINT_VERSION = 2; // 2: relative event times
+const int MAX_CHECKPOINT_FIELDS = 128;
+const int CHECKPOINT_SLOTS = 8; // files per vessel
+const double CHECKPOINT_TIME_NOT_SET = -1e30; // stored for SCN_SIMTIME fields that are 0.0
+
+typedef struct
+{
+	char magic[4]; // "MCKP"
+	int version;
+	unsigned int layout; // hash of field names and types
+	int numFields;
+	double mjd; // when saved, to catch an edited scenario
+} CHECKPOINTHEADER;
+
+inline unsigned int CheckpointLayout(const SCENARIOKEY* fields, int numFields)
+{
+	unsigned int hash = 2166136261u; // FNV-1a
+	for (int n = 0; n < numFields; n++)
+	{
+		for (const char* c = fields[n].key; *c != '\0'; c++)
+		{
+			hash ^= (unsigned char)*c;
+			hash *= 16777619u;
+		}
+		hash ^= (unsigned int)fields[n].type;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+inline void ProjectMercury::SaveCheckpoint(FILEHANDLE scn, const char* key)
+{
+	int numFields;
+	const SCENARIOKEY* fields = CheckpointFields(&numFields);
+	if (numFields > MAX_CHECKPOINT_FIELDS) numFields = MAX_CHECKPOINT_FIELDS;
+
+	struct
+	{
+		CHECKPOINTHEADER header;
+		double value[MAX_CHECKPOINT_FIELDS];
+	} buffer;
+
+	memcpy(buffer.header.magic, "MCKP", 4);
+	buffer.header.version = CHECKPOINT_VERSION;
+	buffer.header.layout = CheckpointLayout(fields, numFields);
+	buffer.header.numFields = numFields;
+	buffer.header.mjd = oapiGetSimMJD();
+	double simt = oapiGetSimTime();
+
+	for (int n = 0; n < numFields; n++)
+	{
+		switch (fields[n].type)
+		{
+		case SCN_INT:
+			buffer.value[n] = (double)(this->*(fields[n].i));
+			break;
+		case SCN_BOOL:
+		case SCN_FLAG:
+			buffer.value[n] = (this->*(fields[n].b)) ? 1.0 : 0.0;
+			break;
+		case SCN_DOUBLE:
+			buffer.value[n] = this->*(fields[n].d);
+			break;
+		case SCN_SIMTIME:
+			buffer.value[n] = (this->*(fields[n].d) == 0.0) ? CHECKPOINT_TIME_NOT_SET : this->*(fields[n].d) - simt;
+			break;
+		default:
+			buffer.value[n] = 0.0;
+			break;
+		}
+	}
+
+	// Reuse the oldest of the vessel's slots, so that the last few scenarios keep their own checkpoint
+	CreateDirectoryA("Scenarios\\Checkpoints", NULL);
+	char file[MAX_PATH];
+	FILETIME oldestTime = { 0xFFFFFFFF, 0xFFFFFFFF };
+	for (int slot = 0; slot < CHECKPOINT_SLOTS; slot++)
+	{
+		char slotFile[MAX_PATH];
+		sprintf(slotFile, "Scenarios\\Checkpoints\\%s_%i.mcp", GetName(), slot);
+
+		WIN32_FILE_ATTRIBUTE_DATA attributes;
+		if (!GetFileAttributesExA(slotFile, GetFileExInfoStandard, &attributes)) // free slot
+		{
+			strcpy(file, slotFile);
+			break;
+		}
+		if (CompareFileTime(&attributes.ftLastWriteTime, &oldestTime) < 0)
+		{
+			oldestTime = attributes.ftLastWriteTime;
+			strcpy(file, slotFile);
+		}
+	}
+
+	FILE* f = fopen(file, "wb");
+	if (f == NULL)
+	{
+		oapiWriteLogV("Could not write checkpoint >%s<", file);
+		return;
+	}
+
+	size_t size = sizeof(CHECKPOINTHEADER) + numFields * sizeof(double);
+	bool written = (fwrite(&buffer, 1, size, f) == size);
+	fclose(f);
+
+	if (written) oapiWriteScenario_string(scn, (char*)key, file);
+	else oapiWriteLogV("Could not write checkpoint >%s<", file);
+}
+
+inline void ProjectMercury::LoadCheckpoint(const char* file)
+{
+	strncpy(checkpointFile, file, sizeof(checkpointFile) - 1);
+	checkpointFile[sizeof(checkpointFile) - 1] = '\0';
+	checkpointPending = true; // applied in ApplyCheckpoint
+}
+
+inline void ProjectMercury::ApplyCheckpoint(void)
+{
+	if (!checkpointPending)
+		return;
+	checkpointPending = false;
+
+	int numFields;
+	const SCENARIOKEY* fields = CheckpointFields(&numFields);
+	if (numFields > MAX_CHECKPOINT_FIELDS) numFields = MAX_CHECKPOINT_FIELDS;
+
+	struct
+	{
+		CHECKPOINTHEADER header;
+		double value[MAX_CHECKPOINT_FIELDS];
+	} buffer;
+
+	FILE* f = fopen(checkpointFile, "rb");
+	if (f == NULL)
+	{
+		oapiWriteLogV("Checkpoint >%s< not found, using scenario values", checkpointFile);
+		return;
+	}
+
+	size_t size = sizeof(CHECKPOINTHEADER) + numFields * sizeof(double);
+	size_t read = fread(&buffer, 1, sizeof(buffer), f);
+	fclose(f);
+
+	if (read != size || memcmp(buffer.header.magic, "MCKP", 4) != 0 || buffer.header.version != CHECKPOINT_VERSION ||
+		buffer.header.numFields != numFields || buffer.header.layout != CheckpointLayout(fields, numFields))
+	{
+		oapiWriteLogV("Checkpoint >%s< is from another version, using scenario values", checkpointFile);
+		return;
+	}
+
+	if (fabs(buffer.header.mjd - oapiGetSimMJD()) * 86400.0 > 1.0)
+	{
+		oapiWriteLogV("Checkpoint >%s< is from another time than the scenario, using scenario values", checkpointFile);
+		return;
+	}
+
+	double simt = oapiGetSimTime();
+	for (int n = 0; n < numFields; n++)
+	{
+		switch (fields[n].type)
+		{
+		case SCN_INT:
+			this->*(fields[n].i) = (int)buffer.value[n];
+			break;
+		case SCN_BOOL:
+		case SCN_FLAG:
+			this->*(fields[n].b) = (buffer.value[n] != 0.0);
+			break;
+		case SCN_DOUBLE:
+			this->*(fields[n].d) = buffer.value[n];
+			break;
+		case SCN_SIMTIME:
+			if (fields[n].d == &ProjectMercury::launchTime && metFromScenario)
+				break;
+			this->*(fields[n].d) = (buffer.value[n] == CHECKPOINT_TIME_NOT_SET) ? 0.0 : buffer.value[n] + simt;
+			break;
+		}
+	}
+
+	oapiWriteLogV("Checkpoint >%s< restored, %i values", checkpointFile, numFields);
+}
+
 inline void ProjectMercury::LoadCapsule(const char *cbuf)
 {
 	if (isalpha(cbuf[0])) // User specified capsule from config, e.g. "Demo"
@@ -3304,382 +3880,135 @@ inline bool ProjectMercury::ReadTextureString(const char* cbuf, const int len, c
 	return false;
 }
 
+// Which replacement texture goes on which mesh group, for each capsule version (in capsulever order).
+// Each row lists the texture names in mesh group order, beginning with group 1. The capsule, antenna house and retro meshes are separated by |.
+// To support a new capsule mesh, add its row here and its value to capsulever.
+const char* const CAPSULE_TEXTURE_GROUPS[] = {
+	/* FREEDOM7 */ "Brailmap Mbrail1 Mbrail2 Porthole Ridges Verrail1 Metal Verrail2 Orange Artwork Pythr Rollthst Scanner Scope Snorkel Trailmap Topboxes USA | MetalAnt Antridge Screw Dialec | MetalRet DialecRet Bw",
+	/* LIBERTYBELL7 */ "Brailmap Mbrail1 Mbrail2 Ridges Verrail1 Metal Verrail2 Crack Glass Orange Artwork Pythr Rollthst Scanner Scope Snorkel Trailmap Topboxes USA Foilwindow Foil Windowfr | MetalAnt Antridge Screw Dialec | MetalRet DialecRet Bw",
+	/* FRIENDSHIP7 */ "Pythr Verrail1 Windowfr Wfrfront Metal Window USA Verrail2 Ridges Topboxes Trailmap Snorkel Scope Scanner Rollthst Artwork Orange Glass Flag Mbrail2 Mbrail1 Brailmap | MetalAnt Antridge Screw Dialec | MetalRet DialecRet Bw",
+	/* AURORA7 */ "Pythr Verrail1 Windowfr Wfrfront Metal Window USA Verrail2 Ridges Topboxes Trailmap Snorkel Scope Scanner Rollthst Artwork Orange Glass Flag Mbrail2 Mbrail1 Brailmap | MetalAnt Antridge Screw Dialec | MetalRet DialecRet Bw",
+	/* SIGMA7 */ "Pythr Verrail1 Windowfr Wfrfront Metal Window USA Verrail2 Ridges Topboxes Trailmap Snorkel Scope Scanner Rollthst Artwork Orange Glass Flag Mbrail2 Mbrail1 Brailmap | MetalAnt Antridge Screw Dialec | MetalRet DialecRet Bw",
+	/* FAITH7 */ "Brailmap Mbrail1 Mbrail2 Ridges Verrail1 Metal Verrail2 Flag Glass Orange Artwork Pythr Rollthst Scanner Snorkel Trailmap Topboxes USA Window Wfrfront Windowfr | MetalAnt Antridge Screw Dialec | MetalRet DialecRet Bw",
+	/* FREEDOM7II */ "Brailmap Mbrail1 Mbrail2 Ridges Verrail1 Metal Verrail2 Flag Glass Orange Artwork Pythr Rollthst Scanner Snorkel Trailmap Topboxes USA Window Wfrfront Windowfr | MetalAnt Antridge Screw Dialec | MetalRet DialecRet Bw",
+	/* CAPSULEBIGJOE */ "Scope Metal Orange BoilerplateCapsule | MetalAnt Screw | MetalRet DialecRet Bw",
+	/* CAPSULELITTLEJOE */ "Scope Metal Orange BoilerplateCapsule | MetalAnt Screw | MetalRet DialecRet Bw",
+	/* CAPSULEBD */ "Scope Metal Orange BoilerplateCapsule | MetalAnt Screw | MetalRet DialecRet Bw",
+};
+const int NUMBER_CAPSULE_TEXTURE_VERSIONS = sizeof(CAPSULE_TEXTURE_GROUPS) / sizeof(CAPSULE_TEXTURE_GROUPS[0]);
+const int MAX_CAPSULE_TEXTURE_GROUPS = 40;
+
 inline void ProjectMercury::LoadCapsuleTextureReplacement(void)
 {
-	int grpBrailmap, grpMbrail1, grpMbrail2, grpPorthole, grpRidges, grpVerrail1, grpMetal, grpVerrail2, grpOrange, grpPythr, grpRollthst, grpScanner, grpScope, grpSnorkel, grpTrailmap, grpTopboxes, grpUSA,
-		grpArtwork,
-		grpCrack, grpGlass, grpFoilwindow, grpFoil, grpWindowfr,
-		grpWfrfront, grpWindow, grpFlag,
-		grpBoilerplateCapsule,
-		grpMetalant, grpAntridge, grpScrew, grpDialec;
-
-	switch (CapsuleVersion)
-	{
-	case FREEDOM7:
-		grpBrailmap = 1;
-		grpMbrail1 = 2;
-		grpMbrail2 = 3;
-		grpPorthole = 4;
-		grpRidges = 5;
-		grpVerrail1 = 6;
-		grpMetal = 7;
-		grpVerrail2 = 8;
-		grpOrange = 9;
-		grpArtwork = 10;
-		grpPythr = 11;
-		grpRollthst = 12;
-		grpScanner = 13;
-		grpScope = 14;
-		grpSnorkel = 15;
-		grpTrailmap = 16;
-		grpTopboxes = 17;
-		grpUSA = 18;
-
-		grpMetalant = 1;
-		grpAntridge = 2;
-		grpScrew = 3;
-		grpDialec = 4;
-		break;
-	case LIBERTYBELL7:
-		grpBrailmap = 1;
-		grpMbrail1 = 2;
-		grpMbrail2 = 3;
-		grpRidges = 4;
-		grpVerrail1 = 5;
-		grpMetal = 6;
-		grpVerrail2 = 7;
-		grpCrack = 8;
-		grpGlass = 9;
-		grpOrange = 10;
-		grpArtwork = 11;
-		grpPythr = 12;
-		grpRollthst = 13;
-		grpScanner = 14;
-		grpScope = 15;
-		grpSnorkel = 16;
-		grpTrailmap = 17;
-		grpTopboxes = 18;
-		grpUSA = 19;
-		grpFoilwindow = 20;
-		grpFoil = 21;
-		grpWindowfr = 22;
-
-		grpMetalant = 1;
-		grpAntridge = 2;
-		grpScrew = 3;
-		grpDialec = 4;
-		break;
-	case FRIENDSHIP7:
-		grpPythr = 1;
-		grpVerrail1 = 2;
-		grpWindowfr = 3;
-		grpWfrfront = 4;
-		grpMetal = 5;
-		grpWindow = 6;
-		grpUSA = 7;
-		grpVerrail2 = 8;
-		grpRidges = 9;
-		grpTopboxes = 10;
-		grpTrailmap = 11;
-		grpSnorkel = 12;
-		grpScope = 13;
-		grpScanner = 14;
-		grpRollthst = 15;
-		grpArtwork = 16;
-		grpOrange = 17;
-		grpGlass = 18;
-		grpFlag = 19;
-		grpMbrail2 = 20;
-		grpMbrail1 = 21;
-		grpBrailmap = 22;
-
-		grpMetalant = 1;
-		grpAntridge = 2;
-		grpScrew = 3;
-		grpDialec = 4;
-		break;
-	case AURORA7:
-		grpPythr = 1;
-		grpVerrail1 = 2;
-		grpWindowfr = 3;
-		grpWfrfront = 4;
-		grpMetal = 5;
-		grpWindow = 6;
-		grpUSA = 7;
-		grpVerrail2 = 8;
-		grpRidges = 9;
-		grpTopboxes = 10;
-		grpTrailmap = 11;
-		grpSnorkel = 12;
-		grpScope = 13;
-		grpScanner = 14;
-		grpRollthst = 15;
-		grpArtwork = 16;
-		grpOrange = 17;
-		grpGlass = 18;
-		grpFlag = 19;
-		grpMbrail2 = 20;
-		grpMbrail1 = 21;
-		grpBrailmap = 22;
-
-		grpMetalant = 1;
-		grpAntridge = 2;
-		grpScrew = 3;
-		grpDialec = 4;
-		break;
-	case SIGMA7:
-		grpPythr = 1;
-		grpVerrail1 = 2;
-		grpWindowfr = 3;
-		grpWfrfront = 4;
-		grpMetal = 5;
-		grpWindow = 6;
-		grpUSA = 7;
-		grpVerrail2 = 8;
-		grpRidges = 9;
-		grpTopboxes = 10;
-		grpTrailmap = 11;
-		grpSnorkel = 12;
-		grpScope = 13;
-		grpScanner = 14;
-		grpRollthst = 15;
-		grpArtwork = 16;
-		grpOrange = 17;
-		grpGlass = 18;
-		grpFlag = 19;
-		grpMbrail2 = 20;
-		grpMbrail1 = 21;
-		grpBrailmap = 22;
-
-		grpMetalant = 1;
-		grpAntridge = 2;
-		grpScrew = 3;
-		grpDialec = 4;
-		break;
-	case FAITH7:
-		grpBrailmap = 1;
-		grpMbrail1 = 2;
-		grpMbrail2 = 3;
-		grpRidges = 4;
-		grpVerrail1 = 5;
-		grpMetal = 6;
-		grpVerrail2 = 7;
-		grpFlag = 8;
-		grpGlass = 9;
-		grpOrange = 10;
-		grpArtwork = 11;
-		grpPythr = 12;
-		grpRollthst = 13;
-		grpScanner = 14;
-		grpSnorkel = 15;
-		grpTrailmap = 16;
-		grpTopboxes = 17;
-		grpUSA = 18;
-		grpWindow = 19;
-		grpWfrfront = 20;
-		grpWindowfr = 21;
-
-		grpMetalant = 1;
-		grpAntridge = 2;
-		grpScrew = 3;
-		grpDialec = 4;
-		break;
-	case FREEDOM7II:
-		grpBrailmap = 1;
-		grpMbrail1 = 2;
-		grpMbrail2 = 3;
-		grpRidges = 4;
-		grpVerrail1 = 5;
-		grpMetal = 6;
-		grpVerrail2 = 7;
-		grpFlag = 8;
-		grpGlass = 9;
-		grpOrange = 10;
-		grpArtwork = 11;
-		grpPythr = 12;
-		grpRollthst = 13;
-		grpScanner = 14;
-		grpSnorkel = 15;
-		grpTrailmap = 16;
-		grpTopboxes = 17;
-		grpUSA = 18;
-		grpWindow = 19;
-		grpWfrfront = 20;
-		grpWindowfr = 21;
-
-		grpMetalant = 1;
-		grpAntridge = 2;
-		grpScrew = 3;
-		grpDialec = 4;
-		break;
-	case CAPSULEBIGJOE:
-		grpScope = 1;
-		grpMetal = 2;
-		grpOrange = 3;
-		grpBoilerplateCapsule = 4;
-
-		grpMetalant = 1;
-		grpScrew = 2;
-		break;
-	case CAPSULELITTLEJOE:
-		grpScope = 1;
-		grpMetal = 2;
-		grpOrange = 3;
-		grpBoilerplateCapsule = 4;
-
-		grpMetalant = 1;
-		grpScrew = 2;
-		break;
-	case CAPSULEBD:
-		grpScope = 1;
-		grpMetal = 2;
-		grpOrange = 3;
-		grpBoilerplateCapsule = 4;
-
-		grpMetalant = 1;
-		grpScrew = 2;
-		break;
-	default:
-		oapiWriteLog("LoadCapsuleTextureReplacement failed to read Capsule version! Please report this bug!");
-		break;
-	}
+	typedef struct
+	{
+		const char* name;
+		ATEX ProjectMercury::* tex;
+	} TEXTURESLOT;
+
+	typedef struct
+	{
+		const TEXTURESLOT* slot;
+		int mesh; // 0 capsule, 1 antenna house, 2 retro
+		DWORD group;
+	} TEXTUREGROUP;
+
+	static const TEXTURESLOT slots[] = {
+		{ "Porthole", &ProjectMercury::texPorthole },
+		{ "Brailmap", &ProjectMercury::texBrailmap },
+		{ "Mbrail1", &ProjectMercury::texMBrail1 },
+		{ "Mbrail2", &ProjectMercury::texMBrail2 },
+		{ "Ridges", &ProjectMercury::texRidges },
+		{ "Verrail1", &ProjectMercury::texVerrail1 },
+		{ "Verrail2", &ProjectMercury::texVerrail2 },
+		{ "Metal", &ProjectMercury::texMetal },
+		{ "Orange", &ProjectMercury::texOrange },
+		{ "Pythr", &ProjectMercury::texPythr },
+		{ "Rollthst", &ProjectMercury::texRollthst },
+		{ "Scanner", &ProjectMercury::texScanner },
+		{ "Scope", &ProjectMercury::texScope },
+		{ "Snorkel", &ProjectMercury::texSnorkel },
+		{ "Trailmap", &ProjectMercury::texTrailmap },
+		{ "Topboxes", &ProjectMercury::texTopboxes },
+		{ "USA", &ProjectMercury::texUsa },
+		{ "Artwork", &ProjectMercury::texArtwork },
+		{ "Crack", &ProjectMercury::texCrack },
+		{ "Glass", &ProjectMercury::texGlass },
+		{ "Foilwindow", &ProjectMercury::texFoilwindow },
+		{ "Foil", &ProjectMercury::texFoil },
+		{ "Windowfr", &ProjectMercury::texWindowfr },
+		{ "Wfrfront", &ProjectMercury::texWfrfront },
+		{ "Window", &ProjectMercury::texWindow },
+		{ "Flag", &ProjectMercury::texFlag },
+		{ "BoilerplateCapsule", &ProjectMercury::texBoilerplateCapsule },
+		{ "MetalAnt", &ProjectMercury::texMetalant },
+		{ "Antridge", &ProjectMercury::texAntridge },
+		{ "Screw", &ProjectMercury::texScrew },
+		{ "Dialec", &ProjectMercury::texDialec },
+		{ "MetalRet", &ProjectMercury::texMetalret },
+		{ "DialecRet", &ProjectMercury::texDialecret },
+		{ "Bw", &ProjectMercury::texBw },
+	};
+	const int numSlots = sizeof(slots) / sizeof(slots[0]);
 
-	// Capsule textures
-	if (strlen(texPorthole.file) != 0 && grpPorthole != NULL)
-	{
-		LoadTextureFile(texPorthole, "Porthole", capsule, grpPorthole);
-	}
-	if (strlen(texBrailmap.file) != 0 && grpBrailmap != NULL)
-	{
-		LoadTextureFile(texBrailmap, "Brailmap", capsule, grpBrailmap);
-	}
-	if (strlen(texMBrail1.file) != 0 && grpMbrail1 != NULL)
-	{
-		LoadTextureFile(texMBrail1, "Mbrail1", capsule, grpMbrail1);
-	}
-	if (strlen(texMBrail2.file) != 0 && grpMbrail2 != NULL)
-	{
-		LoadTextureFile(texMBrail2, "Mbrail2", capsule, grpMbrail2);
-	}
-	if (strlen(texRidges.file) != 0 && grpRidges != NULL)
-	{
-		LoadTextureFile(texRidges, "Ridges", capsule, grpRidges);
-	}
-	if (strlen(texVerrail1.file) != 0 && grpVerrail1 != NULL)
-	{
-		LoadTextureFile(texVerrail1, "Verrail1", capsule, grpVerrail1);
-	}
-	if (strlen(texVerrail2.file) != 0 && grpVerrail2 != NULL)
-	{
-		LoadTextureFile(texVerrail2, "Verrail2", capsule, grpVerrail2);
-	}
-	if (strlen(texMetal.file) != 0 && grpMetal != NULL)
-	{
-		LoadTextureFile(texMetal, "Metal", capsule, grpMetal);
-	}
-	if (strlen(texOrange.file) != 0 && grpOrange != NULL)
-	{
-		LoadTextureFile(texOrange, "Orange", capsule, grpOrange);
-	}
-	if (strlen(texPythr.file) != 0 && grpPythr != NULL)
-	{
-		LoadTextureFile(texPythr, "Pythr", capsule, grpPythr);
-	}
-	if (strlen(texRollthst.file) != 0 && grpRollthst != NULL)
-	{
-		LoadTextureFile(texRollthst, "Rollthst", capsule, grpRollthst);
-	}
-	if (strlen(texScanner.file) != 0 && grpScanner != NULL)
-	{
-		LoadTextureFile(texScanner, "Scanner", capsule, grpScanner);
-	}
-	if (strlen(texScope.file) != 0 && grpScope != NULL)
-	{
-		LoadTextureFile(texScope, "Scope", capsule, grpScope);
-	}
-	if (strlen(texSnorkel.file) != 0 && grpSnorkel != NULL)
-	{
-		LoadTextureFile(texSnorkel, "Snorkel", capsule, grpSnorkel);
-	}
-	if (strlen(texTrailmap.file) != 0 && grpTrailmap != NULL)
+	// Build the group map from CAPSULE_TEXTURE_GROUPS the first time
+	static TEXTUREGROUP groups[NUMBER_CAPSULE_TEXTURE_VERSIONS][MAX_CAPSULE_TEXTURE_GROUPS];
+	static int numGroups[NUMBER_CAPSULE_TEXTURE_VERSIONS] = { 0 };
+	static bool groupsBuilt = false;
+	if (!groupsBuilt)
 	{
-		LoadTextureFile(texTrailmap, "Trailmap", capsule, grpTrailmap);
-	}
-	if (strlen(texTopboxes.file) != 0 && grpTopboxes != NULL)
-	{
-		LoadTextureFile(texTopboxes, "Topboxes", capsule, grpTopboxes);
-	}
-	if (strlen(texUsa.file) != 0 && grpUSA != NULL)
-	{
-		LoadTextureFile(texUsa, "USA", capsule, grpUSA);
-	}
-	if (strlen(texArtwork.file) != 0 && grpArtwork != NULL)
-	{
-		LoadTextureFile(texArtwork, "Artwork", capsule, grpArtwork);
-	}
-	if (strlen(texCrack.file) != 0 && grpCrack != NULL)
-	{
-		LoadTextureFile(texCrack, "Crack", capsule, grpCrack);
-	}
-	if (strlen(texGlass.file) != 0 && grpGlass != NULL)
-	{
-		LoadTextureFile(texGlass, "Glass", capsule, grpGlass);
-	}
-	if (strlen(texFoilwindow.file) != 0 && grpFoilwindow != NULL)
-	{
-		LoadTextureFile(texFoilwindow, "Foilwindow", capsule, grpFoilwindow);
-	}
-	if (strlen(texFoil.file) != 0 && grpFoil != NULL)
-	{
-		LoadTextureFile(texFoil, "Foil", capsule, grpFoil);
-	}
-	if (strlen(texWindowfr.file) != 0 && grpWindowfr != NULL)
-	{
-		LoadTextureFile(texWindowfr, "Windowfr", capsule, grpWindowfr);
-	}
-	if (strlen(texWfrfront.file) != 0 && grpWfrfront != NULL)
-	{
-		LoadTextureFile(texWfrfront, "Wfrfront", capsule, grpWfrfront);
-	}
-	if (strlen(texWindow.file) != 0 && grpWindow != NULL)
-	{
-		LoadTextureFile(texWindow, "Window", capsule, grpWindow);
-	}
-	if (strlen(texFlag.file) != 0 && grpFlag != NULL)
-	{
-		LoadTextureFile(texFlag, "Flag", capsule, grpFlag);
-	}
-	if (strlen(texBoilerplateCapsule.file) != 0 && grpBoilerplateCapsule != NULL)
-	{
-		LoadTextureFile(texBoilerplateCapsule, "BoilerplateCapsule", capsule, grpBoilerplateCapsule);
-	} // BEGIN ANTHOUSE
-	if (strlen(texMetalant.file) != 0 && grpMetalant != NULL)
-	{
-		LoadTextureFile(texMetalant, "MetalAnt", antennahouse, grpMetalant);
-	}
-	if (strlen(texAntridge.file) != 0 && grpAntridge != NULL)
-	{
-		LoadTextureFile(texAntridge, "Antridge", antennahouse, grpAntridge);
-	}
-	if (strlen(texScrew.file) != 0 && grpScrew != NULL)
-	{
-		LoadTextureFile(texScrew, "Screw", antennahouse, grpScrew);
-	}
-	if (strlen(texDialec.file) != 0 && grpDialec != NULL)
-	{
-		LoadTextureFile(texDialec, "Dialec", antennahouse, grpDialec);
-	} // BEGIN RETRO
-	if (strlen(texMetalret.file) != 0)
-	{
-		LoadTextureFile(texMetalret, "MetalRet", retro, 1); // group always the same
+		for (int version = 0; version < NUMBER_CAPSULE_TEXTURE_VERSIONS; version++)
+		{
+			int mesh = 0;
+			DWORD group = 1;
+			const char* c = CAPSULE_TEXTURE_GROUPS[version];
+			while (*c != '\0')
+			{
+				while (*c == ' ') c++;
+				int len = 0;
+				while (c[len] != ' ' && c[len] != '\0') len++;
+
+				if (len == 1 && *c == '|') // next mesh
+				{
+					mesh += 1;
+					group = 1;
+				}
+				else if (len > 0)
+				{
+					int i = 0;
+					while (i < numSlots && !(strncmp(slots[i].name, c, len) == 0 && slots[i].name[len] == '\0')) i++;
+
+					if (i == numSlots || numGroups[version] == MAX_CAPSULE_TEXTURE_GROUPS)
+						oapiWriteLogV("Capsule texture map %i has unknown texture or too many groups at >%s<", version, c);
+					else
+					{
+						TEXTUREGROUP* g = &groups[version][numGroups[version]++];
+						g->slot = &slots[i];
+						g->mesh = mesh;
+						g->group = group;
+					}
+					group += 1;
+				}
+				c += len;
+			}
+		}
+		groupsBuilt = true;
 	}
-	if (strlen(texDialecret.file) != 0)
+
+	if (CapsuleVersion < 0 || CapsuleVersion >= NUMBER_CAPSULE_TEXTURE_VERSIONS)
 	{
-		LoadTextureFile(texDialecret, "DialecRet", retro, 2); // group always the same
+		oapiWriteLog("LoadCapsuleTextureReplacement failed to read Capsule version! Please report this bug!");
 	}
-	if (strlen(texBw.file) != 0)
+	else
 	{
-		LoadTextureFile(texBw, "Bw", retro, 3); // group always the same
+		MESHHANDLE meshes[3] = { capsule, antennahouse, retro };
+		for (int i = 0; i < numGroups[CapsuleVersion]; i++)
+		{
+			const TEXTUREGROUP* g = &groups[CapsuleVersion][i];
+			const ATEX& tex = this->*(g->slot->tex);
+			if (strlen(tex.file) != 0)
+				LoadTextureFile(tex, g->slot->name, meshes[g->mesh], g->group);
+		}
 	}
 
 	LoadRocketTextureReplacement();
@@ -3691,12 +4020,8 @@ inline void ProjectMercury::LoadTextureFile(ATEX tex, const char* type, MESHHAND
 	strcat(file, tex.file);
 	strcat(file, ".dds");
 
-	oapiWriteLogV("Loading %s file >%s<", type, file);
-	SURFHANDLE newTex = oapiLoadTexture(file, true);
-	SURFHANDLE oldTex = oapiGetTextureHandle(mesh, meshTexIdx);
-	oapiBlt(oldTex, newTex, 0, 0, 0, 0, tex.w, tex.h);
-	oapiReleaseTexture(newTex);
-	oapiWriteLogV("Finished loading %s texture", type);
+	oapiWriteLogV("Queueing %s file >%s<", type, file);
+	textureQueue.Request(file, type, tex.w, tex.h, mesh, meshTexIdx); // applied in a later clbkPreStep. See AsyncTextureLoader.h
 }
 
 inline void ProjectMercury::DefinePeriscopeAnimation(void)
@@ -3889,6 +4214,7 @@ inline void ProjectMercury::AnimatePeriscope(double simt, double simdt)
 
 void ProjectMercury::vlift(VESSEL* v, double aoa, double M, double Re, void* context, double* cl, double* cm, double* cd)
 {
+	PROFILE_SCOPE(PROF_AERO);
 	// This works ish. For later improvement with matrix taking mach into consideration, see https://www.orbiter-forum.com/showthread.php?t=40607
 	static const double cmp[13] = {
 		0, -0.204, -0.193, -0.238, -0.337, -0.223, 0.03, 0.23, 0.31, 0.235, 0.194, 0.192, 0
@@ -3958,6 +4284,7 @@ void ProjectMercury::vlift(VESSEL* v, double aoa, double M, double Re, void* con
 
 void ProjectMercury::hlift(VESSEL* v, double aoa, double M, double Re, void* context, double* cl, double* cm, double* cd)
 {
+	PROFILE_SCOPE(PROF_AERO);
 	static const double cmp[13] = {
 		0, 0.204, 0.193, 0.238, 0.337, 0.223, -0.03, -0.23, -0.31, -0.235, -0.194, -0.192, 0
 	};
@@ -4023,6 +4350,7 @@ void ProjectMercury::hlift(VESSEL* v, double aoa, double M, double Re, void* con
 
 void ProjectMercury::vliftEscape(VESSEL* v, double aoa, double M, double Re, void* context, double* cl, double* cm, double* cd)
 {
+	PROFILE_SCOPE(PROF_AERO);
 	// This works ish. For later improvement with matrix taking mach into consideration, see https://www.orbiter-forum.com/showthread.php?t=40607
 	static const double cmp[13] = {
 		0, -0.45, -0.50, -0.58, -0.38, -0.11, 0.03, 0.11, 0.38, 0.58, 0.50, 0.45, 0
@@ -4071,6 +4399,7 @@ void ProjectMercury::vliftEscape(VESSEL* v, double aoa, double M, double Re, voi
 
 void ProjectMercury::hliftEscape(VESSEL* v, double aoa, double M, double Re, void* context, double* cl, double* cm, double* cd)
 {
+	PROFILE_SCOPE(PROF_AERO);
 	static const double cmp[13] = {
 		0, -0.45, -0.50, -0.58, -0.38, -0.11, 0.03, 0.11, 0.38, 0.58, 0.50, 0.45, 0
 	};
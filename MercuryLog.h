@@ -0,0 +1,183 @@
+#pragma once
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+// ==============================================================
+//		Logging with levels, rate limiting and deduplication
+//
+// Previously every log line was a sprintf into a 256 byte buffer and an oapiWriteLog, also on paths that are
+// hit every time step while a condition holds (CheckAbortConditions wrote one line per frame after an abort limit was crossed).
+// Now each call site is a MercuryLogSite with its own state:
+//		- levels below MERCURY_LOG_LEVEL are removed by the preprocessor, including their arguments
+//		- the _EVERY versions write at most once per given interval (real time), and only count the rest
+//		- a line identical to the last one from the same site is only counted
+//		- the text is only formatted when it will be written, into a bounded buffer
+// The counted lines are reported as "> repeated N times: <start of line>" when the site writes again, and by MercuryLog::Flush at exit.
+//
+// Usage:
+//		MLOG_INFO("Booster cutoff T+%.1f", met);
+//		MLOG_WARN_EVERY(1.0, "Abort due to error in pitch rate at T+%.1f", met);
+// ==============================================================
+
+#define MLOG_LEVEL_DEBUG 0
+#define MLOG_LEVEL_INFO 1
+#define MLOG_LEVEL_WARN 2
+#define MLOG_LEVEL_ERROR 3
+#define MLOG_LEVEL_OFF 4
+
+#ifndef MERCURY_LOG_LEVEL
+#ifdef _DEBUG
+#define MERCURY_LOG_LEVEL MLOG_LEVEL_DEBUG
+#else
+#define MERCURY_LOG_LEVEL MLOG_LEVEL_INFO
+#endif
+#endif
+
+const int MLOG_BUFFER_LENGTH = 1024; // longer lines are cut
+const int MLOG_SUMMARY_LENGTH = 48; // start of the line repeated in the repeat report
+const double MLOG_REPEAT_REPORT = 30.0; // s. Report identical lines at least this often, so that a stuck condition is still visible
+
+class MercuryLogSite
+{
+public:
+	MercuryLogSite(int logLevel, double minInterval) : level(logLevel), interval(minInterval)
+	{
+		// Register for Flush. Only the simulation thread logs, and static locals are constructed once
+		next = First();
+		First() = this;
+	}
+
+	// Cheap check before formatting
+	bool Ready(void)
+	{
+		if (interval > 0.0 && written && oapiGetSysTime() - lastTime < interval)
+		{
+			repeated += 1;
+			return false;
+		}
+		return true;
+	}
+
+	void Write(const char* format, ...)
+	{
+		char text[MLOG_BUFFER_LENGTH];
+		va_list va;
+		va_start(va, format);
+		vsnprintf(text, sizeof(text), format, va);
+		va_end(va);
+		text[sizeof(text) - 1] = '\0';
+
+		double now = oapiGetSysTime();
+		unsigned int textHash = Hash(text);
+		if (written && textHash == lastHash && now - lastTime < MLOG_REPEAT_REPORT)
+		{
+			repeated += 1;
+			return;
+		}
+
+		FlushRepeated();
+		oapiWriteLog(text);
+		written = true;
+		strncpy(lastText, text, MLOG_SUMMARY_LENGTH);
+		lastHash = textHash;
+		lastTime = now;
+	}
+
+	void FlushRepeated(void)
+	{
+		if (repeated == 0)
+			return;
+
+		char text[MLOG_SUMMARY_LENGTH + 48];
+		sprintf(text, " > repeated %i times: %s", repeated, lastText);
+		oapiWriteLog(text);
+		totalRepeated += repeated;
+		repeated = 0;
+	}
+
+	static MercuryLogSite*& First(void)
+	{
+		static MercuryLogSite* first = NULL;
+		return first;
+	}
+
+	int level;
+	double interval;
+	double lastTime = 0.0;
+	unsigned int lastHash = 0;
+	char lastText[MLOG_SUMMARY_LENGTH + 1] = "";
+	bool written = false;
+	int repeated = 0; // not yet reported
+	int totalRepeated = 0;
+	MercuryLogSite* next = NULL;
+
+private:
+	static unsigned int Hash(const char* text)
+	{
+		unsigned int h = 2166136261u; // FNV-1a
+		for (const char* c = text; *c != '\0'; c++)
+		{
+			h ^= (unsigned char)*c;
+			h *= 16777619u;
+		}
+		return h;
+	}
+};
+
+namespace MercuryLog
+{
+	// Write outstanding repeat counts, and a total. Called at exit
+	inline void Flush(void)
+	{
+		int sites = 0, total = 0;
+		for (MercuryLogSite* site = MercuryLogSite::First(); site != NULL; site = site->next)
+		{
+			site->FlushRepeated();
+			sites += 1;
+			total += site->totalRepeated;
+		}
+
+		if (total > 0)
+		{
+			char text[96];
+			sprintf(text, " > Log: %i repeated lines not written, from %i call sites", total, sites);
+			oapiWriteLog(text);
+		}
+	}
+}
+
+#define MLOG_SITE(logLevel, minInterval, ...) \
+	do { static MercuryLogSite mlogSite(logLevel, minInterval); if (mlogSite.Ready()) mlogSite.Write(__VA_ARGS__); } while (0)
+
+#if MERCURY_LOG_LEVEL <= MLOG_LEVEL_DEBUG
+#define MLOG_DEBUG(...) MLOG_SITE(MLOG_LEVEL_DEBUG, 0.0, __VA_ARGS__)
+#define MLOG_DEBUG_EVERY(seconds, ...) MLOG_SITE(MLOG_LEVEL_DEBUG, seconds, __VA_ARGS__)
+#else
+#define MLOG_DEBUG(...) ((void)0)
+#define MLOG_DEBUG_EVERY(seconds, ...) ((void)0)
+#endif
+
+#if MERCURY_LOG_LEVEL <= MLOG_LEVEL_INFO
+#define MLOG_INFO(...) MLOG_SITE(MLOG_LEVEL_INFO, 0.0, __VA_ARGS__)
+#define MLOG_INFO_EVERY(seconds, ...) MLOG_SITE(MLOG_LEVEL_INFO, seconds, __VA_ARGS__)
+#else
+#define MLOG_INFO(...) ((void)0)
+#define MLOG_INFO_EVERY(seconds, ...) ((void)0)
+#endif
+
+#if MERCURY_LOG_LEVEL <= MLOG_LEVEL_WARN
+#define MLOG_WARN(...) MLOG_SITE(MLOG_LEVEL_WARN, 0.0, __VA_ARGS__)
+#define MLOG_WARN_EVERY(seconds, ...) MLOG_SITE(MLOG_LEVEL_WARN, seconds, __VA_ARGS__)
+#else
+#define MLOG_WARN(...) ((void)0)
+#define MLOG_WARN_EVERY(seconds, ...) ((void)0)
+#endif
+
+#if MERCURY_LOG_LEVEL <= MLOG_LEVEL_ERROR
+#define MLOG_ERROR(...) MLOG_SITE(MLOG_LEVEL_ERROR, 0.0, __VA_ARGS__)
+#define MLOG_ERROR_EVERY(seconds, ...) MLOG_SITE(MLOG_LEVEL_ERROR, seconds, __VA_ARGS__)
+#else
+#define MLOG_ERROR(...) ((void)0)
+#define MLOG_ERROR_EVERY(seconds, ...) ((void)0)
+#endif
@@ -0,0 +1,239 @@
+#pragma once
+
+// ==============================================================
+//		Profiler for the vessel callbacks
+//
+// Previously there was no way to see where the time in these DLLs went. Now the expensive functions have a
+// PROFILE_SCOPE, which adds its time (MercuryTimerNs) to a per-frame total. At the start of each frame
+// the totals go into a histogram per scope, so that p50 and p99 are per frame, not per call.
+// Ctrl+Y shows p50/p99 of the last PROFILE_WINDOW seconds on the HUD, and a report for the whole session is written to Orbiter.log at exit.
+//
+// Scopes are inclusive, so AnimateDials is also part of clbkPostStep. The aero callbacks and the retro search
+// are called many times per frame, and are summed.
+//
+// Only compiled with MERCURY_PROFILE, which is on in debug builds. Otherwise all macros are empty.
+// ==============================================================
+
+#ifndef MERCURY_PROFILE
+#ifdef _DEBUG
+#define MERCURY_PROFILE 1
+#else
+#define MERCURY_PROFILE 0
+#endif
+#endif
+
+#if MERCURY_PROFILE
+#include <stdio.h>
+#include <string.h>
+#include "MercuryTimer.h"
+
+const enum PROFILE_SCOPE_ID
+{
+	PROF_PRESTEP,
+	PROF_POSTSTEP,
+	PROF_DRAWHUD,
+	PROF_DIALS,
+	PROF_GLOBE,
+	PROF_RETROSEARCH,
+	PROF_AERO,
+	PROF_AUTOPILOT,
+	PROF_NUM_SCOPES
+};
+
+const char* const PROFILE_SCOPE_NAMES[PROF_NUM_SCOPES] = { "PreStep", "PostStep", "DrawHUD", "AnimateDials", "RotateGlobe", "Retro search", "Aero", "Autopilot" };
+
+const int PROFILE_BUCKETS = 128; // 4 per doubling of ns, up to 8 s
+const double PROFILE_WINDOW = 5.0; // s, real time, for the HUD
+
+// Log scale histogram of frame times in ns
+class ProfileHistogram
+{
+public:
+	void Add(long long ns)
+	{
+		counts[Bucket(ns)] += 1;
+		total += 1;
+		sum += ns;
+		if (ns > max) max = ns;
+	}
+
+	// Upper edge of the bucket where the fraction p of samples is reached
+	long long Percentile(double p) const
+	{
+		if (total == 0)
+			return 0;
+
+		unsigned int target = (unsigned int)(p * double(total - 1)) + 1;
+		unsigned int count = 0;
+		for (int i = 0; i < PROFILE_BUCKETS; i++)
+		{
+			count += counts[i];
+			if (count >= target)
+				return UpperEdge(i) < max ? UpperEdge(i) : max;
+		}
+		return max;
+	}
+
+	void Reset(void)
+	{
+		memset(counts, 0, sizeof(counts));
+		total = 0;
+		sum = 0;
+		max = 0;
+	}
+
+	unsigned int counts[PROFILE_BUCKETS] = { 0 };
+	unsigned int total = 0; // frames
+	long long sum = 0;
+	long long max = 0;
+
+private:
+	static int Bucket(long long ns)
+	{
+		if (ns < 4)
+			return ns < 0 ? 0 : int(ns);
+
+		int msb = 2;
+		while (msb < 62 && (ns >> (msb + 1)) != 0) msb++;
+		int index = 4 * (msb - 1) + int((ns >> (msb - 2)) & 3);
+		return index < PROFILE_BUCKETS ? index : PROFILE_BUCKETS - 1;
+	}
+
+	static long long UpperEdge(int index)
+	{
+		if (index < 4)
+			return index + 1;
+
+		int msb = index / 4 + 1;
+		return (long long)(4 + index % 4 + 1) << (msb - 2);
+	}
+};
+
+class Profiler
+{
+public:
+	// One per module DLL, shared by all vessels of the module, as the aero callbacks are static
+	static Profiler& Global(void)
+	{
+		static Profiler profiler;
+		return profiler;
+	}
+
+	void Add(int scope, long long ns)
+	{
+		frameTime[scope] += ns;
+		frameCalls[scope] += 1;
+	}
+
+	// First thing in clbkPreStep. Several vessels call this each frame, but only the first call with a new sysTime closes the frame
+	void NextFrame(double sysTime)
+	{
+		if (sysTime == frameSysTime)
+			return;
+		frameSysTime = sysTime;
+		frames += 1;
+
+		for (int i = 0; i < PROF_NUM_SCOPES; i++)
+		{
+			if (frameCalls[i] != 0)
+			{
+				window[i].Add(frameTime[i]);
+				session[i].Add(frameTime[i]);
+				calls[i] += frameCalls[i];
+			}
+			frameTime[i] = 0;
+			frameCalls[i] = 0;
+		}
+
+		if (sysTime - windowStart > PROFILE_WINDOW)
+		{
+			for (int i = 0; i < PROF_NUM_SCOPES; i++)
+			{
+				shownP50[i] = window[i].Percentile(0.5);
+				shownP99[i] = window[i].Percentile(0.99);
+				window[i].Reset();
+			}
+			windowStart = sysTime;
+		}
+	}
+
+	void ToggleHUD(void)
+	{
+		showHUD = !showHUD;
+	}
+
+	// Compact table of the last window, from (x, y) and down
+	void DrawHUD(oapi::Sketchpad* skp, int x, int y, int lineSpacing)
+	{
+		if (!showHUD)
+			return;
+
+		char cbuf[64];
+		sprintf(cbuf, "Profiler (%.0f s)    p50    p99 us", PROFILE_WINDOW);
+		skp->Text(x, y, cbuf, strlen(cbuf));
+		for (int i = 0; i < PROF_NUM_SCOPES; i++)
+		{
+			sprintf(cbuf, "%-14s %6.1f %6.1f", PROFILE_SCOPE_NAMES[i], double(shownP50[i]) * 1e-3, double(shownP99[i]) * 1e-3);
+			skp->Text(x, y + (i + 1) * lineSpacing, cbuf, strlen(cbuf));
+		}
+	}
+
+	// At exit
+	void WriteLogReport(void)
+	{
+		if (frames == 0)
+			return;
+
+		oapiWriteLogV(" > Profiler, %i frames. Per frame in us: p50, p99, max, mean. Calls per frame", frames);
+		for (int i = 0; i < PROF_NUM_SCOPES; i++)
+		{
+			const ProfileHistogram& h = session[i];
+			if (h.total == 0)
+				continue;
+
+			oapiWriteLogV(" >   %-14s %8.1f %8.1f %8.1f %8.1f   %.1f", PROFILE_SCOPE_NAMES[i], double(h.Percentile(0.5)) * 1e-3, double(h.Percentile(0.99)) * 1e-3,
+				double(h.max) * 1e-3, double(h.sum) / double(h.total) * 1e-3, double(calls[i]) / double(h.total));
+		}
+	}
+
+private:
+	long long frameTime[PROF_NUM_SCOPES] = { 0 };
+	int frameCalls[PROF_NUM_SCOPES] = { 0 };
+	long long calls[PROF_NUM_SCOPES] = { 0 };
+	ProfileHistogram window[PROF_NUM_SCOPES];
+	ProfileHistogram session[PROF_NUM_SCOPES];
+	long long shownP50[PROF_NUM_SCOPES] = { 0 };
+	long long shownP99[PROF_NUM_SCOPES] = { 0 };
+	double frameSysTime = -1.0;
+	double windowStart = 0.0;
+	int frames = 0;
+	bool showHUD = false;
+};
+
+class ProfileScope
+{
+public:
+	ProfileScope(int profileScope) : scope(profileScope), start(MercuryTimerNs()) {}
+
+	~ProfileScope()
+	{
+		Profiler::Global().Add(scope, MercuryTimerNs() - start);
+	}
+
+private:
+	int scope;
+	long long start;
+};
+
+#define PROFILE_SCOPE(scope) ProfileScope profileScope(scope)
+#define PROFILE_FRAME() Profiler::Global().NextFrame(oapiGetSysTime())
+#define PROFILE_TOGGLE_HUD() Profiler::Global().ToggleHUD()
+#define PROFILE_DRAW_HUD(skp, x, y, lineSpacing) Profiler::Global().DrawHUD(skp, x, y, lineSpacing)
+#define PROFILE_REPORT() Profiler::Global().WriteLogReport()
+#else
+#define PROFILE_SCOPE(scope)
+#define PROFILE_FRAME()
+#define PROFILE_TOGGLE_HUD()
+#define PROFILE_DRAW_HUD(skp, x, y, lineSpacing)
+#define PROFILE_REPORT()
+#endif
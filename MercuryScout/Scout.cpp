@@ -18,6 +18,9 @@
 
 #include "orbitersdk.h"
 
+#include "..\DebrisManager.h"
+#include "..\HudTextCache.h"
+#include "..\FlightRecorder.h" // for FLIGHT_OUTPUT_FOLDER
 #include "Scout.h"
 #include "..\FunctionsForOrbiter2016.h"
 #include "..\ProjectMercuryGeneric.h"
@@ -70,6 +73,10 @@ ProjectMercury::~ProjectMercury()
 
 	oapiWriteLogV(" > Earth-fixed velocity: %.0f m/s (%.0f ft/s)", historyMaxEarthSpeed, historyMaxEarthSpeed / 0.3048);
 	oapiWriteLogV(" > Space-fixed velocity: %.0f m/s (%.0f ft/s)", historyMaxSpaceSpeed, historyMaxSpaceSpeed / 0.3048);
+	debris.WriteLogStats();
+	hudText.WriteLogStats();
+
+	WriteBaseContactLog(); // remaining passes
 }
 
 
@@ -245,6 +252,16 @@ void ProjectMercury::clbkPostCreation()
 		DelMesh(Fairing[0]);
 		DelMesh(Fairing[1]);
 	}
+
+	// Load everything we may separate now, instead of at staging
+	if (VesselStatus == STAGE1) debris.Prewarm("ProjectMercury\\Scout\\Stage1");
+	if (VesselStatus == STAGE1 || VesselStatus == STAGE2) debris.Prewarm("ProjectMercury\\Scout\\Stage2");
+	if (VesselStatus != STAGE4) debris.Prewarm("ProjectMercury\\Scout\\Stage3");
+	if (FairingStatus != FAIRINGOFF)
+	{
+		debris.Prewarm("ProjectMercury\\Scout\\Fairing1");
+		debris.Prewarm("ProjectMercury\\Scout\\Fairing2");
+	}
 }
 
 void ProjectMercury::clbkPreStep(double simt, double simdt, double mjd)
@@ -353,7 +370,7 @@ void ProjectMercury::clbkPreStep(double simt, double simdt, double mjd)
 		break;
 	}
 
-	DeleteRogueVessels();
+	debris.Update(GetHandle());
 	BaseContactManager();
 
 	if (autopilot && !(VesselStatus == STAGE4 && GetPropellantMass(scout_propellant[3]) == 0.0))
@@ -613,13 +630,11 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 	if (showInfoOnHud == 0)
 	{
 		// ==== Buttons text ====
-		sprintf(cbuf, "Key commands:");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "Key commands:");
 		yIndex += 1;
 
 		// Button Ctrl+T
-		sprintf(cbuf, "Ctrl+T:Hide on-screen text");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "Ctrl+T:Hide on-screen text");
 		yIndex += 1;
 
 		// Key SPACE
@@ -627,8 +642,7 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		{
 			if (!spaceLaunch)
 			{
-				sprintf(cbuf, "SPACE: Engine on");
-				skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "SPACE: Engine on");
 				yIndex += 1;
 			}
 		}
@@ -636,50 +650,43 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		// Key C
 		if (GroundContact())
 		{
-			sprintf(cbuf, "C:     Set focus to ramp");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "C:     Set focus to ramp");
 			yIndex += 1;
 		}
 		else if (rocketCam)
 		{
-			sprintf(cbuf, "C:     Swtich camera");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "C:     Swtich camera");
 			yIndex += 1;
 		}
 
 		// Key M
-		sprintf(cbuf, "M:     Disengage autopilot");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "M:     Disengage autopilot");
 		yIndex += 1;
 
 		// Key J
 		if (VesselStatus != STAGE4)
 		{
-			sprintf(cbuf, "J:     Separate stage");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate stage");
 			yIndex += 1;
 		}
 
 		// Key G
 		if (FairingStatus == FAIRINGON)
 		{
-			sprintf(cbuf, "G:     Separate fairing");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "G:     Separate fairing");
 			yIndex += 1;
 		}
 
 		// Key P
 		if (GetMass() == STAGE4_DRY_MASS)
 		{
-			if (sattelitePoweredOn) sprintf(cbuf, "P:     Power down");
-			else sprintf(cbuf, "P:     Power up");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			if (sattelitePoweredOn) hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "P:     Power down");
+			else hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "P:     Power up");
 			yIndex += 1;
 		}
 		else
 		{
-			sprintf(cbuf, "P:     Engage autopilot");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "P:     Engage autopilot");
 			yIndex += 1;
 		}
 	}
@@ -726,12 +733,10 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		int metM = (int)floor((metAbs - metH * 3600.0) / 60.0);
 		int metS = (int)floor((metAbs - metH * 3600.0 - metM * 60.0));
 
-		sprintf(cbuf, "T%s%02i %02i %02i", signChar, metH, metM, metS);
-		skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "T%s%02i %02i %02i", signChar, metH, metM, metS);
 		yIndex += 1;
 
-		sprintf(cbuf, "Battery level: %.1f %%", batteryLevel / BATTERY_TOTAL_CHARGE * 100.0);
-		skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Battery level: %.1f %%", batteryLevel / BATTERY_TOTAL_CHARGE * 100.0);
 		yIndex += 1;
 
 		if (GetMass() != STAGE4_DRY_MASS && sattelitePoweredOn && batteryLevel > 0.0)
@@ -740,20 +745,17 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 			{
 				if (VesselStatus == STAGE1 && simt < stageSeparationTime[0] + launchTime)
 				{
-					sprintf(cbuf, "Stage separation in %.1f s", stageSeparationTime[0] + launchTime - simt);
-					skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+					hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Stage separation in %.1f s", stageSeparationTime[0] + launchTime - simt);
 					yIndex += 1;
 				}
 				else if (VesselStatus == STAGE2 && simt < stageSeparationTime[1])
 				{
-					sprintf(cbuf, "Stage separation in %.1f s", stageSeparationTime[1] + launchTime - simt);
-					skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+					hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Stage separation in %.1f s", stageSeparationTime[1] + launchTime - simt);
 					yIndex += 1;
 				}
 				else if (VesselStatus == STAGE3 && simt < stageSeparationTime[2])
 				{
-					sprintf(cbuf, "Stage separation in %.1f s", stageSeparationTime[2] + launchTime - simt);
-					skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+					hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Stage separation in %.1f s", stageSeparationTime[2] + launchTime - simt);
 					yIndex += 1;
 				}
 			}
@@ -761,20 +763,17 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 			// ==== Autopilot status ====
 			if (autopilot)
 			{
-				sprintf(cbuf, "Autopilot: ON");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Autopilot: ON");
 				yIndex += 1;
 			}
 			else
 			{
-				sprintf(cbuf, "Autopilot: OFF");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Autopilot: OFF");
 				yIndex += 1;
 			}
 
-			if (FairingStatus == FAIRINGON) sprintf(cbuf, "Fairing: ON");
-			else sprintf(cbuf, "Fairing: OFF");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			if (FairingStatus == FAIRINGON) hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Fairing: ON");
+			else hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Fairing: OFF");
 			yIndex += 1;
 
 			// Longitudinal acc:
@@ -785,40 +784,33 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 			double longAcc = (F - W).z / m;
 			if (longAcc > 21.0 * G) longAcc = 21.0 * G;
 			if (longAcc < -9.0 * G) longAcc = -9.0 * G;
-			sprintf(cbuf, "Longitudinal acceleration: %.1f g", longAcc / G);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Longitudinal acceleration: %.1f g", longAcc / G);
 			yIndex += 1;
 
 			// Launch target pitch and yaw
 			VECTOR3 angVel;
 			GetAngularVel(angVel);
 
-			sprintf(cbuf, "Pitch rate: % .2f\u00B0/s (aim: %.1f\u00B0)", angVel.x * DEG, pitchAim * DEG);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Pitch rate: % .2f\u00B0/s (aim: %.1f\u00B0)", angVel.x * DEG, pitchAim * DEG);
 			yIndex += 1;
 
-			sprintf(cbuf, "Yaw rate: % .2f\u00B0/s", angVel.y * DEG);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Yaw rate: % .2f\u00B0/s", angVel.y * DEG);
 			yIndex += 1;
 
-			sprintf(cbuf, "Roll rate: % .2f\u00B0/s", angVel.z * DEG);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Roll rate: % .2f\u00B0/s", angVel.z * DEG);
 			yIndex += 1;
 
-			sprintf(cbuf, "  (% .1f RPM)", angVel.z / PI2 * 60.0);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  (% .1f RPM)", angVel.z / PI2 * 60.0);
 			yIndex += 1;
 
 			if (VesselStatus == STAGE2 && rcs_propellant[1] != NULL)
 			{
-				sprintf(cbuf, "Attitude fuel: %.1f %%", GetPropellantMass(rcs_propellant[1]) / STAGE2_RCS_FUEL_MASS * 100.0);
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Attitude fuel: %.1f %%", GetPropellantMass(rcs_propellant[1]) / STAGE2_RCS_FUEL_MASS * 100.0);
 				yIndex += 1;
 			}
 			else if (VesselStatus == STAGE3 && rcs_propellant[2] != NULL)
 			{
-				sprintf(cbuf, "Attitude fuel: %.1f %%", GetPropellantMass(rcs_propellant[2]) / STAGE3_RCS_FUEL_MASS * 100.0);
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Attitude fuel: %.1f %%", GetPropellantMass(rcs_propellant[2]) / STAGE3_RCS_FUEL_MASS * 100.0);
 				yIndex += 1;
 			}
 
@@ -830,70 +822,58 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 			OBJHANDLE base = oapiGetBaseByName(planet, "BDA");
 			if (base == NULL)
 			{
-				sprintf(cbuf, "You have not activated Mercury bases. Please");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "You have not activated Mercury bases. Please");
 				yIndex += 1;
 
-				sprintf(cbuf, "append the line:");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "append the line:");
 				yIndex += 1;
 
-				sprintf(cbuf, "DIR Earth\\Base\\ProjectMercury CONTEXT MercuryBases");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "DIR Earth\\Base\\ProjectMercury CONTEXT MercuryBases");
 				yIndex += 1;
 
-				sprintf(cbuf, "to the Config\\Earth.cfg file after the");
-				skp->Text(secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, "to the Config\\Earth.cfg file after the");
 				yIndex += 1;
 
-				sprintf(cbuf, "BEGIN_SURFBASE line and before the DIR Earth\\Base");
-				skp->Text(secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, "BEGIN_SURFBASE line and before the DIR Earth\\Base");
 				yIndex += 1;
 
-				sprintf(cbuf, "line.");
-				skp->Text(secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx* TextX0, yIndex* LineSpacing + TextY0, "line.");
 				yIndex += 1;
 			}
 			else
 			{
-				sprintf(cbuf, "Station         Acquisition  Loss         ");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Station         Acquisition  Loss         ");
 				yIndex += 1;
 
-				for (int i = 0; i < baseContactLogLength; i++)
+				int firstShown = max(0, int(baseContactLog.size()) - baseContactLogLength);
+				for (int idx = firstShown; idx < int(baseContactLog.size()); idx++)
 				{
-					int idx = (i + baseContactLogIdx) % baseContactLogLength;
+					double metContact = baseContactLog[idx].aos - launchTime;
+					if (metContact < 0.0) metContact = 0.0;
+					int metHC = (int)floor(metContact / 3600.0);
+					int metMC = (int)floor((metContact - metHC * 3600.0) / 60.0);
+					int metSC = (int)floor((metContact - metHC * 3600.0 - metMC * 60.0));
+
+					char contactTimeString[30], lossTimeString[30];
 
-					if (baseContactLog[idx].x != NULL) // check if something is registered
+					sprintf(contactTimeString, "%02i %02i %02i", metHC, metMC, metSC);
+
+					double metLoss = baseContactLog[idx].los - launchTime;
+					int metHL = (int)floor(metLoss / 3600.0);
+					int metML = (int)floor((metLoss - metHL * 3600.0) / 60.0);
+					int metSL = (int)floor((metLoss - metHL * 3600.0 - metML * 60.0));
+
+					sprintf(lossTimeString, "%02i %02i %02i", metHL, metML, metSL);
+
+					if (baseContactLog[idx].station == 3) // Cape Canaveral
+					{
+						hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "%s  %s     %s", BASE_NAME_LIST[baseContactLog[idx].station], contactTimeString, lossTimeString);
+					}
+					else // Mercury Tracking Site
 					{
-						double metContact = baseContactLog[idx].y - launchTime;
-						if (metContact < 0.0) metContact = 0.0;
-						int metHC = (int)floor(metContact / 3600.0);
-						int metMC = (int)floor((metContact - metHC * 3600.0) / 60.0);
-						int metSC = (int)floor((metContact - metHC * 3600.0 - metMC * 60.0));
-
-						char contactTimeString[30], lossTimeString[30];
-
-						sprintf(contactTimeString, "%02i %02i %02i", metHC, metMC, metSC);
-
-						double metLoss = baseContactLog[idx].z - launchTime;
-						int metHL = (int)floor(metLoss / 3600.0);
-						int metML = (int)floor((metLoss - metHL * 3600.0) / 60.0);
-						int metSL = (int)floor((metLoss - metHL * 3600.0 - metML * 60.0));
-
-						sprintf(lossTimeString, "%02i %02i %02i", metHL, metML, metSL);
-
-						if (baseContactLog[idx].x == 3) // Cape Canaveral
-						{
-							sprintf(cbuf, "%s  %s     %s", BASE_NAME_LIST[int(baseContactLog[idx].x)], contactTimeString, lossTimeString);
-						}
-						else // Mercury Tracking Site
-						{
-							sprintf(cbuf, "%s             %s     %s", BASE_NAME_LIST[int(baseContactLog[idx].x)], contactTimeString, lossTimeString);
-						}
-						skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
-						yIndex += 1;
+						hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "%s             %s     %s", BASE_NAME_LIST[baseContactLog[idx].station], contactTimeString, lossTimeString);
 					}
+					yIndex += 1;
 				}
 			}
 
@@ -901,8 +881,7 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		}
 		else
 		{
-			sprintf(cbuf, "No power");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "No power");
 			yIndex += 1;
 		}
 	}
@@ -1479,30 +1458,26 @@ void ProjectMercury::SeparateStage(int stageNum)
 	{
 		Local2Rel(_V(0,0,0), vs.rpos);
 		strcat(name, " Stage 1");
-		createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Scout\\Stage1", &vs);
+		debris.Create(name, "ProjectMercury\\Scout\\Stage1", &vs);
 	}
 	else if (stageNum == 2)
 	{
 		Local2Rel(_V(0,0,0), vs.rpos);
 		strcat(name, " Stage 2");
-		createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Scout\\Stage2", &vs);
+		debris.Create(name, "ProjectMercury\\Scout\\Stage2", &vs);
 		DelMesh(Skirt[0]);
 	}
 	else if (stageNum == 3)
 	{
 		Local2Rel(_V(0,0,0), vs.rpos);
 		strcat(name, " Stage 3");
-		createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Scout\\Stage3", &vs);
+		debris.Create(name, "ProjectMercury\\Scout\\Stage3", &vs);
 		DelMesh(Skirt[1]);
 		DelMesh(Skirt[2]);
 	}
 
-	if (GetAltitude() > 5e4)
-		createdAbove50km[stuffCreated] = true;
-	stuffCreated += 1;
-
 	// The thrusterlist spec doesnt seem to work, sadly
-	VESSEL* v = oapiGetVesselInterface(createdVessel[stuffCreated - 1]);
+	VESSEL* v = oapiGetVesselInterface(debris.Last());
 	double levl = GetPropellantMass(scout_propellant[stageNum - 1]);
 	v->SetPropellantMass(v->GetPropellantHandleByIndex(0), levl);
 	if (GetThrusterLevel(th_main[stageNum - 1]) != 0.0)
@@ -1572,10 +1547,7 @@ void ProjectMercury::SeparateFairing(void)
 		vs.rvel += vel2;
 		strcpy(name, GetName());
 		strcat(name, " Fairing 1");
-		createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Scout\\Fairing1", &vs);
-		if (GetAltitude() > 5e4)
-			createdAbove50km[stuffCreated] = true;
-		stuffCreated += 1;
+		debris.Create(name, "ProjectMercury\\Scout\\Fairing1", &vs);
 		DelMesh(Fairing[0]);
 
 		vel = _V(fairingSepSpeed, 0.0, 0);
@@ -1586,10 +1558,7 @@ void ProjectMercury::SeparateFairing(void)
 		vs.rvel += vel2;
 		strcpy(name, GetName());
 		strcat(name, " Fairing 2");
-		createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Scout\\Fairing2", &vs);
-		if (GetAltitude() > 5e4)
-			createdAbove50km[stuffCreated] = true;
-		stuffCreated += 1;
+		debris.Create(name, "ProjectMercury\\Scout\\Fairing2", &vs);
 		DelMesh(Fairing[1]);
 
 		FairingStatus = FAIRINGOFF;
@@ -1673,21 +1642,35 @@ void ProjectMercury::BaseContactManager(void)
 	double simt = oapiGetSimTime();
 
 	OBJHANDLE planet = GetSurfaceRef();
-	OBJHANDLE base;
+
+	// Look up the bases only once. They don't change during the simulation
+	if (planet != baseHandlePlanet)
+	{
+		baseHandlePlanet = planet;
+		int basesFound = 0;
+		for (int i = 0; i < NUMBASES; i++)
+		{
+			baseHandle[i] = oapiGetBaseByName(planet, BASE_NAME_LIST[i]);
+			if (baseHandle[i] != NULL) basesFound += 1;
+		}
+		oapiWriteLogV("Scout found %i of %i network bases", basesFound, NUMBASES);
+	}
+
+	VECTOR3 capsulePlanet;
+	GetRelativePos(planet, capsulePlanet);
+	double radius2 = length2(capsulePlanet);
 
 	for (int i = 0; i < NUMBASES; i++)
 	{
-		base = oapiGetBaseByName(planet, BASE_NAME_LIST[i]);
+		OBJHANDLE base = baseHandle[i];
 		if (base != NULL) // sanity check
 		{
 			double baseLongitude, baseLatitude, baseRadius;
 			oapiGetBaseEquPos(base, &baseLongitude, &baseLatitude, &baseRadius);
 
-			VECTOR3 capsuleBase, capsulePlanet;
+			VECTOR3 capsuleBase;
 			GetRelativePos(base, capsuleBase);
 			double distToBase2 = length2(capsuleBase);
-			GetRelativePos(planet, capsulePlanet);
-			double radius2 = length2(capsulePlanet);
 
 			// Simple extention of Pythagoras. 64e8 is 8e4^2. So within 80 km, we have contact. Useful for launchpad situations and landings.
 			// Even if outside visual range, we can still be within radio contact. 80 km limit is arbitrary.
@@ -1696,19 +1679,21 @@ void ProjectMercury::BaseContactManager(void)
 			{
 				if (!baseInContact[i]) // just appeared
 				{
-					baseContactTime[i][baseContactsNum[i]] = simt;
+					baseContactTime[i] = simt;
 				}
 
 				baseInContact[i] = true;
 			}
 			else if (baseInContact[i])
 			{
-				baseLossTime[i][baseContactsNum[i]] = simt;
-
 				if (sattelitePoweredOn)
 				{
-					baseContactLog[baseContactLogIdx] = { double(i), baseContactTime[i][baseContactsNum[i]], baseLossTime[i][baseContactsNum[i]] }; // Conversion from int to double, and then back to int later. Hope this goes well.
-					baseContactLogIdx = (baseContactLogIdx + 1) % baseContactLogLength;
+					BASECONTACT pass = { i, baseContactTime[i], simt };
+					baseContactLog.push_back(pass);
+					baseContactUnwritten += 1;
+
+					if (baseContactUnwritten >= baseContactChunkLength)
+						WriteBaseContactLog();
 				}
 
 				baseContactsNum[i] += 1;
@@ -1718,6 +1703,43 @@ void ProjectMercury::BaseContactManager(void)
 	}
 }
 
+// Append unwritten passes to file, and only keep the last few in memory for the HUD
+void ProjectMercury::WriteBaseContactLog(void)
+{
+	if (baseContactUnwritten == 0) return;
+
+	char logFile[MAX_PATH];
+	CreateDirectoryA(FLIGHT_OUTPUT_FOLDER, NULL); // fails if it exists, which is fine
+	sprintf(logFile, "%s\\%s", FLIGHT_OUTPUT_FOLDER, BASE_CONTACT_LOG_FILE);
+
+	std::ofstream outfile;
+	outfile.open(logFile, std::ios_base::app); // app = append
+	if (!outfile.is_open())
+	{
+		oapiWriteLogV("Scout could not open %s. Keeping %i passes in memory.", logFile, baseContactUnwritten);
+		return;
+	}
+
+	if (!baseContactLogStarted)
+	{
+		outfile << "# " << GetName() << ", launch simt " << launchTime << "\n";
+		outfile << "# Station, AOS MET, LOS MET\n";
+		baseContactLogStarted = true;
+	}
+
+	char cbuf[256];
+	for (int i = int(baseContactLog.size()) - baseContactUnwritten; i < int(baseContactLog.size()); i++)
+	{
+		sprintf(cbuf, "%s, %.1f, %.1f\n", BASE_NAME_LIST[baseContactLog[i].station], baseContactLog[i].aos - launchTime, baseContactLog[i].los - launchTime);
+		outfile << cbuf;
+	}
+	outfile.close();
+	baseContactUnwritten = 0;
+
+	if (int(baseContactLog.size()) > baseContactLogLength)
+		baseContactLog.erase(baseContactLog.begin(), baseContactLog.end() - baseContactLogLength);
+}
+
 void ProjectMercury::CreateAirfoilsScout(void)
 {
 	ClearAirfoilDefinitions(); // delete previous airfoils
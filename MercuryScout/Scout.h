@@ -13,6 +13,9 @@
 // 
 // ==============================================================
 
+#include <vector> // for base contact log
+#include <fstream> // for writing base contact log to file
+
 //FILEHANDLE pitchDataLogFile;
 
 // ==============================================================
@@ -164,7 +167,15 @@ const double pitchRateAim[pitchRateEntries] =	{ 0.00, -2.0, -0.60, -0.40, -0.10,
 
 const int NUMBASES = 17;
 char BASE_NAME_LIST[NUMBASES][15] = { "ATS", "BDA", "CAL", "Cape Canaveral", "CSQ", "CTN", "CYI", "GYM", "HAW", "IOS", "KNO", "MUC", "RKV", "RTK", "TEX", "WOM", "ZZB" };
-const int baseContactLogLength = 10;
+const int baseContactLogLength = 10; // passes kept in memory for the HUD
+const int baseContactChunkLength = 64; // passes written to disk at once
+const char BASE_CONTACT_LOG_FILE[] = "MercuryScoutContactLog.txt"; // in FLIGHT_OUTPUT_FOLDER
+
+typedef struct basecontact {
+	int station; // index in BASE_NAME_LIST
+	double aos; // simt
+	double los; // simt
+} BASECONTACT;
 
 class ProjectMercury : public VESSELVER {
 public:
@@ -193,6 +204,7 @@ public:
 	void CreateStage3RCS(void);
 
 	void BaseContactManager(void);
+	void WriteBaseContactLog(void);
 
 	void VersionDependentTouchdown(VECTOR3 touch1, VECTOR3 touch2, VECTOR3 touch3, VECTOR3 touch4, double stiff, double damp, double mu);
 	void VersionDependentPanelClick(int id, const RECT& pos, int texidx, int draw_event, int mouse_event, PANELHANDLE hPanel, const RECT& texpos, int bkmode);
@@ -224,7 +236,6 @@ public:
 	double NormAngleDeg(double ang);
 	// End random number
 	bool InRadioContact(OBJHANDLE planet);
-	void DeleteRogueVessels(void);
 	double MnA2TrA(double MnA, double Ecc);
 	double TrA2MnA(double TrA, double Ecc);
 	double EccentricAnomaly(double ecc, double TrA);
@@ -285,12 +296,14 @@ private:
 	// Battery
 	double batteryLevel = BATTERY_TOTAL_CHARGE;
 	// Network bases, contact
-	double baseContactTime[NUMBASES][20] = { NULL };
-	double baseLossTime[NUMBASES][20] = { NULL };
+	OBJHANDLE baseHandle[NUMBASES] = { NULL };
+	OBJHANDLE baseHandlePlanet = NULL; // planet which baseHandle was resolved for
+	double baseContactTime[NUMBASES] = { 0.0 }; // AOS of current pass
 	bool baseInContact[NUMBASES] = { false };
 	int baseContactsNum[NUMBASES] = { 0 };
-	VECTOR3 baseContactLog[baseContactLogLength] = { NULL };
-	int baseContactLogIdx = 0;
+	std::vector<BASECONTACT> baseContactLog; // passes not yet written to disk, plus the last baseContactLogLength passes for the HUD
+	int baseContactUnwritten = 0; // number of passes at end of baseContactLog not yet written to disk
+	bool baseContactLogStarted = false;
 
 	bool spaceLaunch = false;
 	bool autopilot = false;
@@ -323,7 +336,7 @@ private:
 	double timeOfError = 1e10;
 	bool difficultyHard = false;
 
-	int stuffCreated = 0;
-	OBJHANDLE createdVessel[25]; // number is close to 20, but don't bother counting exactly
+	DebrisManager debris; // everything we have separated. See DebrisManager.h
+	HudTextCache hudText; // formatted HUD lines. See HudTextCache.h
 	bool createdAbove50km[25] = { false };
 };
\ No newline at end of file
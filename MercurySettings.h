@@ -0,0 +1,220 @@
+#pragma once
+#include <stdio.h>
+#include <string.h>
+
+// ==============================================================
+//		Settings from Config\Vessels\ProjectMercury\ProjectMercuryCommon.cfg
+//
+// Previously every vessel opened and read the common config in clbkSetClassCaps. Now the first vessel reads it,
+// and all later vessels from the same module get the same settings object.
+// Missing required or odd values are collected and written to Orbiter.log as one list, instead of one line per item per vessel.
+//
+// Usage:
+//		const MercurySettings& settings = MercurySettings::Get(cfg);
+//		timeStepLimit = settings.timeStepLimit;
+// ==============================================================
+
+const int SETTINGS_MAX_CAPSULES = 10; // DEFINENEWCAPSULE0 to 9, same as NUMBER_SUPPORTED_CONFIG_CAPSULES
+const int SETTINGS_CAPSULE_LENGTH = 1000;
+const int SETTINGS_WARNING_LENGTH = 1024;
+
+class MercurySettings
+{
+public:
+	// All values are the defaults if not in config
+	int hud2ndColumnPos = 28;
+	double timeStepLimit = 0.1;
+	bool mercuryNetwork = true;
+	double joystickThresholdLow = 0.33;
+	double joystickThresholdHigh = 0.75;
+	double ASCSstdDev = 0.25; // deg/s
+	double RSCSstdDev = 1.0; // deg/s
+	double RSCSresolution = 3.0; // deg
+	double RSCSmax = 10.0; // deg/s
+	bool actionWarpReduction = false; // lower time acceleration near queued actions
+	double panelMaxRate = 0.0; // Hz, 0 is no limit
+	double debrisMaxDistance = DEBRIS_DEFAULT_DISTANCE;
+	double debrisMaxAge = 0.0;
+	double debrisRestSpeed = 0.0;
+	double debrisHorizonDistance = 0.0;
+	char recorderChannels[100] = "ALL"; // see FlightRecorder.h
+	double recorderRate = 0.0; // Hz, 0 is off
+
+	bool capsuleDefined[SETTINGS_MAX_CAPSULES] = { false };
+	char capsuleDefinition[SETTINGS_MAX_CAPSULES][SETTINGS_CAPSULE_LENGTH] = { { 0 } }; // raw DEFINENEWCAPSULEx line
+
+	bool foundCommonFile = false;
+
+	// fallbackCfg is only used if the common config file is missing, and only by the first vessel.
+	static const MercurySettings& Get(FILEHANDLE fallbackCfg)
+	{
+		static MercurySettings settings;
+		if (!settings.loaded)
+			settings.Load(fallbackCfg);
+
+		return settings;
+	}
+
+private:
+	void Load(FILEHANDLE fallbackCfg)
+	{
+		loaded = true;
+		warnings[0] = '\0';
+
+		FILEHANDLE cfg = oapiOpenFile("Vessels\\ProjectMercury\\ProjectMercuryCommon.cfg", FILE_IN_ZEROONFAIL, CONFIG);
+		foundCommonFile = (cfg != 0);
+		if (!foundCommonFile)
+		{
+			oapiWriteLog("ProjectMercuryCommon config file missing!");
+			cfg = fallbackCfg; // maybe there's some data we can read from there, so use it as backup
+		}
+
+		ReadInt(cfg, "HUD2ndColumnPos", hud2ndColumnPos);
+		ReadFloat(cfg, "TimeStepLimit", timeStepLimit);
+		ReadBool(cfg, "MercuryNetwork", mercuryNetwork);
+		ReadFloat(cfg, "JoysticThrustThresholdLow", joystickThresholdLow);
+		ReadFloat(cfg, "JoysticThrustThresholdHigh", joystickThresholdHigh);
+		ReadFloat(cfg, "StandardDevRateASCS", ASCSstdDev);
+		ReadFloat(cfg, "StandardDevRateRSCS", RSCSstdDev);
+		ReadFloat(cfg, "RSCSresolution", RSCSresolution);
+		ReadFloat(cfg, "RSCSmaxRate", RSCSmax);
+		ReadOptionalBool(cfg, "ActionWarpReduction", actionWarpReduction);
+		ReadOptionalFloat(cfg, "PanelMaxRate", panelMaxRate);
+		ReadOptionalFloat(cfg, "DebrisMaxDistance", debrisMaxDistance);
+		ReadOptionalFloat(cfg, "DebrisMaxAge", debrisMaxAge);
+		ReadOptionalFloat(cfg, "DebrisRestSpeed", debrisRestSpeed);
+		ReadOptionalFloat(cfg, "DebrisHorizonDistance", debrisHorizonDistance);
+		ReadOptionalString(cfg, "RecorderChannels", recorderChannels);
+		ReadOptionalFloat(cfg, "RecorderRate", recorderRate);
+
+		for (int i = 0; i < SETTINGS_MAX_CAPSULES; i++)
+		{
+			char key[20];
+			sprintf(key, "DEFINENEWCAPSULE%i", i);
+			capsuleDefined[i] = oapiReadItem_string(cfg, key, capsuleDefinition[i]);
+		}
+
+		if (foundCommonFile) oapiCloseFile(cfg, FILE_IN_ZEROONFAIL); // don't close if the regular cfg file
+
+		Validate();
+
+		if (numMissing > 0)
+			oapiWriteLogV("Mercury common config: %i items not found, using default for:%s", numMissing, missing);
+		if (warnings[0] != '\0')
+			oapiWriteLogV("Mercury common config warnings:%s", warnings);
+	}
+
+	// Sanity check values, and go back to default if they make no sense
+	void Validate(void)
+	{
+		if (hud2ndColumnPos < 0)
+		{
+			Warn("HUD2ndColumnPos negative");
+			hud2ndColumnPos = 28;
+		}
+
+		if (timeStepLimit <= 0.0)
+		{
+			Warn("TimeStepLimit not positive");
+			timeStepLimit = 0.1;
+		}
+
+		if (joystickThresholdLow < 0.0 || joystickThresholdHigh > 1.0 || joystickThresholdLow >= joystickThresholdHigh)
+		{
+			Warn("JoysticThrustThreshold must be 0 <= Low < High <= 1");
+			joystickThresholdLow = 0.33;
+			joystickThresholdHigh = 0.75;
+		}
+
+		if (ASCSstdDev < 0.0 || RSCSstdDev < 0.0)
+		{
+			Warn("StandardDevRate negative");
+			if (ASCSstdDev < 0.0) ASCSstdDev = 0.25;
+			if (RSCSstdDev < 0.0) RSCSstdDev = 1.0;
+		}
+
+		if (RSCSresolution <= 0.0 || RSCSmax <= 0.0)
+		{
+			Warn("RSCSresolution and RSCSmaxRate must be positive");
+			if (RSCSresolution <= 0.0) RSCSresolution = 3.0;
+			if (RSCSmax <= 0.0) RSCSmax = 10.0;
+		}
+
+		if (panelMaxRate < 0.0)
+		{
+			Warn("PanelMaxRate negative, no limit used");
+			panelMaxRate = 0.0;
+		}
+
+		if (debrisMaxDistance < 0.0 || debrisMaxAge < 0.0 || debrisRestSpeed < 0.0 || debrisHorizonDistance < 0.0)
+			Warn("Debris values negative, that rule is off");
+
+		if (recorderRate < 0.0)
+		{
+			Warn("RecorderRate negative, recorder off");
+			recorderRate = 0.0;
+		}
+	}
+
+	void ReadInt(FILEHANDLE cfg, const char* key, int& value)
+	{
+		if (!oapiReadItem_int(cfg, (char*)key, value)) Missing(key);
+	}
+
+	void ReadFloat(FILEHANDLE cfg, const char* key, double& value)
+	{
+		if (!oapiReadItem_float(cfg, (char*)key, value)) Missing(key);
+	}
+
+	// For keys that are off or at their default unless the user sets them, so their absence is not reported
+	void ReadOptionalFloat(FILEHANDLE cfg, const char* key, double& value)
+	{
+		oapiReadItem_float(cfg, (char*)key, value);
+	}
+
+	void ReadOptionalBool(FILEHANDLE cfg, const char* key, bool& value)
+	{
+		oapiReadItem_bool(cfg, (char*)key, value);
+	}
+
+	void ReadOptionalString(FILEHANDLE cfg, const char* key, char* value)
+	{
+		oapiReadItem_string(cfg, (char*)key, value);
+	}
+
+	void ReadBool(FILEHANDLE cfg, const char* key, bool& value)
+	{
+		if (!oapiReadItem_bool(cfg, (char*)key, value)) Missing(key);
+	}
+
+	void ReadString(FILEHANDLE cfg, const char* key, char* value)
+	{
+		if (!oapiReadItem_string(cfg, (char*)key, value)) Missing(key);
+	}
+
+	void Missing(const char* key)
+	{
+		numMissing += 1;
+		Append(missing, " ", key);
+	}
+
+	void Warn(const char* text)
+	{
+		Append(warnings, (warnings[0] == '\0') ? " " : "; ", text);
+	}
+
+	void Append(char* list, const char* separator, const char* text)
+	{
+		size_t len = strlen(list);
+		if (len + strlen(separator) + strlen(text) + 1 < SETTINGS_WARNING_LENGTH)
+		{
+			strcat(list, separator);
+			strcat(list, text);
+		}
+	}
+
+	bool loaded = false;
+	int numMissing = 0;
+	char missing[SETTINGS_WARNING_LENGTH] = "";
+	char warnings[SETTINGS_WARNING_LENGTH] = "";
+};
@@ -0,0 +1,19 @@
+#pragma once
+#include <chrono>
+
+// ==============================================================
+//		Wall clock for timing our own code
+//
+// Previously DebrisManager and the panel each had their own QueryPerformanceCounter helper, and the profiler used
+// std::chrono. Now all of them use these. steady_clock is QueryPerformanceCounter on MSVC.
+// ==============================================================
+
+inline long long MercuryTimerNs(void)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline double MercuryTimerMs(void)
+{
+	return double(MercuryTimerNs()) * 1e-6;
+}
@@ -0,0 +1,391 @@
+// PassScheduleTool.cpp : This file contains the 'main' function. Program execution begins and ends there.
+//
+// Created by Asbjrn ("asbjos" on Orbiter-Forum).
+// This program is included in the Project Mercury X package
+//
+// It is used to plan the radio contact with the Mercury tracking network for a full mission, without having to run Orbiter at time acceleration.
+// From the insertion point (where SECO / capsule separation happens, assumed to be at perigee), it propagates the orbit with J2 perturbations,
+// and finds every pass over every station, with acquisition (AOS), loss (LOS), maximum elevation and duration.
+// The output is a CSV timeline sorted by AOS.
+//
+// Contact criterion is the same as in the simulator, i.e. station sees the capsule above its horizon (elevation > 0 deg).
+// J2 is the standard first order secular perturbation (nodal regression, apsidal rotation and mean motion change) with J2 = 1.08263e-3.
+//
+// Standalone, and does not need Orbiter. Compile on Linux with:
+//		g++ -O2 -std=c++11 -pthread PassScheduleTool.cpp -o PassScheduleTool
+//
+// Usage:
+//		PassScheduleTool [-i lat long azimuth perigee apogee] [-m insertionMET] [-d hours] [-s stationfile] [-e minElevation] [-t threads] [-o output.csv]
+// Angles in degrees, altitudes in km, insertion MET in seconds. Station file has one station per line: "CODE latitude longitude", and # for comments.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+const double PI = 3.1415926535897932384626;
+const double PI2 = PI * 2.0;
+const double PI05 = PI / 2.0;
+const double RAD = PI / 180.0;
+const double DEG = 180.0 / PI;
+
+const double planetRad = 6371.01e3; // same as Orbiter Earth
+const double planetMu = 3.986004418e14;
+const double planetJ2 = 1.08263e-3;
+const double planetSiderealDay = 86164.1;
+
+typedef struct station {
+	char name[32];
+	double lat; // radians
+	double lon; // radians
+	double pos[3]; // Earth fixed
+} STATION;
+
+typedef struct pass {
+	int station;
+	double aos; // MET seconds
+	double los;
+	double maxElevation; // radians
+	double maxElevationTime;
+} PASS;
+
+// Mercury network. Land stations are approximate. Ship positions varied from mission to mission, so here are positions close to MA-9.
+// Add or move them with a station file
+const int NUMDEFAULTSTATIONS = 17;
+const char defaultStationName[NUMDEFAULTSTATIONS][32] = { "CNV", "BDA", "ATS", "CYI", "KNO", "ZZB", "IOS", "MUC", "WOM", "CTN", "HAW", "CAL", "GYM", "TEX", "CSQ", "RKV", "RTK" };
+const double defaultStationLat[NUMDEFAULTSTATIONS] = { 28.47, 32.35, 27.50, 27.74, 12.05, -6.23, -25.00, -31.60, -31.38, -2.81, 22.13, 34.58, 27.96, 27.65, 27.00, 28.00, 12.00 };
+const double defaultStationLon[NUMDEFAULTSTATIONS] = { -80.55, -64.65, -44.00, -15.60, 8.53, 39.22, 60.00, 115.94, 136.88, -171.72, -159.67, -120.56, -110.72, -97.38, 129.00, -124.00, -178.00 };
+
+// Orbit at insertion, and secular J2 rates
+typedef struct orbit {
+	double a, e, i, LAN, APe, MnA0;
+	double n; // perturbed mean motion
+	double dLAN, dAPe; // rad/s
+} ORBIT;
+
+// TrA in radians
+inline double EccentricAnomaly(double ecc, double TrA)
+{
+	return 2.0 * atan(sqrt((1.0 - ecc) / (1.0 + ecc)) * tan(TrA / 2.0));
+}
+
+// Kepler's equation, Newton iterations
+inline double SolveKepler(double M, double ecc)
+{
+	double E = M + ecc * sin(M);
+	for (int i = 0; i < 8; i++)
+	{
+		E -= (E - ecc * sin(E) - M) / (1.0 - ecc * cos(E));
+	}
+	return E;
+}
+
+// Insertion at perigee, with horizontal velocity in direction azimuth
+ORBIT InsertionOrbit(double lat, double lon, double azimuth, double perigeeAlt, double apogeeAlt)
+{
+	ORBIT orb;
+	double rp = planetRad + perigeeAlt;
+	double ra = planetRad + apogeeAlt;
+	orb.a = (rp + ra) / 2.0;
+	orb.e = (ra - rp) / (ra + rp);
+
+	// Spherical trigonometry. Insertion point is at argument of latitude u, and we're at perigee, so APe = u
+	orb.i = acos(cos(lat) * sin(azimuth));
+	double u = atan2(sin(lat), cos(lat) * cos(azimuth));
+	double dLon = atan2(sin(u) * cos(orb.i), cos(u));
+	orb.LAN = lon - dLon; // Earth fixed frame equal to inertial frame at insertion
+	orb.APe = u;
+	orb.MnA0 = 0.0;
+
+	// Standard secular J2 rates of LAN, argument of perigee and mean anomaly, from planetJ2, planetRad and the orbit's semi-latus rectum
+	double n0 = sqrt(planetMu / pow(orb.a, 3.0));
+	double p = orb.a * (1.0 - orb.e * orb.e);
+	double k = 1.5 * planetJ2 * pow(planetRad / p, 2.0);
+	orb.n = n0 * (1.0 + k * sqrt(1.0 - orb.e * orb.e) * (1.0 - 1.5 * pow(sin(orb.i), 2.0)));
+	orb.dLAN = -k * n0 * cos(orb.i);
+	orb.dAPe = 0.5 * k * n0 * (5.0 * pow(cos(orb.i), 2.0) - 1.0);
+
+	return orb;
+}
+
+// Earth fixed position t seconds after insertion
+inline void PositionAtTime(const ORBIT& orb, double t, double* pos)
+{
+	double M = fmod(orb.MnA0 + orb.n * t, PI2);
+	double E = SolveKepler(M, orb.e);
+	double TrA = 2.0 * atan2(sqrt(1.0 + orb.e) * sin(E / 2.0), sqrt(1.0 - orb.e) * cos(E / 2.0));
+	double r = orb.a * (1.0 - orb.e * cos(E));
+
+	double LAN = orb.LAN + orb.dLAN * t - PI2 / planetSiderealDay * t; // subtract Earth rotation
+	double u = orb.APe + orb.dAPe * t + TrA;
+
+	pos[0] = r * (cos(u) * cos(LAN) - sin(u) * sin(LAN) * cos(orb.i));
+	pos[1] = r * (cos(u) * sin(LAN) + sin(u) * cos(LAN) * cos(orb.i));
+	pos[2] = r * sin(u) * sin(orb.i);
+}
+
+inline double ElevationAngle(const STATION& st, const double* pos)
+{
+	double rho[3] = { pos[0] - st.pos[0], pos[1] - st.pos[1], pos[2] - st.pos[2] };
+	double rhoLength = sqrt(rho[0] * rho[0] + rho[1] * rho[1] + rho[2] * rho[2]);
+	double up = (rho[0] * st.pos[0] + rho[1] * st.pos[1] + rho[2] * st.pos[2]) / planetRad;
+	return asin(up / rhoLength);
+}
+
+inline double ElevationAtTime(const ORBIT& orb, const STATION& st, double t)
+{
+	double pos[3];
+	PositionAtTime(orb, t, pos);
+	return ElevationAngle(st, pos);
+}
+
+// Find time where elevation crosses minElevation, between tLow and tHigh. Bisection to 0.1 seconds
+double FindCrossing(const ORBIT& orb, const STATION& st, double tLow, double tHigh, double minElevation)
+{
+	bool lowVisible = ElevationAtTime(orb, st, tLow) > minElevation;
+	while (tHigh - tLow > 0.1)
+	{
+		double tMid = (tLow + tHigh) / 2.0;
+		if ((ElevationAtTime(orb, st, tMid) > minElevation) == lowVisible) tLow = tMid;
+		else tHigh = tMid;
+	}
+	return (tLow + tHigh) / 2.0;
+}
+
+// Golden section search for max elevation around a sampled maximum
+double FindMaxElevation(const ORBIT& orb, const STATION& st, double tLow, double tHigh, double* tMax)
+{
+	const double gr = (sqrt(5.0) - 1.0) / 2.0;
+	double c = tHigh - gr * (tHigh - tLow);
+	double d = tLow + gr * (tHigh - tLow);
+	while (tHigh - tLow > 0.5)
+	{
+		if (ElevationAtTime(orb, st, c) > ElevationAtTime(orb, st, d)) tHigh = d;
+		else tLow = c;
+		c = tHigh - gr * (tHigh - tLow);
+		d = tLow + gr * (tHigh - tLow);
+	}
+	*tMax = (tLow + tHigh) / 2.0;
+	return ElevationAtTime(orb, st, *tMax);
+}
+
+void StationPasses(const ORBIT& orb, const STATION& st, int stationIdx, double duration, double minElevation, std::vector<PASS>* passes)
+{
+	const double dt = 5.0; // shortest pass at 160 km is much longer than this
+
+	bool visible = ElevationAtTime(orb, st, 0.0) > minElevation;
+	PASS current = { stationIdx, 0.0, 0.0, -PI05, 0.0 };
+	double bestSampleTime = 0.0;
+
+	for (double t = 0.0; t < duration; t += dt)
+	{
+		double tNext = std::min(t + dt, duration);
+		double elevation = ElevationAtTime(orb, st, tNext);
+
+		if (visible && elevation > current.maxElevation)
+		{
+			current.maxElevation = elevation;
+			bestSampleTime = tNext;
+		}
+
+		if ((elevation > minElevation) != visible)
+		{
+			double tCross = FindCrossing(orb, st, t, tNext, minElevation);
+			if (!visible) // AOS
+			{
+				current.aos = tCross;
+				current.maxElevation = elevation;
+				bestSampleTime = tNext;
+			}
+			else // LOS
+			{
+				current.los = tCross;
+				double tMaxLow = std::max(current.aos, bestSampleTime - dt);
+				double tMaxHigh = std::min(current.los, bestSampleTime + dt);
+				current.maxElevation = FindMaxElevation(orb, st, tMaxLow, tMaxHigh, &current.maxElevationTime);
+				passes->push_back(current);
+			}
+			visible = !visible;
+		}
+	}
+
+	if (visible) // still in contact at end of mission
+	{
+		current.los = duration;
+		current.maxElevationTime = bestSampleTime;
+		passes->push_back(current);
+	}
+}
+
+bool ReadStationFile(const char* fileName, std::vector<STATION>* stations)
+{
+	std::ifstream infile(fileName);
+	if (!infile.is_open()) return false;
+
+	std::string line;
+	while (std::getline(infile, line))
+	{
+		if (line.empty() || line[0] == '#') continue;
+
+		std::istringstream lineStream(line);
+		std::string name;
+		double lat, lon;
+		if (lineStream >> name >> lat >> lon)
+		{
+			STATION st;
+			snprintf(st.name, sizeof(st.name), "%s", name.c_str());
+			st.lat = lat * RAD;
+			st.lon = lon * RAD;
+			stations->push_back(st);
+		}
+		else
+		{
+			std::cerr << "Could not read station line >" << line << "<\n";
+		}
+	}
+	return true;
+}
+
+void MetString(double met, char* out)
+{
+	int metH = (int)floor(met / 3600.0);
+	int metM = (int)floor((met - metH * 3600.0) / 60.0);
+	int metS = (int)floor((met - metH * 3600.0 - metM * 60.0));
+	sprintf(out, "%02i:%02i:%02i", metH, metM, metS);
+}
+
+int main(int argc, char* argv[])
+{
+	// Default is MA-6 insertion, 3 orbits
+	double insLat = 31.0, insLon = -72.0, insAzimuth = 72.0, perigeeAlt = 159.0e3, apogeeAlt = 265.0e3;
+	double insertionMET = 5.0 * 60.0 + 4.0;
+	double durationHours = 4.9;
+	double minElevation = 0.0;
+	int numThreads = std::max(1, int(std::thread::hardware_concurrency()));
+	const char* stationFile = NULL;
+	const char* outputFile = NULL;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-i") == 0 && i + 5 < argc)
+		{
+			insLat = atof(argv[i + 1]);
+			insLon = atof(argv[i + 2]);
+			insAzimuth = atof(argv[i + 3]);
+			perigeeAlt = atof(argv[i + 4]) * 1e3;
+			apogeeAlt = atof(argv[i + 5]) * 1e3;
+			i += 5;
+		}
+		else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) insertionMET = atof(argv[++i]);
+		else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) durationHours = atof(argv[++i]);
+		else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) minElevation = atof(argv[++i]);
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) numThreads = std::max(1, atoi(argv[++i]));
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) stationFile = argv[++i];
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) outputFile = argv[++i];
+		else
+		{
+			std::cerr << "Pass Schedule Tool\n";
+			std::cerr << "Usage: " << argv[0] << " [-i lat long azimuth perigee apogee] [-m insertionMET] [-d hours] [-s stationfile] [-e minElevation] [-t threads] [-o output.csv]\n";
+			std::cerr << "Angles in degrees, altitudes in km, insertion MET in seconds. Default is MA-6 insertion and three orbits.\n";
+			return 1;
+		}
+	}
+
+	if (apogeeAlt < perigeeAlt)
+	{
+		std::cerr << "Apogee must be higher than perigee, as insertion is assumed at perigee.\n";
+		return 1;
+	}
+
+	std::vector<STATION> stations;
+	if (stationFile != NULL)
+	{
+		if (!ReadStationFile(stationFile, &stations))
+		{
+			std::cerr << "Could not open station file " << stationFile << "\n";
+			return 1;
+		}
+	}
+	else
+	{
+		for (int i = 0; i < NUMDEFAULTSTATIONS; i++)
+		{
+			STATION st;
+			strcpy(st.name, defaultStationName[i]);
+			st.lat = defaultStationLat[i] * RAD;
+			st.lon = defaultStationLon[i] * RAD;
+			stations.push_back(st);
+		}
+	}
+
+	for (size_t i = 0; i < stations.size(); i++)
+	{
+		stations[i].pos[0] = planetRad * cos(stations[i].lat) * cos(stations[i].lon);
+		stations[i].pos[1] = planetRad * cos(stations[i].lat) * sin(stations[i].lon);
+		stations[i].pos[2] = planetRad * sin(stations[i].lat);
+	}
+
+	ORBIT orb = InsertionOrbit(insLat * RAD, insLon * RAD, insAzimuth * RAD, perigeeAlt, apogeeAlt);
+	double duration = durationHours * 3600.0 - insertionMET;
+
+	std::cerr << "Orbit: a " << orb.a / 1e3 << " km, e " << orb.e << ", i " << orb.i * DEG << " deg, period " << PI2 / orb.n / 60.0 << " min\n";
+	std::cerr << "Computing passes for " << stations.size() << " stations over " << durationHours << " hours, using " << numThreads << " threads\n";
+
+	// Each station is independent, so split them between threads
+	std::vector<std::vector<PASS>> stationPasses(stations.size());
+	std::atomic<int> nextStation(0);
+	std::vector<std::thread> workers;
+	for (int w = 0; w < numThreads; w++)
+	{
+		workers.push_back(std::thread([&]()
+		{
+			int idx;
+			while ((idx = nextStation.fetch_add(1)) < int(stations.size()))
+			{
+				StationPasses(orb, stations[idx], idx, duration, minElevation * RAD, &stationPasses[idx]);
+			}
+		}));
+	}
+	for (size_t w = 0; w < workers.size(); w++) workers[w].join();
+
+	std::vector<PASS> passes;
+	for (size_t i = 0; i < stationPasses.size(); i++)
+		passes.insert(passes.end(), stationPasses[i].begin(), stationPasses[i].end());
+	std::sort(passes.begin(), passes.end(), [](const PASS& p1, const PASS& p2) { return p1.aos < p2.aos; });
+
+	std::ofstream outfile;
+	if (outputFile != NULL)
+	{
+		outfile.open(outputFile);
+		if (!outfile.is_open())
+		{
+			std::cerr << "Could not open output file " << outputFile << "\n";
+			return 1;
+		}
+	}
+	std::ostream& out = outputFile != NULL ? outfile : std::cout;
+
+	out << "station,aos_met_s,los_met_s,aos_met,los_met,max_elevation_deg,max_elevation_met,duration_s\n";
+	for (size_t i = 0; i < passes.size(); i++)
+	{
+		char aosString[20], losString[20], maxString[20], cbuf[256];
+		double aos = passes[i].aos + insertionMET;
+		double los = passes[i].los + insertionMET;
+		MetString(aos, aosString);
+		MetString(los, losString);
+		MetString(passes[i].maxElevationTime + insertionMET, maxString);
+		sprintf(cbuf, "%s,%.1f,%.1f,%s,%s,%.2f,%s,%.1f\n", stations[passes[i].station].name, aos, los, aosString, losString, passes[i].maxElevation * DEG, maxString, los - aos);
+		out << cbuf;
+	}
+
+	std::cerr << passes.size() << " passes found\n";
+	return 0;
+}
@@ -19,6 +19,8 @@
 
 #include "orbitersdk.h"
 
+#include "..\..\DebrisManager.h"
+#include "..\..\HudTextCache.h"
 #include "MercuryOnlyCapsule.h"
 #include "..\samples\Experiments\ShuttlePBforReal\ShuttlePBforReal\MercuryCapsule.h"
 
@@ -514,7 +516,7 @@ void ProjectMercury::clbkPreStep(double simt, double simdt, double mjd)
 		}
 	}
 
-	DeleteRogueVessels();
+	debris.Update(GetHandle());
 
 	if (periscope && PeriscopeStatus != P_DEPLOYED)
 	{
@@ -936,81 +938,68 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 	if (showInfoOnHud == 0)
 	{
 		// ==== Buttons text ====
-		sprintf(cbuf, "Key commands:");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "Key commands:");
 		yIndex += 1;
 
 		// Button Ctrl+T
-		sprintf(cbuf, "Ctrl+T:Hide on-screen text");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "Ctrl+T:Hide on-screen text");
 		yIndex += 1;
 
 
 		// Key J
 		if (VesselStatus == LAUNCH)
 		{
-			sprintf(cbuf, "J:     ABORT");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     ABORT");
 			yIndex += 1;
 		}
 		else if (VesselStatus == TOWERSEP)
 		{
-			sprintf(cbuf, "J:     Separate capsule");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate capsule");
 			yIndex += 1;
 		}
 		else if (VesselStatus == ABORT)
 		{
-			sprintf(cbuf, "J:     Separate escape tower");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate escape tower");
 			yIndex += 1;
 		}
 		else if (VesselStatus == FLIGHT)
 		{
-			sprintf(cbuf, "J:     Separate retropack");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate retropack");
 			yIndex += 1;
 		}
 		else if (VesselStatus == ABORTNORETRO)
 		{
-			sprintf(cbuf, "J:     Separate escape tower");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate escape tower");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRY && !drogueDeployed)
 		{
-			sprintf(cbuf, "J:     Deploy drogue chute");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Deploy drogue chute");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRY && drogueDeployed)
 		{
-			sprintf(cbuf, "J:     Separate drogue chute");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate drogue chute");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRYNODROGUE && !mainChuteDeployed && !mainChuteSeparated)
 		{
-			sprintf(cbuf, "J:     Deploy main chute");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Deploy main chute");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRYNODROGUE && !landingBagDeployed)
 		{
-			sprintf(cbuf, "J:     Deploy landing bag");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Deploy landing bag");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRYNODROGUE && mainChuteDeployed && !mainChuteSeparated)
 		{
-			sprintf(cbuf, "J:     Separate main chute");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Separate main chute");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRYNODROGUE && mainChuteSeparated && !reserveChuteDeployed)
 		{
-			sprintf(cbuf, "J:     Deploy reserve chute");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "J:     Deploy reserve chute");
 			yIndex += 1;
 		}
 
@@ -1019,47 +1008,40 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		{
 			if (spaceLaunch)
 			{
-				sprintf(cbuf, "SPACE: Engine off");
-				skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "SPACE: Engine off");
 				yIndex += 1;
 			}
 			else
 			{
-				sprintf(cbuf, "SPACE: Engine on");
-				skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "SPACE: Engine on");
 				yIndex += 1;
 			}
 		}
 		else if (VesselStatus == FLIGHT)
 		{
-			sprintf(cbuf, "SPACE: Fire retros");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "SPACE: Fire retros");
 			yIndex += 1;
 		}
 
 		// Key P
 		if (GroundContact() && VesselStatus == LAUNCH)
 		{
-			sprintf(cbuf, "P:     Automatic launch");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "P:     Automatic launch");
 			yIndex += 1;
 
-			sprintf(cbuf, "C:     Set focus on launch pad");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "C:     Set focus on launch pad");
 			yIndex += 1;
 		}
 		else if (VesselStatus == FLIGHT || VesselStatus == REENTRY) // switch fuel tank for attitude control
 		{
 			if (attitudeFuelAuto)
 			{
-				sprintf(cbuf, "P:     Set propellant source MANUAL");
-				skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "P:     Set propellant source MANUAL");
 				yIndex += 1;
 			}
 			else
 			{
-				sprintf(cbuf, "P:     Set propellant source AUTO");
-				skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "P:     Set propellant source AUTO");
 				yIndex += 1;
 			}
 		}
@@ -1067,8 +1049,7 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		{
 			if (!engageFuelDump)
 			{
-				sprintf(cbuf, "P:     Fuel dump");
-				skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "P:     Fuel dump");
 				yIndex += 1;
 			}
 
@@ -1077,14 +1058,12 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		// Key K
 		if (VesselStatus == LAUNCH && GetThrusterLevel(th_main) == 0.0) // C++ should exit if first condition is false, omiting a crash for when th_main is deleted
 		{
-			sprintf(cbuf, "K:     Separate escape tower");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "K:     Separate escape tower");
 			yIndex += 1;
 		}
 		else if (VesselStatus == FLIGHT || VesselStatus == REENTRY)
 		{
-			sprintf(cbuf, "K:     Engage automatic attitude");
-			skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "K:     Engage automatic attitude");
 			yIndex += 1;
 		}
 
@@ -1093,27 +1072,23 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		{
 			if (RcsStatus == AUTOLOW)
 			{
-				sprintf(cbuf, "G:     Switch to attitude MANUAL");
-				skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "G:     Switch to attitude MANUAL");
 				yIndex += 1;
 			}
 			else if (RcsStatus == MANUAL)
 			{
-				sprintf(cbuf, "G:     Switch to attitude AUTOHIGH");
-				skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "G:     Switch to attitude AUTOHIGH");
 				yIndex += 1;
 			}
 			else
 			{
-				sprintf(cbuf, "G:     Switch to attitude AUTOLOW");
-				skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "G:     Switch to attitude AUTOLOW");
 				yIndex += 1;
 			}
 		}
 
 		// Key M
-		sprintf(cbuf, "M:     Disengage autopilot");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "M:     Disengage autopilot");
 		yIndex += 1;
 	}
 
@@ -1135,53 +1110,44 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		int metM = (int)floor(metAbs / 60.0);
 		int metS = (int)floor((metAbs - metM * 60.0));
 
-		sprintf(cbuf, "T%s%02i %02i", signChar, metM, metS);
-		skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "T%s%02i %02i", signChar, metM, metS);
 		yIndex += 1;
 
 		// ==== Autopilot status ====
 		if (autoPilot && VesselStatus != REENTRYNODROGUE)
 		{
-			sprintf(cbuf, "Autopilot: ON");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Autopilot: ON");
 			yIndex += 1;
 		}
 		else if (!autoPilot && VesselStatus != REENTRYNODROGUE)
 		{
-			sprintf(cbuf, "Autopilot: OFF");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Autopilot: OFF");
 			yIndex += 1;
 		}
 
 		if (VesselStatus == FLIGHT)
 		{
-			sprintf(cbuf, "Retrosequence time:");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Retrosequence time:");
 			yIndex += 1;
 
-			sprintf(cbuf, "  %02i %02i", 4, 44);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  %02i %02i", 4, 44);
 			yIndex += 1;
 		}
 
 		if (attitudeFuelAuto && (VesselStatus == FLIGHT || VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE))
 		{
-			sprintf(cbuf, "Manual fuel: %.1f %%", GetPropellantMass(fuel_manual) / MERCURY_FUEL_MASS_MAN * 100.0);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Manual fuel: %.1f %%", GetPropellantMass(fuel_manual) / MERCURY_FUEL_MASS_MAN * 100.0);
 			yIndex += 1;
 
-			sprintf(cbuf, "Auto fuel: %.1f %%", GetPropellantMass(fuel_auto) / MERCURY_FUEL_MASS_AUTO * 100.0);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Auto fuel: %.1f %%", GetPropellantMass(fuel_auto) / MERCURY_FUEL_MASS_AUTO * 100.0);
 			yIndex += 1;
 		}
 		else if (VesselStatus == FLIGHT || VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE)
 		{
-			sprintf(cbuf, "Manual fuel: %.1f %%", GetPropellantMass(fuel_auto) / MERCURY_FUEL_MASS_MAN * 100.0);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Manual fuel: %.1f %%", GetPropellantMass(fuel_auto) / MERCURY_FUEL_MASS_MAN * 100.0);
 			yIndex += 1;
 
-			sprintf(cbuf, "Auto fuel: %.1f %%", GetPropellantMass(fuel_manual) / MERCURY_FUEL_MASS_AUTO * 100.0);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Auto fuel: %.1f %%", GetPropellantMass(fuel_manual) / MERCURY_FUEL_MASS_AUTO * 100.0);
 			yIndex += 1;
 		}
 
@@ -1190,25 +1156,21 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		{
 			if (AutopilotStatus == AUTOLAUNCH)
 			{
-				sprintf(cbuf, "Awaiting cutoff");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Awaiting cutoff");
 				yIndex += 1;
 
-				sprintf(cbuf, "  remaining impulse: %.1f m/s", integratedSpeedLimit - integratedSpeed);
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  remaining impulse: %.1f m/s", integratedSpeedLimit - integratedSpeed);
 				yIndex += 1;
 			}
 			else
 			{
-				sprintf(cbuf, "Separate escape tower in %.2f s", 0.5 + boosterShutdownTime - simt);
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Separate escape tower in %.2f s", 0.5 + boosterShutdownTime - simt);
 				yIndex += 1;
 			}
 		}
 		else if (autoPilot && VesselStatus == TOWERSEP)
 		{
-			sprintf(cbuf, "Separate capsule in %.2f s", 9.5 + boosterShutdownTime - simt);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Separate capsule in %.2f s", 9.5 + boosterShutdownTime - simt);
 			yIndex += 1;
 		}
 		else
@@ -1220,28 +1182,23 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		{
 			VECTOR3 angVel;
 			GetAngularVel(angVel);
-			sprintf(cbuf, "Holding reentry roll: %.2f\u00B0/s", angVel.z * DEG);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Holding reentry roll: %.2f\u00B0/s", angVel.z * DEG);
 			yIndex += 1;
 		}
 
 		// Launch target pitch and yaw
 		if (autoPilot && VesselStatus == LAUNCH)
 		{
-			sprintf(cbuf, "Current pitch:");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Current pitch:");
 			yIndex += 1;
 
-			sprintf(cbuf, "  %.2f\u00B0 (target: %.2f\u00B0)", GetPitch() * DEG, currentPitchAim);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  %.2f\u00B0 (target: %.2f\u00B0)", GetPitch() * DEG, currentPitchAim);
 			yIndex += 1;
 
-			sprintf(cbuf, "Current yaw:");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Current yaw:");
 			yIndex += 1;
 
-			sprintf(cbuf, "  %.2f\u00B0 (target: %.2f\u00B0)", integratedYaw, 0.0);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  %.2f\u00B0 (target: %.2f\u00B0)", integratedYaw, 0.0);
 			yIndex += 1;
 		}
 		else if (VesselStatus == LAUNCH)
@@ -1249,35 +1206,30 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 			VECTOR3 angVel;
 			GetAngularVel(angVel);
 
-			sprintf(cbuf, "Pitch rate: %.2f\u00B0/s", angVel.x * DEG);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Pitch rate: %.2f\u00B0/s", angVel.x * DEG);
 			yIndex += 1;
 
-			sprintf(cbuf, "Yaw rate: %.2f\u00B0/s", angVel.y * DEG);
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Yaw rate: %.2f\u00B0/s", angVel.y * DEG);
 			yIndex += 1;
 		}
 
 		// Chute status
 		if (VesselStatus == REENTRY && drogueDeployed)
 		{
-			sprintf(cbuf, "Drogue chute deployed");
-			skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Drogue chute deployed");
 			yIndex += 1;
 		}
 		else if (VesselStatus == REENTRYNODROGUE)
 		{
 			if (mainChuteDeployed)
 			{
-				sprintf(cbuf, "Main chute deploy (%.2f)", GetAnimation(MainChuteDeployAnim));
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Main chute deploy (%.2f)", GetAnimation(MainChuteDeployAnim));
 				yIndex += 1;
 			}
 
 			if (landingBagDeployed)
 			{
-				sprintf(cbuf, "Landing bag deploy (%.2f)", GetAnimation(LandingBagDeployAnim));
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Landing bag deploy (%.2f)", GetAnimation(LandingBagDeployAnim));
 				yIndex += 1;
 			}
 		}
@@ -1286,40 +1238,34 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		{
 			if (attitudeFuelAuto)
 			{
-				sprintf(cbuf, "Attitude fuel AUTO");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Attitude fuel AUTO");
 				yIndex += 1;
 			}
 			else
 			{
-				sprintf(cbuf, "Attitude fuel MANUAL");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Attitude fuel MANUAL");
 				yIndex += 1;
 			}
 
 			if (RcsStatus == MANUAL)
 			{
-				sprintf(cbuf, "Attitude mode MANUAL");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Attitude mode MANUAL");
 				yIndex += 1;
 			}
 			else if (RcsStatus == AUTOHIGH)
 			{
-				sprintf(cbuf, "Attitude mode AUTOHIGH");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Attitude mode AUTOHIGH");
 				yIndex += 1;
 			}
 			else
 			{
-				sprintf(cbuf, "Attitude mode AUTOLOW");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Attitude mode AUTOLOW");
 				yIndex += 1;
 			}
 
 			if (engageFuelDump)
 			{
-				sprintf(cbuf, "Dumping attitude fuel");
-				skp->Text(secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+				hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Dumping attitude fuel");
 				yIndex += 1;
 			}
 		}
@@ -1337,31 +1283,27 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		// ABORT
 		if (abort) skp->SetTextColor(Red);
 		else skp->SetTextColor(Gray);
-		sprintf(cbuf, "ABORT");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "ABORT");
 		yIndex += 1;
 
 		// JETT TOWER
 		if (VesselStatus == FLIGHT || VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE || VesselStatus == TOWERSEP) skp->SetTextColor(Green); // I don't implement any failures of tower sep, so don't implement any failure light. This may change when fuses are added
 		else skp->SetTextColor(Gray);
-		sprintf(cbuf, "JETT TOWER");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "JETT TOWER");
 		yIndex += 1;
 
 		// SEP CAPSULE
 		if (VesselStatus == FLIGHT || VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE || VesselStatus == ABORT || VesselStatus == ABORTNORETRO) skp->SetTextColor(Green);
 		else if (boosterShutdownTime != 0.0) skp->SetTextColor(Gray); // time between shutdown and sep is red, so gray if not shutdown yet
 		else skp->SetTextColor(Red);
-		sprintf(cbuf, "SEP CAPSULE");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "SEP CAPSULE");
 		yIndex += 1;
 
 		// RETRO SEQ
 		if (engageRetro && VesselStatus == FLIGHT) skp->SetTextColor(Green); // Debug. Not sure if this is correct. Check with old addon. Does light turn off after retrosep, or stay green?
 		else if (retroStartTime == 0.0) skp->SetTextColor(Gray);
 		else skp->SetTextColor(Red);
-		sprintf(cbuf, "RETRO SEQ");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "RETRO SEQ");
 		yIndex += 1;
 
 		// RETRO ATT
@@ -1370,8 +1312,7 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		if (engageRetro && abs(currP + 34.0 * RAD) < 15.0 * RAD && abs(normangle(currY + PI)) < 15.0 * RAD) skp->SetTextColor(Green); // within limits
 		else if (retroStartTime == 0.0) skp->SetTextColor(Gray); // haven't engaged retro
 		else skp->SetTextColor(Red);
-		sprintf(cbuf, "RETRO ATT");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "RETRO ATT");
 		yIndex += 1;
 
 		// FIRE RETRO
@@ -1380,8 +1321,7 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		else if (retroStartTime != 0.0 && retroStartTime - 10.0 > simt) skp->SetTextColor(Green);
 		else if (retroStartTime == 0.0) skp->SetTextColor(Gray);
 		else skp->SetTextColor(Red);
-		sprintf(cbuf, "FIRE RETRO");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "FIRE RETRO");
 		yIndex += 1;
 
 		// JETT RETRO
@@ -1389,8 +1329,7 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		else if (VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE || VesselStatus == ABORTNORETRO) skp->SetTextColor(Green);
 		else if (retroStartTime == 0.0) skp->SetTextColor(Gray);
 		else skp->SetTextColor(Red);
-		sprintf(cbuf, "JETT RETRO");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "JETT RETRO");
 		yIndex += 1;
 
 		// RETRACT SCOPE
@@ -1398,23 +1337,20 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		else if (PeriscopeStatus != P_CLOSED && (VesselStatus == FLIGHT || VesselStatus == REENTRYNODROGUE || (VesselStatus == LAUNCH && GroundContact()))) skp->SetTextColor(Green);
 		else if (PeriscopeStatus == P_CLOSED) skp->SetTextColor(Gray);
 		else skp->SetTextColor(Red);
-		sprintf(cbuf, "RETRACT SCOPE");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "RETRACT SCOPE");
 		yIndex += 1;
 
 		// .05 G
 		if (AutopilotStatus == LOWG || ((VesselStatus == FLIGHT || VesselStatus == REENTRY) && vesselAcceleration > 0.05 * G)) skp->SetTextColor(Green);
 		else skp->SetTextColor(Gray);
-		sprintf(cbuf, ".05 G");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, ".05 G");
 		yIndex += 1;
 
 		// MAIN
 		if (mainChuteDeployed && simt > mainChuteDeployTime + 2.0) skp->SetTextColor(Green);
 		else if (!mainChuteDeployed) skp->SetTextColor(Gray);
 		else skp->SetTextColor(Red);
-		sprintf(cbuf, "MAIN");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "MAIN");
 		yIndex += 1;
 
 		// LANDING BAG
@@ -1422,8 +1358,7 @@ bool ProjectMercury::clbkDrawHUD(int mode, const HUDPAINTSPEC* hps, oapi::Sketch
 		else if (mainChuteDeployed && simt - mainChuteDeployTime > 10.0) skp->SetTextColor(Red);
 		else if (!landingBagDeployed) skp->SetTextColor(Gray);
 		else skp->SetTextColor(Red);
-		sprintf(cbuf, "LANDING BAG");
-		skp->Text(TextX0, yIndex * LineSpacing + TextY0, cbuf, strlen(cbuf));
+		hudText.Text(skp, TextX0, yIndex * LineSpacing + TextY0, "LANDING BAG");
 		yIndex += 1;
 	}
 
@@ -1995,10 +1930,7 @@ void ProjectMercury::SeparateTower(bool noAbortSep)
 	strcpy(name, GetName());
 	strcat(name, " abort tower");
 
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "ProjectMercury\\Mercury_Abort", &vs);
-	if (GetAltitude() > 5e4)
-		createdAbove50km[stuffCreated] = true;
-	stuffCreated += 1;
+	debris.Create(name, "ProjectMercury\\Mercury_Abort", &vs);
 	DelMesh(Tower);
 	DelPropellantResource(escape_tank);
 	DelThruster(escape_engine);
@@ -2072,13 +2004,10 @@ void ProjectMercury::SeparateRedstone(void)
 		strcat(name, "1");
 	}
 
-	createdVessel[stuffCreated] = oapiCreateVesselEx(name, "Vessels\\ProjectMercury\\Mercury_RedstoneBooster", &vs);;
-	if (GetAltitude() > 5e4)
-		createdAbove50km[stuffCreated] = true;
-	stuffCreated += 1;
+	debris.Create(name, "Vessels\\ProjectMercury\\Mercury_RedstoneBooster", &vs);
 
 	// The thrusterlist spec doesnt seem to work, sadly
-	VESSEL* v = oapiGetVesselInterface(createdVessel[stuffCreated - 1]);
+	VESSEL* v = oapiGetVesselInterface(debris.Last());
 	double levl = GetPropellantMass(redstone_propellant);
 	v->SetPropellantMass(v->GetPropellantHandleByIndex(0), levl);
 	if (GetThrusterLevel(th_main) != 0.0 && oapiGetSimTime() - launchTime < 30.0)
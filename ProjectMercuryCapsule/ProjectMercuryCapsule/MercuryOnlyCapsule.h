@@ -279,7 +279,6 @@ public:
 	void CreateCapsuleFuelTanks(void);
 	void AddDefaultMeshes(void);
 	void CapsuleGenericPostCreation(void);
-	void DeleteRogueVessels(void);
 	void CapsuleAutopilotControl(double simt, double simdt);
 	void FlightReentryAbortControl(double simt, double simdt, double latit, double longit, double getAlt);
 	void WriteHUDAutoFlightReentry(oapi::Sketchpad* skp, double simt, int* yIndexUpdate, char* cbuf);
@@ -520,7 +519,6 @@ private:
 	double PMItime = 0.0;
 	int PMIn = 0;
 
-	int stuffCreated = 0;
-	OBJHANDLE createdVessel[25]; // number is close to 20, but don't bother counting exactly
-	bool createdAbove50km[25] = { false };
+	DebrisManager debris; // everything we have separated. See DebrisManager.h
+	HudTextCache hudText; // formatted HUD lines. See HudTextCache.h
 };
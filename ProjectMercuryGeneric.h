@@ -241,44 +241,6 @@ inline bool ProjectMercury::InRadioContact(OBJHANDLE planet)
 	return false;
 }
 
-inline void ProjectMercury::DeleteRogueVessels(void)
-{
-	// Delete created vessels that bounce off into infinity (hopefully this will reduce crashes). Maybe use this for Redstone too, although we don't do time acc there
-	for (int i = 0; i < stuffCreated; i++)
-	{
-		if (createdVessel[i] != NULL && oapiIsVessel(createdVessel[i]) && oapiGetFocusObject() != createdVessel[i]) // include condition to not delete if object is in focus (like if playing with staged parts)
-		{
-			VECTOR3 vesselPosition;
-			GetRelativePos(createdVessel[i], vesselPosition);
-			double vesselDistance = length(vesselPosition);
-			if (vesselDistance > 2e5) // over 200 km away. Should be further than any realistic attempt at any rendezvous [, and also does not delete Atlas booster until after Atlas SECO --> no problem anymore, is handeled by core logic and config]
-			{
-				char vesselName[256];
-				oapiGetObjectName(createdVessel[i], vesselName, 256);
-
-				//if (oapiGetFocusObject() == createdVessel[i]) oapiSetFocusObject(GetHandle());
-
-				bool deleteResult = oapiDeleteVessel(createdVessel[i]);
-				if (deleteResult)
-				{
-					char cbuf[256];
-					sprintf(cbuf, "Delete vessel %s due to distance %.2f km", vesselName, vesselDistance / 1000.0);
-					oapiWriteLog(cbuf);
-				}
-				else
-				{
-					char cbuf[256];
-					sprintf(cbuf, "Failed to delete vessel %s due to distance %.2f km", vesselName, vesselDistance / 1000.0);
-					oapiWriteLog(cbuf);
-				}
-
-				createdVessel[i] = NULL;
-				//createdAbove50km[i] = false;
-			}
-		}
-	}
-}
-
 // MnA in radians
 inline double ProjectMercury::MnA2TrA(double MnA, double Ecc)
 {
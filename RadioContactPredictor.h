@@ -0,0 +1,326 @@
+#pragma once
+
+// ==============================================================
+//				Header file for Project Mercury.
+//				Created by Asbj�rn "asbjos" Kr�ger
+//					asbjorn.kruger@gmail.com
+//						Made in 2020
+//
+// Predicts acquisition (AOS) and loss (LOS) of signal with the
+// tracking network, so that we don't have to loop through all
+// bases every timestep. Radio contact only changes a few times
+// per orbit anyway.
+// Uses the same criteria as InRadioContact (within 80 km, or
+// above the horizon of a real base).
+//
+// ==============================================================
+
+// Replaces the direct call to InRadioContact. Returns cached state between predicted transitions.
+inline bool ProjectMercury::PredictedRadioContact(OBJHANDLE planet, double simt)
+{
+	if (FailureMode == RETROCALCOFF && oapiGetSimTime() - launchTime > timeOfError) // simulate loss of contact
+	{
+		radioPredictionValid = false;
+		sprintf(contactBase, "No radio contact");
+		return false;
+	}
+
+	// Only predict when coasting above the atmosphere. Landing and contingency sites are only visible below 35 km, so they are never relevant here.
+	VECTOR3 thrustVec;
+	GetThrustVector(thrustVec);
+	bool thrusting = length(thrustVec) > RADIO_PREDICTION_MAX_THRUST_ACC * GetMass();
+
+	if (GetAltitude() < RADIO_PREDICTION_MIN_ALT || thrusting || planet != GetSurfaceRef())
+	{
+		radioPredictionValid = false;
+		return InRadioContact(planet);
+	}
+
+	bool rePredict = !radioPredictionValid || planet != radioPredictionPlanet || simt < radioPredictionEpoch || simt > radioPredictionEnd;
+
+	// Check that the orbit still follows the prediction (drag, attitude thrusters, time acceleration errors). No need to do this every timestep.
+	if (!rePredict && simt > radioNextDriftCheck)
+	{
+		radioNextDriftCheck = simt + RADIO_PREDICTION_DRIFT_INTERVAL;
+
+		double longNow, latNow, radNow;
+		GetEquPos(longNow, latNow, radNow);
+		VECTOR3 posNow = _V(cos(latNow) * cos(longNow), cos(latNow) * sin(longNow), sin(latNow)) * radNow;
+		VECTOR3 posPredicted = RadioPredictionPos(simt - radioPredictionEpoch);
+
+		if (length(posNow - posPredicted) > RADIO_PREDICTION_MAX_DRIFT)
+		{
+			oapiWriteLogV("Radio contact prediction drifted %.1f km. Predict again.", length(posNow - posPredicted) / 1e3);
+			rePredict = true;
+		}
+	}
+
+	if (rePredict)
+	{
+		PredictRadioPasses(planet, simt);
+	}
+	else if (simt < radioNextTransition)
+	{
+		return radioContact; // nothing has changed since last time
+	}
+
+	// Find current state from pass list. Pick lowest base index, to get same result as InRadioContact
+	int currentBase = -1;
+	radioNextTransition = radioPredictionEnd;
+	for (int i = 0; i < radioPassNum; i++)
+	{
+		if (radioPass[i].aos <= simt && simt < radioPass[i].los)
+		{
+			if (currentBase == -1 || radioPass[i].base < currentBase) currentBase = radioPass[i].base;
+			if (radioPass[i].los < radioNextTransition) radioNextTransition = radioPass[i].los;
+		}
+		else if (radioPass[i].aos > simt && radioPass[i].aos < radioNextTransition)
+		{
+			radioNextTransition = radioPass[i].aos;
+		}
+	}
+
+	if (currentBase != -1)
+	{
+		sprintf(contactBase, "Radio contact with %s", radioBaseName[currentBase]);
+		return true;
+	}
+
+	sprintf(contactBase, "No radio contact");
+	return false;
+}
+
+// Propagate the current orbit, and record every AOS and LOS for the real bases
+inline void ProjectMercury::PredictRadioPasses(OBJHANDLE planet, double simt)
+{
+	// Resolve base positions. They never change, so only do this when changing planet
+	if (planet != radioPredictionPlanet)
+	{
+		radioPredictionPlanet = planet;
+		radioBaseNum = 0;
+		for (int i = 0; i < int(oapiGetBaseCount(planet)) && radioBaseNum < RADIO_MAX_BASES; i++)
+		{
+			OBJHANDLE base = oapiGetBaseByIndex(planet, i);
+			char cbuf[25];
+			oapiGetObjectName(base, cbuf, 25);
+
+			// Same filter as in InRadioContact. Landing/contingency sites start with a number, or MA/MR.
+			int firstLetter = cbuf[0] - '0';
+			if (firstLetter < 10 && firstLetter >= 0) continue;
+			if (strncmp(cbuf, "MA", 2) == 0 || strncmp(cbuf, "MR", 2) == 0) continue;
+
+			double baseLongitude, baseLatitude, baseRadius;
+			oapiGetBaseEquPos(base, &baseLongitude, &baseLatitude, &baseRadius);
+			radioBasePos[radioBaseNum] = _V(cos(baseLatitude) * cos(baseLongitude), cos(baseLatitude) * sin(baseLongitude), sin(baseLatitude)) * baseRadius;
+			strcpy(radioBaseName[radioBaseNum], cbuf);
+			radioBaseNum += 1;
+		}
+		oapiWriteLogV("Radio contact prediction uses %i bases", radioBaseNum);
+	}
+
+	// Store the current orbit
+	ELEMENTS el;
+	ORBITPARAM prm;
+	GetElements(planet, el, &prm, 0.0, FRAME_EQU);
+	double longAtNow, latAtNow, radAtNow;
+	GetEquPos(longAtNow, latAtNow, radAtNow);
+
+	radioPredictionEpoch = simt;
+	radioPredSMa = el.a;
+	radioPredEcc = el.e;
+	radioPredInc = el.i;
+	radioPredLAN = el.theta;
+	radioPredAPe = el.omegab - el.theta;
+	radioPredMnA = prm.MnA;
+	radioPredPer = prm.T;
+	radioPredLong0 = longAtNow;
+	radioPredAlpha0 = 0.0;
+	radioPredAlpha0 = RadioPredictionAlpha(0.0, NULL);
+	radioPassNum = 0;
+	radioNextDriftCheck = simt + RADIO_PREDICTION_DRIFT_INTERVAL;
+	radioPredictionValid = true;
+
+	double horizon = RADIO_PREDICTION_ORBITS * radioPredPer;
+	if (el.e >= 1.0 || !(horizon > 0.0)) horizon = RADIO_PREDICTION_STEP; // escape trajectory. Predict very short, and then fall back to InRadioContact when below altitude limit
+	double minRadius = oapiGetSize(planet) + RADIO_PREDICTION_MIN_ALT;
+
+	double passAOS[RADIO_MAX_BASES];
+	bool inContact[RADIO_MAX_BASES];
+	VECTOR3 pos = RadioPredictionPos(0.0);
+	for (int i = 0; i < radioBaseNum; i++)
+	{
+		inContact[i] = RadioBaseVisible(i, pos);
+		passAOS[i] = simt;
+	}
+
+	double t = 0.0;
+	bool passListFull = false;
+	while (t < horizon && !passListFull)
+	{
+		double tNext = t + RADIO_PREDICTION_STEP;
+		pos = RadioPredictionPos(tNext);
+
+		if (length(pos) < minRadius) // will soon enter atmosphere, so end prediction here
+		{
+			horizon = tNext;
+			break;
+		}
+
+		for (int i = 0; i < radioBaseNum && !passListFull; i++)
+		{
+			if (RadioBaseVisible(i, pos) != inContact[i])
+			{
+				// Bisect to find transition time to better than 0.1 seconds
+				double tLow = t, tHigh = tNext;
+				while (tHigh - tLow > 0.05)
+				{
+					double tMid = (tLow + tHigh) / 2.0;
+					if (RadioBaseVisible(i, RadioPredictionPos(tMid)) == inContact[i]) tLow = tMid;
+					else tHigh = tMid;
+				}
+
+				if (!inContact[i]) // AOS
+				{
+					passAOS[i] = simt + tHigh;
+				}
+				else // LOS
+				{
+					radioPass[radioPassNum].base = i;
+					radioPass[radioPassNum].aos = passAOS[i];
+					radioPass[radioPassNum].los = simt + tHigh;
+					radioPassNum += 1;
+
+					if (radioPassNum == RADIO_MAX_PASSES)
+					{
+						passListFull = true;
+						horizon = tHigh;
+					}
+				}
+				inContact[i] = !inContact[i];
+			}
+		}
+		t = tNext;
+	}
+
+	radioPredictionEnd = simt + horizon;
+
+	// Close passes still ongoing at end of prediction
+	for (int i = 0; i < radioBaseNum && radioPassNum < RADIO_MAX_PASSES; i++)
+	{
+		if (inContact[i])
+		{
+			radioPass[radioPassNum].base = i;
+			radioPass[radioPassNum].aos = passAOS[i];
+			radioPass[radioPassNum].los = radioPredictionEnd;
+			radioPassNum += 1;
+		}
+	}
+
+	// Sort by AOS, for HUD list. Few elements, so insertion sort is fine
+	for (int i = 1; i < radioPassNum; i++)
+	{
+		RADIOPASS pass = radioPass[i];
+		int j = i - 1;
+		while (j >= 0 && radioPass[j].aos > pass.aos)
+		{
+			radioPass[j + 1] = radioPass[j];
+			j--;
+		}
+		radioPass[j + 1] = pass;
+	}
+
+	oapiWriteLogV("Radio contact prediction: %i passes in the next %.0f min", radioPassNum, horizon / 60.0);
+}
+
+// Right ascension of vessel t seconds after prediction epoch, relative to the one at epoch. Also returns radius and latitude
+inline double ProjectMercury::RadioPredictionAlpha(double t, VECTOR3* radLatOut)
+{
+	double LAN = radioPredLAN;
+	double APe = radioPredAPe;
+	if (NonsphericalGravityEnabled()) // Take J2 effects into consideration. Perturbs LAN and APe
+	{
+		// J2 coeffs from historical accurate value in 19980227091 paper (published in 1959)
+		double planetRad = oapiGetSize(radioPredictionPlanet);
+		APe += 3.4722e-3 * RAD / 60.0 * pow(planetRad / radioPredSMa, 3) / pow(1.0 - radioPredEcc * radioPredEcc, 2) * (5.0 * cos(radioPredInc) * cos(radioPredInc) - 1.0) * t;
+		LAN += -6.9444e-3 * RAD / 60.0 * pow(planetRad / radioPredSMa, 3) / pow(1.0 - radioPredEcc * radioPredEcc, 2) * cos(radioPredInc) * t;
+	}
+
+	// Solve Kepler's equation with Newton iterations. Converges very fast for the small eccentricities we have here
+	double M = fmod(radioPredMnA + PI2 * t / radioPredPer, PI2);
+	double E = M + radioPredEcc * sin(M);
+	for (int i = 0; i < 5; i++)
+	{
+		E -= (E - radioPredEcc * sin(E) - M) / (1.0 - radioPredEcc * cos(E));
+	}
+	double TrA = 2.0 * atan2(sqrt(1.0 + radioPredEcc) * sin(E / 2.0), sqrt(1.0 - radioPredEcc) * cos(E / 2.0));
+	double r = radioPredSMa * (1.0 - radioPredEcc * cos(E));
+
+	// Same method as GetEquPosInTime
+	double u = APe + TrA;
+	double alpha = atan2(cos(u) * sin(LAN) + sin(u) * cos(LAN) * cos(radioPredInc), cos(u) * cos(LAN) - sin(u) * sin(LAN) * cos(radioPredInc));
+
+	if (radLatOut != NULL)
+	{
+		radLatOut->x = r;
+		radLatOut->y = asin(sin(u) * sin(radioPredInc));
+	}
+
+	return alpha - radioPredAlpha0;
+}
+
+// Position in planet fixed frame (same frame as base positions) t seconds after prediction epoch
+inline VECTOR3 ProjectMercury::RadioPredictionPos(double t)
+{
+	VECTOR3 radLat;
+	double alpha = RadioPredictionAlpha(t, &radLat);
+	double longi = alpha + radioPredLong0 - PI2 / oapiGetPlanetPeriod(radioPredictionPlanet) * t;
+	double lati = radLat.y;
+
+	return _V(cos(lati) * cos(longi), cos(lati) * sin(longi), sin(lati)) * radLat.x;
+}
+
+inline bool ProjectMercury::RadioBaseVisible(int baseIdx, VECTOR3 pos)
+{
+	VECTOR3 basePos = radioBasePos[baseIdx];
+
+	// Same as InRadioContact. distToBase2 < radius2 - baseRadius2 simplifies to pos dot basePos > baseRadius2, i.e. above local horizon
+	return length2(pos - basePos) < 64e8 || dotp(pos, basePos) > length2(basePos);
+}
+
+inline void ProjectMercury::WriteHUDRadioPasses(oapi::Sketchpad* skp, double simt, int* yIndexUpdate, char* cbuf)
+{
+	if (!radioPredictionValid || (FailureMode == RETROCALCOFF && simt - launchTime > timeOfError))
+		return;
+
+	int yIndex = *yIndexUpdate;
+
+	hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "Upcoming passes:");
+	yIndex += 1;
+
+	int passesShown = 0;
+	for (int i = 0; i < radioPassNum && passesShown < RADIO_HUD_PASSES; i++)
+	{
+		if (radioPass[i].los < simt) continue; // already passed
+
+		double metAOS = radioPass[i].aos - launchTime;
+		if (radioPass[i].aos < simt) metAOS = simt - launchTime; // ongoing
+		int aosH = (int)floor(metAOS / 3600.0);
+		int aosM = (int)floor((metAOS - aosH * 3600.0) / 60.0);
+		int aosS = (int)floor((metAOS - aosH * 3600.0 - aosM * 60.0));
+
+		if (radioPass[i].los >= radioPredictionEnd)
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  %02i %02i %02i %s (>%.0f min)", aosH, aosM, aosS, radioBaseName[radioPass[i].base], (radioPass[i].los - max(radioPass[i].aos, simt)) / 60.0);
+		else
+			hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  %02i %02i %02i %s (%.1f min)", aosH, aosM, aosS, radioBaseName[radioPass[i].base], (radioPass[i].los - max(radioPass[i].aos, simt)) / 60.0);
+		yIndex += 1;
+		passesShown += 1;
+	}
+
+	if (passesShown == 0)
+	{
+		hudText.Text(skp, secondColumnHUDx * TextX0, yIndex * LineSpacing + TextY0, "  None next %.0f min", (radioPredictionEnd - simt) / 60.0);
+		yIndex += 1;
+	}
+
+	*yIndexUpdate = yIndex;
+}
@@ -102,7 +102,6 @@ public:
 	double GenerateRandomAngleNorm(double a1, double a2);
 	double NormAngleDeg(double ang);
 	bool InRadioContact(OBJHANDLE planet);
-	void DeleteRogueVessels(void);
 	double MnA2TrA(double MnA, double Ecc);
 	double TrA2MnA(double TrA, double Ecc);
 	double EccentricAnomaly(double ecc, double TrA);
@@ -114,9 +113,6 @@ private:
 	double launchTime;
 	double timeOfError;
 	char contactBase[100];
-	int stuffCreated;
-	OBJHANDLE createdVessel[50];
-	bool createdAbove50km[50];
 };
 
 #include "..\FunctionsForOrbiter2010.h"
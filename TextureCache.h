@@ -0,0 +1,128 @@
+#pragma once
+#include <string.h>
+#include <vector>
+
+// ==============================================================
+//		Replacement textures (skins) shared by all vessels of a module.
+//
+// Previously every vessel loaded its replacement DDS files from disk, even if another Atlas or capsule
+// in the scenario had just loaded the same files. Now the loaded textures are kept in one cache, keyed by
+// file and size, and handed out with a reference count.
+// A replacement texture is only needed until it has been copied into the mesh texture, so the user releases it right
+// after the blit. It then stays in the cache for TEXTURE_KEEP_TIME, so that the other vessels created at scenario
+// start (Atlas and capsule, several boosters) still share one load, and is released after that.
+//
+// Usage:
+//		SURFHANDLE tex = TextureCache::Global().Acquire("ProjectMercury\\Skins\\Atlas.dds", 2048, 1024);
+//		oapiBlt(meshTex, tex, ...);
+//		TextureCache::Global().Release(tex);
+// and every frame TextureCache::Global().ReleaseIdle(oapiGetSysTime()).
+// ==============================================================
+
+const double TEXTURE_KEEP_TIME = 10.0; // s, real time. Unused textures are kept this long
+
+typedef struct
+{
+	char file[100];
+	int w, h;
+	SURFHANDLE surf;
+	int refCount;
+	double idleSince; // sys time when refCount reached 0
+} CACHEDTEXTURE;
+
+class TextureCache
+{
+public:
+	static TextureCache& Global(void)
+	{
+		static TextureCache cache;
+		return cache;
+	}
+
+	// Returns NULL if the file could not be loaded
+	SURFHANDLE Acquire(const char* file, int w, int h)
+	{
+		for (size_t i = 0; i < textures.size(); i++)
+		{
+			if (textures[i].w == w && textures[i].h == h && _stricmp(textures[i].file, file) == 0)
+			{
+				if (textures[i].refCount == 0) idle -= 1;
+				textures[i].refCount += 1;
+				hits += 1;
+				return textures[i].surf;
+			}
+		}
+
+		misses += 1;
+		SURFHANDLE surf = oapiLoadTexture(file, true);
+		if (surf == NULL)
+		{
+			oapiWriteLogV("Texture cache could not load >%s<", file);
+			return NULL;
+		}
+
+		CACHEDTEXTURE tex;
+		strncpy(tex.file, file, sizeof(tex.file) - 1);
+		tex.file[sizeof(tex.file) - 1] = '\0';
+		tex.w = w;
+		tex.h = h;
+		tex.surf = surf;
+		tex.refCount = 1;
+		tex.idleSince = 0.0;
+		textures.push_back(tex);
+
+		return surf;
+	}
+
+	// Kept for TEXTURE_KEEP_TIME when no longer used
+	void Release(SURFHANDLE surf)
+	{
+		for (size_t i = 0; i < textures.size(); i++)
+		{
+			if (textures[i].surf == surf)
+			{
+				textures[i].refCount -= 1;
+				if (textures[i].refCount <= 0)
+				{
+					textures[i].refCount = 0;
+					textures[i].idleSince = oapiGetSysTime();
+					idle += 1;
+				}
+				return;
+			}
+		}
+	}
+
+	// Every frame. Cheap when nothing is idle
+	void ReleaseIdle(double sysTime, double keepTime = TEXTURE_KEEP_TIME)
+	{
+		if (idle == 0)
+			return;
+
+		for (size_t i = 0; i < textures.size(); i++)
+		{
+			if (textures[i].refCount == 0 && sysTime - textures[i].idleSince >= keepTime)
+			{
+				oapiReleaseTexture(textures[i].surf);
+				released += 1;
+				idle -= 1;
+				textures[i] = textures.back(); // order doesn't matter
+				textures.pop_back();
+				i -= 1; // check the moved one
+			}
+		}
+	}
+
+	void WriteLogStats(void)
+	{
+		if (hits + misses > 0)
+			oapiWriteLogV(" > Texture cache: %i hits, %i misses, %i released, %i still loaded", hits, misses, released, (int)textures.size());
+	}
+
+private:
+	std::vector<CACHEDTEXTURE> textures;
+	int idle = 0; // entries with refCount 0
+	int hits = 0;
+	int misses = 0;
+	int released = 0;
+};
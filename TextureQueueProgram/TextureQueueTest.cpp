@@ -0,0 +1,145 @@
+// TextureQueueTest.cpp : This file contains the 'main' function. Program execution begins and ends there.
+//
+// This program is included in the Project Mercury X package
+//
+// It runs the replacement texture queue (TextureQueue in AsyncTextureLoader.h) with a stand-in loader, without Orbiter.
+// The stand-in has a few made up DDS files in memory, and records what is applied in which frame and what is logged.
+// Checks that at most TEXTURE_APPLY_PER_FRAME textures are applied per frame, that they are applied in the order
+// they were requested, and that a missing file and a file with the wrong size are reported.
+//
+// Standalone, and does not need Orbiter. Compile on Linux with:
+//		g++ -O2 -std=c++11 TextureQueueTest.cpp -o TextureQueueTest
+//
+// Usage:
+//		TextureQueueTest
+// Returns 0 if all checks pass.
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// What AsyncTextureLoader.h needs from the Orbiter SDK
+typedef void* MESHHANDLE;
+typedef unsigned long DWORD;
+
+#define TEXTUREQUEUE_STANDALONE
+#include "../AsyncTextureLoader.h"
+
+typedef struct
+{
+	const char* file;
+	int w, h;
+} FAKEFILE;
+
+class FakeTextureLoader : public TextureLoader
+{
+public:
+	int ReadHeader(const char* file, unsigned char* header, int size)
+	{
+		for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++)
+		{
+			if (strcmp(files[i].file, file) != 0)
+				continue;
+
+			unsigned char dds[TEXTURE_HEADER_SIZE] = { 'D', 'D', 'S', ' ', 124 };
+			memcpy(&dds[12], &files[i].h, 4);
+			memcpy(&dds[16], &files[i].w, 4);
+			int read = size < TEXTURE_HEADER_SIZE ? size : TEXTURE_HEADER_SIZE;
+			memcpy(header, dds, read);
+			return read;
+		}
+		return -1;
+	}
+
+	bool Apply(const TEXTUREJOB& job)
+	{
+		applied.push_back(job.file);
+		appliedFrame.push_back(frame);
+		return strcmp(job.file, "Missing.dds") != 0;
+	}
+
+	void Log(const char* line)
+	{
+		printf("  log: %s\n", line);
+		log.push_back(line);
+	}
+
+	bool Logged(const char* start)
+	{
+		for (size_t i = 0; i < log.size(); i++)
+			if (log[i].compare(0, strlen(start), start) == 0)
+				return true;
+		return false;
+	}
+
+	int frame = 0;
+	std::vector<std::string> applied;
+	std::vector<int> appliedFrame;
+	std::vector<std::string> log;
+
+private:
+	const FAKEFILE files[4] = {
+		{ "Atlas3.dds", 2048, 1024 },
+		{ "Atlas4.dds", 2048, 1024 },
+		{ "Fin.dds", 512, 512 },
+		{ "Wrong.dds", 1024, 1024 },
+	};
+};
+
+int failures = 0;
+
+void Check(bool ok, const char* what)
+{
+	printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+	if (!ok) failures += 1;
+}
+
+int main()
+{
+	const char* requested[6] = { "Atlas3.dds", "Missing.dds", "Atlas4.dds", "Wrong.dds", "Fin.dds", "Atlas3.dds" };
+	const int numRequested = sizeof(requested) / sizeof(requested[0]);
+
+	FakeTextureLoader loader;
+	{
+		TextureQueue queue(&loader);
+		for (int i = 0; i < numRequested; i++)
+		{
+			int size = (strcmp(requested[i], "Fin.dds") == 0) ? 512 : 2048;
+			queue.Request(requested[i], requested[i], size, size == 512 ? 512 : 1024, NULL, i);
+		}
+
+		// Until all are applied or it's clearly stuck
+		int remaining = numRequested;
+		while (remaining > 0 && loader.frame < 5000)
+		{
+			remaining = queue.Update();
+			loader.frame += 1;
+		}
+		Check(remaining == 0, "all requested textures applied");
+	}
+
+	int maxPerFrame = 0;
+	for (size_t i = 0; i < loader.appliedFrame.size(); i++)
+	{
+		int count = 0;
+		for (size_t j = 0; j < loader.appliedFrame.size(); j++)
+			if (loader.appliedFrame[j] == loader.appliedFrame[i]) count += 1;
+		if (count > maxPerFrame) maxPerFrame = count;
+	}
+	Check(maxPerFrame == TEXTURE_APPLY_PER_FRAME, "at most TEXTURE_APPLY_PER_FRAME applied per frame");
+
+	bool inOrder = ((int)loader.applied.size() == numRequested);
+	for (int i = 0; inOrder && i < numRequested; i++)
+		inOrder = (loader.applied[i] == requested[i]);
+	Check(inOrder, "applied in the order requested");
+
+	Check(loader.Logged("Could not read Missing.dds file >Missing.dds<"), "missing file reported");
+	Check(loader.Logged("Failed loading Missing.dds texture"), "failed apply reported");
+	Check(loader.Logged("Warning! Wrong.dds file >Wrong.dds< is 1024x1024, but 2048x1024 was given"), "size mismatch reported");
+	Check(!loader.Logged("Warning! Fin.dds"), "no warning for a correct size");
+	Check(loader.Logged("All 6 replacement textures applied"), "batch end reported");
+
+	printf("%s\n", failures == 0 ? "All checks passed" : "Some checks failed");
+	return failures == 0 ? 0 : 1;
+}
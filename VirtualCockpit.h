@@ -1,4 +1,6 @@
 #pragma once
+#include <vector> // panel mesh group lists
+#include "MercuryTimer.h"
 
 // ==============================================================
 //		Header file for Mercury Capsule Virtual Cockpit.
@@ -305,33 +307,28 @@ inline bool ProjectMercury::clbkPanelMouseEvent(int id, int event, int mx, int m
 
 		return true;
 	case PANEL_ID_TOWJET_BUTTON:
-		SetIndicatorButtonStatus(indicatorButtonFirstGroup + 0, 1);
-		indicatorButtonPressTime[0] = simt;
+		PressIndicatorButton(0, simt);
 
-		separateTowerAction = true;
+		QueueAction(ACTION_SEPARATETOWER);
 		return true;
 	case PANEL_ID_CAPSEP_BUTTON:
-		SetIndicatorButtonStatus(indicatorButtonFirstGroup + 1, 1);
-		indicatorButtonPressTime[1] = simt;
+		PressIndicatorButton(1, simt);
 
-		separateCapsuleAction = true;
+		QueueAction(ACTION_SEPARATECAPSULE);
 		return true;
 	case PANEL_ID_RETSEQ_BUTTON:
-		SetIndicatorButtonStatus(indicatorButtonFirstGroup + 2, 1);
-		indicatorButtonPressTime[2] = simt;
+		PressIndicatorButton(2, simt);
 
 		InitiateRetroSequence();
 		return true;
 	case PANEL_ID_RETJET_BUTTON:
-		SetIndicatorButtonStatus(indicatorButtonFirstGroup + 3, 1);
-		indicatorButtonPressTime[3] = simt;
+		PressIndicatorButton(3, simt);
 
-		prepareReentryAction = true;
+		QueueAction(ACTION_PREPAREREENTRY);
 		AutopilotStatus = REENTRYATTITUDE;
 		return true;
 	case PANEL_ID_TIMZER_BUTTON:
-		SetIndicatorButtonStatus(indicatorButtonFirstGroup + 4, 1);
-		indicatorButtonPressTime[4] = simt;
+		PressIndicatorButton(4, simt);
 
 		launchTime = simt; // Set this instant to T+0. Useful for when launching on a Fred18 Multistage booster, where we don't have contact with launcher.
 		return true;
@@ -487,7 +484,7 @@ inline void ProjectMercury::SetPeriscopeAltitude(double inputAltitude)
 	static WORD vertexIndex[totalVertices] = { 0, 1, 2, 3 };
 
 	double vertexDisplacement0, vertexDisplacement5;
-	GetPixelDeviationForAltitude(periscopeAltitude, &vertexDisplacement0, &vertexDisplacement5);
+	GetPixelDeviationForAltitude(inputAltitude, &vertexDisplacement0, &vertexDisplacement5);
 
 	for (int i = 0; i < totalGroupNumber; i++)
 	{
@@ -546,55 +543,195 @@ inline void ProjectMercury::CreatePanelTHandleClick(int ID, int x, int y, PANELH
 	VersionDependentPanelClick(ID, _R(x - tHandleRad, y - tHandleRad, x + tHandleRad, y + tHandleRad), 0, PANEL_REDRAW_NEVER, PANEL_MOUSE_RBDOWN | PANEL_MOUSE_RBPRESSED | PANEL_MOUSE_LBDOWN | PANEL_MOUSE_LBPRESSED, hPanel, _R(0, 0, 0, 0), NULL);
 }
 
-// Fit the current panel mesh (1.5 ratio) to any screen ratio, by pushing elements to screen border.
-// Well, that was a previous version. Now, it's simply recording group indecies.
-void ProjectMercury::FitPanelToScreen(int w, int h)
+// Classification of the panel mesh groups (dial arms, globe, abort indicator, screen side).
+// It only depends on the mesh file, so it is done once per session, and stored in a small file next to the mesh,
+// together with the size and modification time of the mesh file. If the mesh file changes, so does the stamp, and we classify again.
+typedef struct
 {
-	// Get panel mesh information
-	const int totalGroupNumber = int(oapiMeshGroupCount(cockpitPanelMesh));
+	unsigned int size; // bytes. 0 if the file can't be read
+	unsigned int timeLow, timeHigh; // last write time
+} PANELMESHSTAMP;
 
-	int groupNumVtx[1000] = { 0 }; // number of vertexes in group. Large number to foresee largest possible mesh group vertex count
+typedef struct
+{
+	MESHHANDLE mesh; // the mesh the classification is valid for in this session
+	PANELMESHSTAMP stamp;
+	int groupCount;
+	std::vector<int> armGroups;
+	std::vector<int> groupSide; // 1 left, 2 right, -1 ignore
+	int globeGroup;
+	int globeVertices;
+	int abortIndicatorGroup;
+} PANELGROUPS;
+
+const char PANEL_MESH_FILE[] = "Meshes\\ProjectMercury\\Panel\\panel.msh";
+const char PANEL_GROUP_CACHE_FILE[] = "ProjectMercury\\Panel\\panel_groups.cfg"; // in Meshes
+const int PANEL_GROUP_CACHE_LINE = 1024; // Orbiter reads a cfg item line into a buffer of this length, so longer strings are neither written nor read
+
+inline PANELGROUPS* PanelGroupCache(void)
+{
+	static PANELGROUPS cache = { NULL, { 0, 0, 0 }, 0 };
+	return &cache;
+}
 
-	for (int i = 0; i < totalGroupNumber; i++)
+// Size and modification time of the mesh file. Cheaper than reading the file, which is most of a panel load. Size 0 if the file can't be found
+inline PANELMESHSTAMP PanelMeshFileStamp(const char* fileName)
+{
+	PANELMESHSTAMP stamp = { 0, 0, 0 };
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if (GetFileAttributesExA(fileName, GetFileExInfoStandard, &attributes) && attributes.nFileSizeHigh == 0)
 	{
-		MESHGROUPEX *groupData = oapiMeshGroupEx(cockpitPanelMesh, i);
+		stamp.size = attributes.nFileSizeLow;
+		stamp.timeLow = attributes.ftLastWriteTime.dwLowDateTime;
+		stamp.timeHigh = attributes.ftLastWriteTime.dwHighDateTime;
+	}
+	return stamp;
+}
+
+inline bool ReadPanelGroupCache(PANELGROUPS* groups, PANELMESHSTAMP stamp, int groupCount)
+{
+	if (stamp.size == 0 || groupCount >= PANEL_GROUP_CACHE_LINE)
+		return false;
+
+	FILEHANDLE file = oapiOpenFile(PANEL_GROUP_CACHE_FILE, FILE_IN_ZEROONFAIL, MESHES);
+	if (file == 0)
+		return false;
+
+	int cachedSize = 0, cachedTimeLow = 0, cachedTimeHigh = 0, cachedGroupCount = 0, cachedArmCount = 0;
+	char armString[PANEL_GROUP_CACHE_LINE] = "", sideString[PANEL_GROUP_CACHE_LINE] = "";
+	bool valid = oapiReadItem_int(file, "FileSize", cachedSize) && (unsigned int)cachedSize == stamp.size
+		&& oapiReadItem_int(file, "FileTimeLow", cachedTimeLow) && (unsigned int)cachedTimeLow == stamp.timeLow
+		&& oapiReadItem_int(file, "FileTimeHigh", cachedTimeHigh) && (unsigned int)cachedTimeHigh == stamp.timeHigh
+		&& oapiReadItem_int(file, "GroupCount", cachedGroupCount) && cachedGroupCount == groupCount
+		&& oapiReadItem_int(file, "GlobeGroup", groups->globeGroup)
+		&& oapiReadItem_int(file, "GlobeVertices", groups->globeVertices)
+		&& oapiReadItem_int(file, "AbortIndicatorGroup", groups->abortIndicatorGroup)
+		&& oapiReadItem_int(file, "ArmGroupCount", cachedArmCount) && cachedArmCount >= 0 && cachedArmCount <= groupCount
+		&& oapiReadItem_string(file, "ArmGroups", armString)
+		&& oapiReadItem_string(file, "GroupSide", sideString);
+	oapiCloseFile(file, FILE_IN_ZEROONFAIL);
+	armString[PANEL_GROUP_CACHE_LINE - 1] = '\0';
+	sideString[PANEL_GROUP_CACHE_LINE - 1] = '\0';
+
+	if (!valid || (int)strlen(sideString) != groupCount)
+		return false;
+
+	groups->armGroups.clear();
+	char* token = strtok(armString, " ");
+	while (token != NULL)
+	{
+		int arm = atoi(token);
+		if (arm < 0 || arm >= groupCount)
+			return false;
+		groups->armGroups.push_back(arm);
+		token = strtok(NULL, " ");
+	}
+	if ((int)groups->armGroups.size() != cachedArmCount)
+		return false; // cut or edited line
+
+	groups->groupSide.resize(groupCount);
+	for (int i = 0; i < groupCount; i++)
+	{
+		if (sideString[i] == 'L') groups->groupSide[i] = 1;
+		else if (sideString[i] == 'R') groups->groupSide[i] = 2;
+		else groups->groupSide[i] = -1;
+	}
+
+	groups->stamp = stamp;
+	groups->groupCount = groupCount;
+	oapiWriteLogV("Read panel group classification from cache (%i groups, %i arms)", groupCount, (int)groups->armGroups.size());
+	return true;
+}
+
+inline void WritePanelGroupCache(PANELGROUPS* groups)
+{
+	std::vector<char> armString(groups->armGroups.size() * 6 + 1, '\0'); // up to 5 digits and a space each
+	int len = 0;
+	for (int i = 0; i < (int)groups->armGroups.size(); i++)
+	{
+		len += sprintf(&armString[len], i == 0 ? "%i" : " %i", groups->armGroups[i]);
+	}
+
+	if (len >= PANEL_GROUP_CACHE_LINE || groups->groupCount >= PANEL_GROUP_CACHE_LINE)
+	{
+		oapiWriteLog("Panel group classification too long for the cache, classifying every session");
+		return;
+	}
+
+	FILEHANDLE file = oapiOpenFile(PANEL_GROUP_CACHE_FILE, FILE_OUT, MESHES);
+	if (file == 0)
+	{
+		oapiWriteLog("Could not write panel group cache");
+		return;
+	}
+
+	std::vector<char> sideString(groups->groupCount + 1, '\0');
+	for (int i = 0; i < groups->groupCount; i++)
+	{
+		if (groups->groupSide[i] == 1) sideString[i] = 'L';
+		else if (groups->groupSide[i] == 2) sideString[i] = 'R';
+		else sideString[i] = '-';
+	}
+
+	oapiWriteItem_int(file, "FileSize", (int)groups->stamp.size);
+	oapiWriteItem_int(file, "FileTimeLow", (int)groups->stamp.timeLow);
+	oapiWriteItem_int(file, "FileTimeHigh", (int)groups->stamp.timeHigh);
+	oapiWriteItem_int(file, "GroupCount", groups->groupCount);
+	oapiWriteItem_int(file, "GlobeGroup", groups->globeGroup);
+	oapiWriteItem_int(file, "GlobeVertices", groups->globeVertices);
+	oapiWriteItem_int(file, "AbortIndicatorGroup", groups->abortIndicatorGroup);
+	oapiWriteItem_int(file, "ArmGroupCount", (int)groups->armGroups.size());
+	oapiWriteItem_string(file, "ArmGroups", &armString[0]);
+	oapiWriteItem_string(file, "GroupSide", &sideString[0]);
+	oapiCloseFile(file, FILE_OUT);
+}
+
+inline void ClassifyPanelGroups(PANELGROUPS* groups, MESHHANDLE mesh, int groupCount)
+{
+	groups->groupCount = groupCount;
+	groups->armGroups.clear();
+	groups->groupSide.assign(groupCount, 0);
+	groups->globeGroup = NULL;
+	groups->globeVertices = NULL;
+	groups->abortIndicatorGroup = NULL;
+
+	for (int i = 0; i < groupCount; i++)
+	{
+		MESHGROUPEX *groupData = oapiMeshGroupEx(mesh, i);
 
-		groupNumVtx[i] = int(groupData->nVtx);
-		
 		if (groupData->Vtx->x < 2160 / 2 && abs(groupData->Vtx->y) < 2000) // left hand group
 		{
-			panelMeshGroupSide[i] = 1;
+			groups->groupSide[i] = 1;
 		}
 		else if (abs(groupData->Vtx->y) < 2000) // right hand group
 		{
-			panelMeshGroupSide[i] = 2;
+			groups->groupSide[i] = 2;
 		}
 		else
 		{
 			// Group outside of screen, and thus don't touch (the gray border for superwide screens)
-			panelMeshGroupSide[i] = -1;
+			groups->groupSide[i] = -1;
 		}
 
 		// Get all arm group indecies for AnimateDials. All arms have five verticies
 		if (groupData->nVtx == 5)
 		{
-			armGroups[totalArmGroups] = i;
-			totalArmGroups += 1;
+			groups->armGroups.push_back(i);
 		}
 
 		if (groupData->nVtx > 50) // large mesh, probably globe
 		{
-			if (globeGroup == NULL) globeGroup = i;
+			if (groups->globeGroup == NULL) groups->globeGroup = i;
 			else oapiWriteLog("ERROR ERROR ERROR! More than one mesh group with more than 50 vertices! Please debug!");
 
-			globeVertices = groupData->nVtx;
+			groups->globeVertices = groupData->nVtx;
 		}
 
 		if (groupData->nVtx == 41)
 		{
-			if (abortIndicatorGroup == NULL)
+			if (groups->abortIndicatorGroup == NULL)
 			{
-				abortIndicatorGroup = i;
+				groups->abortIndicatorGroup = i;
 				oapiWriteLogV("Found abort indicator at group %i", i);
 			}
 			else oapiWriteLog("ERROR ERROR ERROR! More than one mesh group with 41 vertices! Please debug!");
@@ -602,6 +739,44 @@ void ProjectMercury::FitPanelToScreen(int w, int h)
 
 		//oapiWriteLogV("Group %i has %i vertices", i, groupData->nVtx);
 	}
+}
+
+// Fit the current panel mesh (1.5 ratio) to any screen ratio, by pushing elements to screen border.
+// Well, that was a previous version. Now, it's simply recording group indecies.
+void ProjectMercury::FitPanelToScreen(int w, int h)
+{
+	// Get panel mesh information
+	const int totalGroupNumber = int(oapiMeshGroupCount(cockpitPanelMesh));
+
+	PANELGROUPS* groups = PanelGroupCache();
+	if (groups->mesh != cockpitPanelMesh || groups->groupCount != totalGroupNumber) // first panel load this session
+	{
+		PANELMESHSTAMP stamp = PanelMeshFileStamp(PANEL_MESH_FILE);
+		if (!ReadPanelGroupCache(groups, stamp, totalGroupNumber))
+		{
+			ClassifyPanelGroups(groups, cockpitPanelMesh, totalGroupNumber);
+			groups->stamp = stamp;
+			if (stamp.size != 0) WritePanelGroupCache(groups);
+		}
+		groups->mesh = cockpitPanelMesh;
+	}
+
+	armGroups = groups->armGroups;
+	totalArmGroups = (int)armGroups.size();
+	panelMeshGroupSide = groups->groupSide;
+	globeGroup = groups->globeGroup;
+	globeVertices = groups->globeVertices;
+	abortIndicatorGroup = groups->abortIndicatorGroup;
+
+	// New mesh, so everything must be drawn again
+	for (int i = 0; i < totalArmGroups; i++)
+	{
+		dialDrawn[armGroups[i]] = false;
+	}
+	panelForceAll = true; // every instrument must be updated in the first frame
+	panelDrawnStateValid = false; // and every light and switch
+	globeTableResolution = 0.0f; // force new tables and a full globe edit
+	if (globeVertices > GLOBE_MAX_VERTICES) oapiWriteLogV("Globe has %i vertices, only %i supported", globeVertices, GLOBE_MAX_VERTICES);
 
 	// Edit mesh
 	//double defaultScale = (double)h / 1440;
@@ -663,8 +838,82 @@ void ProjectMercury::FitPanelToScreen(int w, int h)
 	//oapiWriteLogV("Panel mesh fit to screen by pushing mesh groups %.1f pixels.", addScreenWidthValue);
 }
 
+// Refresh rate and cost of each instrument group in AnimateDials. Same order as PANEL_INSTRUMENT.
+// Rate 0 means every frame. Only PANEL_EXPENSIVE_PER_FRAME expensive instruments are updated in one frame, the rest wait for the next.
+typedef struct
+{
+	const char* name; // for log
+	double rate; // Hz
+	int cost;
+} PANEL_INSTRUMENT_SPEC;
+
+const PANEL_INSTRUMENT_SPEC PANEL_SCHEDULE[PANEL_INSTRUMENT_COUNT] = {
+	{ "g-meter", 0.0, PANEL_COST_CHEAP },
+	{ "fuel", 2.0, PANEL_COST_CHEAP }, // fuel quantity changes slowly
+	{ "descent", 0.0, PANEL_COST_CHEAP },
+	{ "altitude", 10.0, PANEL_COST_CHEAP },
+	{ "attitude", 0.0, PANEL_COST_CHEAP },
+	{ "clock", 10.0, PANEL_COST_CHEAP }, // second hand ticks at 5 Hz
+	{ "attitude rate", 0.0, PANEL_COST_CHEAP },
+	{ "globe", 5.0, PANEL_COST_EXPENSIVE }, // hundreds of vertices, each with asin and atan2
+	{ "MET", 4.0, PANEL_COST_CHEAP }, // changes once a second
+	{ "retro times", 2.0, PANEL_COST_EXPENSIVE }, // GetPanelRetroTimes
+	{ "indicators", 0.0, PANEL_COST_CHEAP } // must respond to button presses at once
+};
+const int PANEL_EXPENSIVE_PER_FRAME = 1;
+const int PANEL_ARM_GROUPS = 16; // number of dial arms animated in AnimateDials
+
+// Returns true if the instrument group should be updated this frame. Also sets dialStepTime used for dial latency
+inline bool ProjectMercury::PanelInstrumentDue(int instrument)
+{
+	const PANEL_INSTRUMENT_SPEC* spec = &PANEL_SCHEDULE[instrument];
+	bool expensive = spec->cost == PANEL_COST_EXPENSIVE;
+
+	double period = 0.0;
+	if (spec->rate > 0.0) period = 1.0 / spec->rate;
+	if (panelMaxRate > 0.0 && period < 1.0 / panelMaxRate) period = 1.0 / panelMaxRate; // user limit for low-end machines
+
+	if (!panelForceAll)
+	{
+		if (panelSysTime < panelInstrumentNext[instrument])
+			return false;
+
+		if (expensive && panelExpensiveThisFrame >= PANEL_EXPENSIVE_PER_FRAME)
+			return false; // already done our share of work this frame, so try again next frame
+	}
+
+	if (expensive) panelExpensiveThisFrame += 1;
+
+	if (panelForceAll)
+	{
+		// Spread over the period, so that not all instruments with same rate end up in the same frame
+		panelInstrumentNext[instrument] = panelSysTime + period * double(instrument + 1) / double(PANEL_INSTRUMENT_COUNT);
+	}
+	else
+	{
+		panelInstrumentNext[instrument] += period;
+		if (panelInstrumentNext[instrument] <= panelSysTime) panelInstrumentNext[instrument] = panelSysTime + period; // fallen behind (low frame rate), so don't try to catch up
+	}
+
+	double simt = oapiGetSimTime();
+	dialStepTime = float(simt - panelInstrumentSimt[instrument]);
+	if (dialStepTime < 0.0f) dialStepTime = (float)oapiGetSimStep(); // time jumped backwards
+	panelInstrumentSimt[instrument] = simt;
+	panelInstrumentUpdates[instrument] += 1;
+
+	return true;
+}
+
 inline void ProjectMercury::AnimateDials(void)
 {
+	PROFILE_SCOPE(PROF_DIALS);
+	if (totalArmGroups < PANEL_ARM_GROUPS) // panel mesh not classified, or not the mesh we expect
+		return;
+
+	double panelStartTime = MercuryTimerMs();
+	panelSysTime = oapiGetSysTime();
+	panelExpensiveThisFrame = 0;
+
 	bool includeLatency = true;
 	double simt = oapiGetSimTime();
 
@@ -685,150 +934,176 @@ inline void ProjectMercury::AnimateDials(void)
 	float yawPos[2] =		{attitudeCenter[0], attitudeCenter[1] + 270};
 	float attitudePos[2] =	{ attitudeCenter[0] - 1.0f, attitudeCenter[1] + 0.5f}; // additional small fixes to perfectly centre crosshairs.
 
-	// Longitudinal acceleration
-	float load = float(longitudinalAcc / G);
-	RotateArmGroup(armGroups[idx], gMeterPos[0], gMeterPos[1], 100.0f, 10.0f, ValueToAngle(load, -9.0f, 21.0f, -280.0f, 50.0f), 0.9f);
-	idx += 1;
-	// Longitudinal acceleration memory high
-	float loadP = float(maxVesselAcceleration / G);
-	RotateArmGroup(armGroups[idx], gMeterPos[0], gMeterPos[1], 90.0f, 6.0f, ValueToAngle(loadP, -9.0f, 21.0f, -280.0f, 50.0f), 0.9f);
-	idx += 1;
-	// Longitudinal acceleration memory low
-	float loadN = float(minVesselAcceleration / G);
-	RotateArmGroup(armGroups[idx], gMeterPos[0], gMeterPos[1], 90.0f, 6.0f, ValueToAngle(loadN, -9.0f, 21.0f, -280.0f, 50.0f), 0.9f);
-	idx += 1;
+	if (PanelInstrumentDue(PANEL_GMETER))
+	{
+		// Longitudinal acceleration
+		float load = float(longitudinalAcc / G);
+		RotateArmGroup(armGroups[idx], gMeterPos[0], gMeterPos[1], 100.0f, 10.0f, ValueToAngle(load, -9.0f, 21.0f, -280.0f, 50.0f), 0.9f);
+		idx += 1;
+		// Longitudinal acceleration memory high
+		float loadP = float(maxVesselAcceleration / G);
+		RotateArmGroup(armGroups[idx], gMeterPos[0], gMeterPos[1], 90.0f, 6.0f, ValueToAngle(loadP, -9.0f, 21.0f, -280.0f, 50.0f), 0.9f);
+		idx += 1;
+		// Longitudinal acceleration memory low
+		float loadN = float(minVesselAcceleration / G);
+		RotateArmGroup(armGroups[idx], gMeterPos[0], gMeterPos[1], 90.0f, 6.0f, ValueToAngle(loadN, -9.0f, 21.0f, -280.0f, 50.0f), 0.9f);
+		idx += 1;
+	}
+	else idx += 3;
 
-	// Fuel
-	float fuelAuto = float(GetPropellantMass(fuel_auto) / MERCURY_FUEL_MASS_AUTO);
-	float fuelManual = float(GetPropellantMass(fuel_manual) / MERCURY_FUEL_MASS_MAN);
+	if (PanelInstrumentDue(PANEL_FUEL))
+	{
+		// Fuel
+		float fuelAuto = float(flightState.fuelAuto / MERCURY_FUEL_MASS_AUTO);
+		float fuelManual = float(flightState.fuelManual / MERCURY_FUEL_MASS_MAN);
 
-	// Fuel auto
-	RotateArmGroup(armGroups[idx], fuelPos[0] - 72, fuelPos[1], 60.0f, 8.0f, ValueToAngle(fuelAuto, 0.0f, 1.0f, 50.0f, -50.0f), 0.1f);
-	idx += 1;
+		// Fuel auto
+		RotateArmGroup(armGroups[idx], fuelPos[0] - 72, fuelPos[1], 60.0f, 8.0f, ValueToAngle(fuelAuto, 0.0f, 1.0f, 50.0f, -50.0f), 0.1f);
+		idx += 1;
 
-	// Fuel manual
-	RotateArmGroup(armGroups[idx], fuelPos[0] + 72, fuelPos[1], 60.0f, 8.0f, ValueToAngle(fuelManual, 0.0f, 1.0f, 130.0f, 230.0f), 0.1f);
-	idx += 1;
+		// Fuel manual
+		RotateArmGroup(armGroups[idx], fuelPos[0] + 72, fuelPos[1], 60.0f, 8.0f, ValueToAngle(fuelManual, 0.0f, 1.0f, 130.0f, 230.0f), 0.1f);
+		idx += 1;
+	}
+	else idx += 2;
 
-	// Descent
-	VECTOR3 groundSpeedVec;
-	GetAirspeedVector(FRAME_HORIZON, groundSpeedVec);
-	float descent = float(-groundSpeedVec.y / 3.048); // feet/s
-	if (GetAltitude() > 5e4) descent = 0.0f;
-	RotateArmGroup(armGroups[idx], descentPos[0], descentPos[1], 95.0f, 10.0f, ValueToAngle(descent, 0.0f, 15.0f, 180.0f, 0.0f), 0.85f);
-	idx += 1;
+	if (PanelInstrumentDue(PANEL_DESCENT))
+	{
+		// Descent
+		float descent = float(-flightState.airspeedHorizon.y / 3.048); // feet/s
+		if (flightState.altitude > 5e4) descent = 0.0f;
+		RotateArmGroup(armGroups[idx], descentPos[0], descentPos[1], 95.0f, 10.0f, ValueToAngle(descent, 0.0f, 15.0f, 180.0f, 0.0f), 0.85f);
+		idx += 1;
+	}
+	else idx += 1;
 
-	// Altitude
-	//float altitude = float(GetAltitude() / 304.8); // ft
-	// Altitude is calculated from static pressure. Mimic that, although I assume Orbiter currently doesn't model pressure difference due to weather/complex atmosphere.
-	double staticPressure = GetAtmPressure();
-	float altitude = -log(GetAtmPressure() / ATMP) * 8.314 * (273.15 + 15.0) / G / 0.028964 / 304.8f; // 0.02894 is the molar mass of Earth's atmosphere, https://en.wikipedia.org/wiki/Barometric_formula.
-	sprintf(oapiDebugString(), "%.2f, act. alt: %.0f, pres.alt %.0f", simt, GetAltitude(), altitude * 304.8);
-	RotateArmGroup(armGroups[idx], altPos[0], altPos[1], 135.0f, 10.0f, ValueToAngle(altitude, 0.0f, 100.0f, 120.0f, 450.0f), 0.85f);
-	idx += 1;
+	if (PanelInstrumentDue(PANEL_ALTITUDE))
+	{
+		// Altitude
+		//float altitude = float(GetAltitude() / 304.8); // ft
+		// Altitude is calculated from static pressure. Mimic that, although I assume Orbiter currently doesn't model pressure difference due to weather/complex atmosphere.
+		double staticPressure = flightState.atmPressure;
+		float altitude = -log(staticPressure / ATMP) * 8.314 * (273.15 + 15.0) / G / 0.028964 / 304.8f; // 0.02894 is the molar mass of Earth's atmosphere, https://en.wikipedia.org/wiki/Barometric_formula.
+		sprintf(oapiDebugString(), "%.2f, act. alt: %.0f, pres.alt %.0f", simt, flightState.altitude, altitude * 304.8);
+		RotateArmGroup(armGroups[idx], altPos[0], altPos[1], 135.0f, 10.0f, ValueToAngle(altitude, 0.0f, 100.0f, 120.0f, 450.0f), 0.85f);
+		idx += 1;
+	}
+	else idx += 1;
 
-	// Roll
-	float roll = float(-normangle((GetBank() + rollOffset))); // negative because it was flipped
-	RotateArmGroup(armGroups[idx], rollPos[0], rollPos[1], 115.0f, 12.0f, ValueToAngle(roll, float(-PI), float(PI), -270.0f, 90.0f), 0.8f);
-	idx += 1;
+	if (PanelInstrumentDue(PANEL_ATTITUDE))
+	{
+		// Roll
+		float roll = float(-normangle((flightState.bank + rollOffset))); // negative because it was flipped
+		RotateArmGroup(armGroups[idx], rollPos[0], rollPos[1], 115.0f, 12.0f, ValueToAngle(roll, float(-PI), float(PI), -270.0f, 90.0f), 0.8f);
+		idx += 1;
 
-	// Pitch
-	float pitch = float(normangle((GetPitch() + pitchOffset)));
-	RotateArmGroup(armGroups[idx], pitchPos[0], pitchPos[1], 115.0f, 12.0f, ValueToAngle(pitch, float(-PI), float(PI), 34.0f, 394.0f), 0.8f, 60.0f); // Negative length part
-	idx += 1;
+		// Pitch
+		float pitch = float(normangle((flightState.pitch + pitchOffset)));
+		RotateArmGroup(armGroups[idx], pitchPos[0], pitchPos[1], 115.0f, 12.0f, ValueToAngle(pitch, float(-PI), float(PI), 34.0f, 394.0f), 0.8f, 60.0f); // Negative length part
+		idx += 1;
 
-	// Yaw. Note that retroattitude is indicated yaw 0 degrees! That's why we add PI.
-	float yaw = float(normangle((GetSlipAngle() + yawOffset + PI)));
-	RotateArmGroup(armGroups[idx], yawPos[0], yawPos[1], 115.0f, 12.0f, ValueToAngle(yaw, float(-PI), float(PI), -270.0f, 90.0f), 0.8f, 40.0f); // Negative length part
-	idx += 1;
+		// Yaw. Note that retroattitude is indicated yaw 0 degrees! That's why we add PI.
+		float yaw = float(normangle((flightState.slip + yawOffset + PI)));
+		RotateArmGroup(armGroups[idx], yawPos[0], yawPos[1], 115.0f, 12.0f, ValueToAngle(yaw, float(-PI), float(PI), -270.0f, 90.0f), 0.8f, 40.0f); // Negative length part
+		idx += 1;
+	}
+	else idx += 3;
 
-	// Calculate solar time from MJD
-	double mjd = oapiGetSimMJD();
-	double jd = mjd + 2400000.5;
-	// Don't take time zone into consideration. In communications log, they only reference GMT times, so that was probably the one on the dial.
-	//jd -= 5.0 / 24.0; // Take time zone into consideration, to get local Florida time (UTC-5).
-	// Actual calculation follow
-	double Zint = floor(jd + 0.5);
-	double Ffrac = jd + 0.5 - Zint;
-	double Aval = 0.0;
-	if (Zint < 2299161.0) Aval = Zint;
-	else Aval = Zint + 1.0 + floor((Zint - 1867216.25) / 36524.25) - floor(floor((Zint - 1867216.25) / 36524.25) / 4.0);
-	double Bval = Aval + 1524.0;
-	double Cval = floor((Bval - 122.1) / 365.25);
-	double Dval = floor(365.25 * Cval);
-	double Eval = floor((Bval - Dval) / 30.6001);
-	double dayDec = Bval - Dval - floor(30.6001 * Eval) + Ffrac;
-	double decimal = dayDec - floor(dayDec);
-	// And finally, the time of day
-	float hour = float(decimal * 24.0);
-	float minute = float((decimal - floor(hour) / 24.0) * 1440.0);
-	float second = float((decimal - floor(hour) / 24.0 - floor(minute) / 1440.0) * 86400.0);
-
-	// But the second hand ticks 5 steps per second (https://youtu.be/YiVoc6oPZbI?t=81), so truncate seconds to steps of 0.2 (=1/5).
-	second = floor(second * 5.0f) / 5.0f;
-
-	// Clock hour
-	RotateArmGroup(armGroups[idx], clockPos[0] - 173, clockPos[1] - 116, 55.0f, 10.0f, ValueToAngle(hour, 0.0f, 24.0f, -90.0f, 270.0f), 0.7f, 0.0f, includeLatency); // Note that the hour dial did one revolution per day!
-	idx += 1;
-	// Clock minute
-	RotateArmGroup(armGroups[idx], clockPos[0] - 173, clockPos[1] - 116, 70.0f, 10.0f, ValueToAngle(minute, 0.0f, 60.0f, -90.0f, 270.0f), 0.8f, 0.0f, includeLatency);
-	idx += 1;
-	// Clock second
-	RotateArmGroup(armGroups[idx], clockPos[0] - 173, clockPos[1] - 116, 110.0f, 3.0f, ValueToAngle(second, 0.0f, 60.0f, -90.0f, 270.0f), 0.95f, 0.0f, includeLatency);
-	idx += 1;
+	if (PanelInstrumentDue(PANEL_CLOCK))
+	{
+		// Calculate solar time from MJD
+		double mjd = oapiGetSimMJD();
+		double jd = mjd + 2400000.5;
+		// Don't take time zone into consideration. In communications log, they only reference GMT times, so that was probably the one on the dial.
+		//jd -= 5.0 / 24.0; // Take time zone into consideration, to get local Florida time (UTC-5).
+		// Actual calculation follow
+		double Zint = floor(jd + 0.5);
+		double Ffrac = jd + 0.5 - Zint;
+		double Aval = 0.0;
+		if (Zint < 2299161.0) Aval = Zint;
+		else Aval = Zint + 1.0 + floor((Zint - 1867216.25) / 36524.25) - floor(floor((Zint - 1867216.25) / 36524.25) / 4.0);
+		double Bval = Aval + 1524.0;
+		double Cval = floor((Bval - 122.1) / 365.25);
+		double Dval = floor(365.25 * Cval);
+		double Eval = floor((Bval - Dval) / 30.6001);
+		double dayDec = Bval - Dval - floor(30.6001 * Eval) + Ffrac;
+		double decimal = dayDec - floor(dayDec);
+		// And finally, the time of day
+		float hour = float(decimal * 24.0);
+		float minute = float((decimal - floor(hour) / 24.0) * 1440.0);
+		float second = float((decimal - floor(hour) / 24.0 - floor(minute) / 1440.0) * 86400.0);
+
+		// But the second hand ticks 5 steps per second (https://youtu.be/YiVoc6oPZbI?t=81), so truncate seconds to steps of 0.2 (=1/5).
+		second = floor(second * 5.0f) / 5.0f;
+
+		// Clock hour
+		RotateArmGroup(armGroups[idx], clockPos[0] - 173, clockPos[1] - 116, 55.0f, 10.0f, ValueToAngle(hour, 0.0f, 24.0f, -90.0f, 270.0f), 0.7f, 0.0f, includeLatency); // Note that the hour dial did one revolution per day!
+		idx += 1;
+		// Clock minute
+		RotateArmGroup(armGroups[idx], clockPos[0] - 173, clockPos[1] - 116, 70.0f, 10.0f, ValueToAngle(minute, 0.0f, 60.0f, -90.0f, 270.0f), 0.8f, 0.0f, includeLatency);
+		idx += 1;
+		// Clock second
+		RotateArmGroup(armGroups[idx], clockPos[0] - 173, clockPos[1] - 116, 110.0f, 3.0f, ValueToAngle(second, 0.0f, 60.0f, -90.0f, 270.0f), 0.95f, 0.0f, includeLatency);
+		idx += 1;
+	}
+	else idx += 3;
 
-	// Attitude rate
-	// Get attitude rate
-	VECTOR3 angVel;
-	GetAngularVel(angVel);
-	// The limits of attitude rate display is a bit confusing. 
-	// MercuryFamiliarizationManual20May1962 page 395 says "A zero to three volt signal level represents a rate level of decreasing 40 deg/sec to increasing 40 deg/sec".
-	// Same manual, page 440, says (now for apparently a kind of tape recorder):
-	//		"A 0 volt signal level represents a zero attitude rate.
-	//		A -1.5 V signal ... a decreasing rate of 6 deg/sec
-	//		and a plus 1.5 V signal ... an increasing rate of 6 deg/sec."
-	// According to MA6_FlightOps.pdf page 1-40 (page 26 in pdf), roll rate switches from a one range (+6 deg/sec for last dot, total +8 deg/sec) while in flight,
-	// to a new range (+15 deg/sec for last dot, total +20 deg/sec) after .05g activation.
-	// This is only for roll, however. One may assume that pitch and yaw rates also are at the default (+6 deg/sec, tot +8 deg/sec) scale during flight.
-	// In that case, the question whether pitch and way rates also scale during .05g program. I guess no.
-	// Summary: -> MinMax +- 8 deg/s, with roll going to +- 20 deg/s when .05g
-	// Epilogue: I don't like the limited range of 6-8 deg/s, so I'm setting it to always be the extended .05g range, i.e. 15 deg/s.
-	float range = 15.0f;
-	float rollRange = range;
-	//if (AutopilotStatus == LOWG) rollRange = 15.0f; // if .05g, set range scale to MinMax 20 deg/s
-	float pRate = float(angVel.x * DEG);
-	if (pRate > range) pRate = range;
-	if (pRate < -range) pRate = -range;
-	float yRate = float(angVel.y * DEG);
-	if (yRate > range) yRate = range;
-	if (yRate < -range) yRate = -range;
-	float rRate = float(angVel.z * DEG);
-	if (rRate > rollRange) rRate = rollRange;
-	if (rRate < -rollRange) rRate = -rollRange;
-
-	float pPixelY = attitudePos[1] + 85.0f * pRate / range;
-	float yPixelX = attitudePos[0] + 85.0f * yRate / range;
-	float rPixelX = attitudePos[0] + 85.0f * rRate / rollRange;
-
-	// Roll (actually translation, but use same rotate function)
-	RotateArmGroup(armGroups[idx], rPixelX, attitudePos[1] - 10, 100.0f, 5.0f, float(-90.0 * RAD), 0.95f, 0.0f, false);
-	idx += 1;
+	if (PanelInstrumentDue(PANEL_RATE))
+	{
+		// Attitude rate
+		// Get attitude rate
+		VECTOR3 angVel = flightState.angVel;
+		// The limits of attitude rate display is a bit confusing. 
+		// MercuryFamiliarizationManual20May1962 page 395 says "A zero to three volt signal level represents a rate level of decreasing 40 deg/sec to increasing 40 deg/sec".
+		// Same manual, page 440, says (now for apparently a kind of tape recorder):
+		//		"A 0 volt signal level represents a zero attitude rate.
+		//		A -1.5 V signal ... a decreasing rate of 6 deg/sec
+		//		and a plus 1.5 V signal ... an increasing rate of 6 deg/sec."
+		// According to MA6_FlightOps.pdf page 1-40 (page 26 in pdf), roll rate switches from a one range (+6 deg/sec for last dot, total +8 deg/sec) while in flight,
+		// to a new range (+15 deg/sec for last dot, total +20 deg/sec) after .05g activation.
+		// This is only for roll, however. One may assume that pitch and yaw rates also are at the default (+6 deg/sec, tot +8 deg/sec) scale during flight.
+		// In that case, the question whether pitch and way rates also scale during .05g program. I guess no.
+		// Summary: -> MinMax +- 8 deg/s, with roll going to +- 20 deg/s when .05g
+		// Epilogue: I don't like the limited range of 6-8 deg/s, so I'm setting it to always be the extended .05g range, i.e. 15 deg/s.
+		float range = 15.0f;
+		float rollRange = range;
+		//if (AutopilotStatus == LOWG) rollRange = 15.0f; // if .05g, set range scale to MinMax 20 deg/s
+		float pRate = float(angVel.x * DEG);
+		if (pRate > range) pRate = range;
+		if (pRate < -range) pRate = -range;
+		float yRate = float(angVel.y * DEG);
+		if (yRate > range) yRate = range;
+		if (yRate < -range) yRate = -range;
+		float rRate = float(angVel.z * DEG);
+		if (rRate > rollRange) rRate = rollRange;
+		if (rRate < -rollRange) rRate = -rollRange;
+
+		float pPixelY = attitudePos[1] + 85.0f * pRate / range;
+		float yPixelX = attitudePos[0] + 85.0f * yRate / range;
+		float rPixelX = attitudePos[0] + 85.0f * rRate / rollRange;
+
+		// Roll (actually translation, but use same rotate function)
+		RotateArmGroup(armGroups[idx], rPixelX, attitudePos[1] - 10, 100.0f, 5.0f, float(-90.0 * RAD), 0.95f, 0.0f, false);
+		idx += 1;
 
-	// Pitch (actually translation, but use same rotate function)
-	RotateArmGroup(armGroups[idx], attitudePos[0] - 60, pPixelY, 165.0f, 5.0f, 0.0f, 0.97f, 0.0f, false);
-	idx += 1;
+		// Pitch (actually translation, but use same rotate function)
+		RotateArmGroup(armGroups[idx], attitudePos[0] - 60, pPixelY, 165.0f, 5.0f, 0.0f, 0.97f, 0.0f, false);
+		idx += 1;
 
-	// Yaw (actually translation, but use same rotate function)
-	RotateArmGroup(armGroups[idx], yPixelX, attitudePos[1] + 10, 100.0f, 5.0f, float(90.0 * RAD), 0.95f, 0.0f, false);
-	idx += 1;
+		// Yaw (actually translation, but use same rotate function)
+		RotateArmGroup(armGroups[idx], yPixelX, attitudePos[1] + 10, 100.0f, 5.0f, float(90.0 * RAD), 0.95f, 0.0f, false);
+		idx += 1;
+	}
+	else idx += 3;
 
-	// Rotate globe texture
-	double posLong, posLat, posRad, heading;
-	OBJHANDLE refP = GetEquPos(posLong, posLat, posRad);
-	VECTOR3 currVel;
-	GetGroundspeedVector(FRAME_HORIZON, currVel);
-	heading = atan2(currVel.x + oapiGetSize(refP) * PI2 / oapiGetPlanetPeriod(refP) * cos(posLat), currVel.z); // orbital heading = (ground vector + ground rotation) heading
-	RotateGlobe(5.0f, 60.0f, float(posLong), float(posLat), float(heading - PI05));
+	if (PanelInstrumentDue(PANEL_GLOBE))
+	{
+		// Rotate globe texture
+		double posLong = flightState.longitude, posLat = flightState.latitude;
+		VECTOR3 currVel = flightState.groundspeedHorizon;
+		double heading = atan2(currVel.x + flightState.refSize * PI2 / flightState.refPeriod * cos(posLat), currVel.z); // orbital heading = (ground vector + ground rotation) heading
+		RotateGlobe(5.0f, 60.0f, float(posLong), float(posLat), float(heading - PI05));
+	}
 
 	// Clock numerals
 	double met = simt - launchTime;
@@ -847,41 +1122,58 @@ inline void ProjectMercury::AnimateDials(void)
 
 	int digitGrpNum = 13; // first digit group index. Update this number if we change previous groups later
 
-	ChangePanelNumber(digitGrpNum, metH); // edits both of the digits in pair (24 -> 2, 4)
-	digitGrpNum += 2;
-	ChangePanelNumber(digitGrpNum, metM); // edits both of the digits in pair (24 -> 2, 4)
-	digitGrpNum += 2;
-	ChangePanelNumber(digitGrpNum, metS); // edits both of the digits in pair (24 -> 2, 4)
-	digitGrpNum += 2;
-
-	int ret3H = 0, ret3M = 0, ret3S = 0, dRetH = 0, dRetM = 0, dRetS = 0;
-
-	GetPanelRetroTimes(met, &ret3H, &ret3M, &ret3S, &dRetH, &dRetM, &dRetS);
+	if (PanelInstrumentDue(PANEL_MET))
+	{
+		ChangePanelNumber(digitGrpNum, metH); // edits both of the digits in pair (24 -> 2, 4)
+		digitGrpNum += 2;
+		ChangePanelNumber(digitGrpNum, metM); // edits both of the digits in pair (24 -> 2, 4)
+		digitGrpNum += 2;
+		ChangePanelNumber(digitGrpNum, metS); // edits both of the digits in pair (24 -> 2, 4)
+		digitGrpNum += 2;
+	}
+	else digitGrpNum += 6;
 
-	ChangePanelNumber(digitGrpNum, ret3H); // edits both of the digits in pair (24 -> 2, 4)
-	digitGrpNum += 2;
-	ChangePanelNumber(digitGrpNum, ret3M); // edits both of the digits in pair (24 -> 2, 4)
-	digitGrpNum += 2;
-	ChangePanelNumber(digitGrpNum, ret3S); // edits both of the digits in pair (24 -> 2, 4)
-	digitGrpNum += 2;
+	if (PanelInstrumentDue(PANEL_RETROTIMES))
+	{
+		int ret3H = 0, ret3M = 0, ret3S = 0, dRetH = 0, dRetM = 0, dRetS = 0;
+
+		GetPanelRetroTimes(met, &ret3H, &ret3M, &ret3S, &dRetH, &dRetM, &dRetS);
+
+		ChangePanelNumber(digitGrpNum, ret3H); // edits both of the digits in pair (24 -> 2, 4)
+		digitGrpNum += 2;
+		ChangePanelNumber(digitGrpNum, ret3M); // edits both of the digits in pair (24 -> 2, 4)
+		digitGrpNum += 2;
+		ChangePanelNumber(digitGrpNum, ret3S); // edits both of the digits in pair (24 -> 2, 4)
+		digitGrpNum += 2;
+
+		ChangePanelNumber(digitGrpNum, dRetH); // edits both of the digits in pair (24 -> 2, 4)
+		digitGrpNum += 2;
+		ChangePanelNumber(digitGrpNum, dRetM); // edits both of the digits in pair (24 -> 2, 4)
+		digitGrpNum += 2;
+		ChangePanelNumber(digitGrpNum, dRetS); // edits both of the digits in pair (24 -> 2, 4)
+		digitGrpNum += 2;
+	}
+	else digitGrpNum += 12;
 
-	ChangePanelNumber(digitGrpNum, dRetH); // edits both of the digits in pair (24 -> 2, 4)
-	digitGrpNum += 2;
-	ChangePanelNumber(digitGrpNum, dRetM); // edits both of the digits in pair (24 -> 2, 4)
-	digitGrpNum += 2;
-	ChangePanelNumber(digitGrpNum, dRetS); // edits both of the digits in pair (24 -> 2, 4)
-	digitGrpNum += 2;
+	if (PanelInstrumentDue(PANEL_INDICATORS))
+	{
+		ChangeIndicatorStatus();
+	}
 
-	ChangeIndicatorStatus();
+	FlushDialEdits();
 
 	animateDialsPreviousSimt = simt;
+	panelForceAll = false;
+
+	// Stats for log
+	double panelCost = MercuryTimerMs() - panelStartTime;
+	panelCostTotal += panelCost;
+	if (panelCost > panelCostMax) panelCostMax = panelCost;
+	panelFrames += 1;
 }
 
 inline void ProjectMercury::RotateArmGroup(int groupNum, float x0, float y0, float length, float width, float angleR, float pointiness, float negLength, bool includeLatency)
 {
-	GROUPEDITSPEC ges;
-	NTVERTEX newVertex[5]; // We require five verticies
-
 	// Find x-offset from screen width (same as in FitPanelToScreen())
 	//float xTraOffset = addScreenWidthValue;
 	//if (panelMeshGroupSide[groupNum] == 1) // left
@@ -893,7 +1185,7 @@ inline void ProjectMercury::RotateArmGroup(int groupNum, float x0, float y0, flo
 	// Include latency in dial
 	if (includeLatency)
 	{
-		float simdt = (float)oapiGetSimStep();
+		float simdt = dialStepTime; // time since this instrument was last updated, see PanelInstrumentDue
 		if (abs(normangle(angleR - previousDialAngle[groupNum])) > simdt * dialAngularSpeed)
 		{
 			float signDirection = (angleR - previousDialAngle[groupNum]) / abs(angleR - previousDialAngle[groupNum]);
@@ -902,6 +1194,19 @@ inline void ProjectMercury::RotateArmGroup(int groupNum, float x0, float y0, flo
 	}
 	previousDialAngle[groupNum] = angleR; // save outside of the latency adding, as clock has dynamic latency, and thus always needs to be saved
 
+	// Skip if the needle tip hasn't moved visibly since last drawn. Most dials are still most of the time
+	if (dialDrawn[groupNum] && abs(x0 - dialDrawnX[groupNum]) < DIAL_PIXEL_THRESHOLD && abs(y0 - dialDrawnY[groupNum]) < DIAL_PIXEL_THRESHOLD
+		&& abs(normangle(angleR - dialDrawnAngle[groupNum])) * length < DIAL_PIXEL_THRESHOLD)
+		return;
+
+	if (dialEditNum >= MAX_DIAL_EDITS) // shouldn't happen, as every arm is only rotated once per frame
+		FlushDialEdits();
+
+	dialDrawn[groupNum] = true;
+	dialDrawnX[groupNum] = x0;
+	dialDrawnY[groupNum] = y0;
+	dialDrawnAngle[groupNum] = angleR;
+
 	float armInner0x = -negLength * cos(angleR) + width / 2.0f * sin(-angleR) + x0; // +xTraOffset;
 	float armInner0y = -negLength * sin(angleR) + width / 2.0f * cos(angleR) + y0;
 
@@ -917,10 +1222,11 @@ inline void ProjectMercury::RotateArmGroup(int groupNum, float x0, float y0, flo
 	float handOuterx = length * cos(angleR) + x0;// +xTraOffset;
 	float handOutery = length * sin(angleR) + y0;
 
-	ges.flags = GRPEDIT_VTXCRDX | GRPEDIT_VTXCRDY;
-	ges.nVtx = 5;
-	WORD vertexIndex[5] = { 0, 1, 2, 3, 4 };
-	ges.vIdx = vertexIndex;
+	// Gather, and edit all in FlushDialEdits
+	DIALEDIT* edit = &dialEdit[dialEditNum];
+	dialEditNum += 1;
+	edit->group = groupNum;
+	NTVERTEX* newVertex = edit->vtx;
 
 	newVertex[0].x = armInner0x;
 	newVertex[0].y = armInner0y;
@@ -936,10 +1242,29 @@ inline void ProjectMercury::RotateArmGroup(int groupNum, float x0, float y0, flo
 
 	newVertex[4].x = handOuterx;
 	newVertex[4].y = handOutery;
+}
 
-	ges.Vtx = newVertex;
+// Edit all dials that have moved this frame
+inline void ProjectMercury::FlushDialEdits(void)
+{
+	GROUPEDITSPEC ges;
+	WORD vertexIndex[5] = { 0, 1, 2, 3, 4 }; // We require five verticies
+	ges.flags = GRPEDIT_VTXCRDX | GRPEDIT_VTXCRDY;
+	ges.nVtx = 5;
+	ges.vIdx = vertexIndex;
+
+	for (int i = 0; i < dialEditNum; i++)
+	{
+		ges.Vtx = dialEdit[i].vtx;
+		oapiEditMeshGroup(cockpitPanelMesh, dialEdit[i].group, &ges);
+	}
 
-	oapiEditMeshGroup(cockpitPanelMesh, groupNum, &ges);
+	// Stats for log
+	dialEditsTotal += dialEditNum;
+	dialEditFrames += 1;
+	if (dialEditNum > dialEditsMax) dialEditsMax = dialEditNum;
+
+	dialEditNum = 0;
 }
 
 inline float ProjectMercury::ValueToAngle(float value, float minValue, float maxValue, float minAngle, float maxAngle)
@@ -956,106 +1281,107 @@ inline float ProjectMercury::ValueToAngle(float value, float minValue, float max
 	return resultingAngle;
 }
 
-inline void ProjectMercury::RotateGlobe(float angularResolution, float viewAngularRadius, float longitude0, float latitude0, float rotationAngle)
+// Called when the resolution changes, i.e. on the first globe update after panel load.
+// Everything that doesn't depend on the sub-vessel point is computed here, so that RotateGlobe only has asin/atan2 left per vertex
+inline void ProjectMercury::PrepareGlobeTables(float angularResolution, float viewAngularRadius)
 {
-	GROUPEDITSPEC ges;
-	NTVERTEX newVertex[1000]; // again must define a large vertex count, as I can't allocate memory from the mesh info collected earlier
-
-	ges.flags = GRPEDIT_VTXTEXU | GRPEDIT_VTXTEXV;
-	ges.nVtx = globeVertices;
+	double angResR = angularResolution * RAD;
+	globeRings = min(int(viewAngularRadius / angularResolution), GLOBE_MAX_RINGS);
+	globeSpokes = min(int(360.0f / angularResolution), GLOBE_MAX_SPOKES);
 
-	// Create vertex idx array
-	WORD vertexIndex[1000] = { NULL };
-	for (int j = 0; j < globeVertices; j++)
+	for (int i = 0; i < globeRings; i++)
 	{
-		vertexIndex[j] = j;
+		globeSinRing[i] = sin(double(i + 1) * angResR);
+		globeCosRing[i] = cos(double(i + 1) * angResR);
 	}
-	ges.vIdx = vertexIndex;
 
-	double angResR = angularResolution * RAD;
-	int numberOfLayers = int(viewAngularRadius / angularResolution);
-	int numberPerLayer = int(360.0f / angularResolution);
+	for (int k = 0; k < globeSpokes; k++)
+	{
+		globeSinSpoke[k] = sin(double(k) * angResR);
+		globeCosSpoke[k] = cos(double(k) * angResR);
+	}
 
-	// The texture covers 1.5 * of the Earth, to avoid seams.
-	// Dynamically switch between left part (regular) when 90 W < long < 90 E
-	// and right part (extended) when 90 E < long < 90 W (around date-line, and thus seam).
-	if (longitude0 > PI05) // seam-area let run into extended
+	// Vertex index array never changes
+	for (int j = 0; j < GLOBE_MAX_VERTICES; j++)
 	{
-		newVertex[0].tu = float(longitude0 / PI2 + 0.5) / 1.5f; // add a full rotation of the Earth, which is 0.666 in uv coordinates
-		newVertex[0].tv = float(-latitude0 / PI + 0.5);
+		globeVertexIndex[j] = j;
+	}
 
-		// Add value to every vertex
-		for (int i = 0; i < numberOfLayers; i++)
-		{
-			for (int k = 0; k < numberPerLayer; k++)
-			{
-				int idx = i * numberPerLayer + 1 + k;
+	globeTableResolution = angularResolution;
+	globeTableRadius = viewAngularRadius;
+	globeEdited = false;
+}
 
-				// Cast to double, as we'll multiply with doubles
-				double ip1 = double(i + 1);
-				double dk = double(k);
+inline void ProjectMercury::RotateGlobe(float angularResolution, float viewAngularRadius, float longitude0, float latitude0, float rotationAngle)
+{
+	PROFILE_SCOPE(PROF_GLOBE);
+	if (angularResolution != globeTableResolution || viewAngularRadius != globeTableRadius)
+		PrepareGlobeTables(angularResolution, viewAngularRadius);
 
-				// Great circle calculations from here: https://www.movable-type.co.uk/scripts/latlong.html
-				double pointLat = asin(sin(latitude0) * cos(ip1 * angResR) + cos(latitude0) * sin(ip1 * angResR) * cos(dk * angResR + rotationAngle));
-				double pointLong = longitude0 + atan2(sin(dk * angResR + rotationAngle) * sin(ip1 * angResR) * cos(latitude0), cos(ip1 * angResR) - sin(latitude0) * sin(pointLat));
+	// Skip if the globe wouldn't visibly change. Rotation is also compared in radians, which is conservative, as the outer ring is at less than 90 deg distance
+	double dLong = fabs(longitude0 - globeLastLongitude);
+	if (dLong > PI) dLong = PI2 - dLong; // across date-line
+	double dRot = fabs(fmod(double(rotationAngle - globeLastRotation) + PI * 3.0, PI2) - PI);
+	if (globeEdited && dLong < GLOBE_TEXEL_ANGLE && fabs(latitude0 - globeLastLatitude) < GLOBE_TEXEL_ANGLE && dRot < GLOBE_TEXEL_ANGLE)
+		return;
 
-				newVertex[idx].tu = float((fmod(pointLong + PI2, PI2)) / PI2 + 0.5) / 1.5f; // squeze by 1.5 as we now have a map covering 540 deg (3PI), and not 360 deg (2PI), and also add full rotation of Earth
-				newVertex[idx].tv = float(-pointLat / PI + 0.5); // latitude is normal
-			}
-		}
-	}
-	else if (longitude0 < -PI05) // seam-area add one revolution
-	{
-		newVertex[0].tu = float(longitude0 / PI2 + 0.5) / 1.5f + 2.0f/3.0f; // add a full rotation of the Earth, which is 0.666 in uv coordinates
-		newVertex[0].tv = float(-latitude0 / PI + 0.5);
+	globeLastLongitude = longitude0;
+	globeLastLatitude = latitude0;
+	globeLastRotation = rotationAngle;
+	globeEdited = true;
 
-		// Add value to every vertex
-		for (int i = 0; i < numberOfLayers; i++)
-		{
-			for (int k = 0; k < numberPerLayer; k++)
-			{
-				int idx = i * numberPerLayer + 1 + k;
+	int numberOfVertices = min(globeVertices, GLOBE_MAX_VERTICES);
 
-				// Cast to double, as we'll multiply with doubles
-				double ip1 = double(i + 1);
-				double dk = double(k);
+	// The texture covers 1.5 * of the Earth, to avoid seams.
+	// Dynamically switch between left part (regular) when 90 W < long < 90 E
+	// and right part (extended) when 90 E < long < 90 W (around date-line, and thus seam).
+	// Regular wraps longitude into [-180, 180), extended wraps into [0, 360), which lets the seam area run over into the extra half Earth.
+	// Previously this was three separate branches, but they only differ in this offset.
+	double wrapOffset = PI;
+	if (longitude0 > PI05 || longitude0 < -PI05) wrapOffset = 0.0;
+
+	double sinLat0 = sin(latitude0);
+	double cosLat0 = cos(latitude0);
+	double sinRot = sin(rotationAngle);
+	double cosRot = cos(rotationAngle);
+
+	// Direction of each spoke, sin(k * res + rot) and cos(k * res + rot), from angle addition
+	double sinDir[GLOBE_MAX_SPOKES], cosDir[GLOBE_MAX_SPOKES];
+	for (int k = 0; k < globeSpokes; k++)
+	{
+		sinDir[k] = globeSinSpoke[k] * cosRot + globeCosSpoke[k] * sinRot;
+		cosDir[k] = globeCosSpoke[k] * cosRot - globeSinSpoke[k] * sinRot;
+	}
 
-				// Great circle calculations from here: https://www.movable-type.co.uk/scripts/latlong.html
-				double pointLat = asin(sin(latitude0) * cos(ip1 * angResR) + cos(latitude0) * sin(ip1 * angResR) * cos(dk * angResR + rotationAngle));
-				double pointLong = longitude0 + atan2(sin(dk * angResR + rotationAngle) * sin(ip1 * angResR) * cos(latitude0), cos(ip1 * angResR) - sin(latitude0) * sin(pointLat));
+	double u0 = longitude0 + PI2 + wrapOffset;
+	globeVertex[0].tu = float(((u0 - PI2 * floor(u0 / PI2) - wrapOffset) / PI2 + 0.5) / 1.5); // squeze by 1.5 as we now have a map covering 540 deg (3PI), and not 360 deg (2PI)
+	globeVertex[0].tv = float(-latitude0 / PI + 0.5);
 
-				newVertex[idx].tu = float(((fmod(pointLong + PI2, PI2) + PI2) / PI2) / 1.5 - 1.0/3.0); // squeze by 1.5 as we now have a map covering 540 deg (3PI), and not 360 deg (2PI), and also let flow over
-				newVertex[idx].tv = float(-pointLat / PI + 0.5); // latitude is normal
-			}
-		}
-	}
-	else // regular
+	for (int i = 0; i < globeRings; i++)
 	{
-		newVertex[0].tu = float(longitude0 / PI2 + 0.5) / 1.5f;
-		newVertex[0].tv = float(-latitude0 / PI + 0.5);
-
-		// Add value to every vertex
-		for (int i = 0; i < numberOfLayers; i++)
+		double a = sinLat0 * globeCosRing[i];
+		double b = cosLat0 * globeSinRing[i];
+		double c = globeCosRing[i];
+		if (i * globeSpokes + 1 + globeSpokes > numberOfVertices) break; // mesh has fewer vertices than the tables
+		NTVERTEX* ring = &globeVertex[i * globeSpokes + 1];
+
+		// Great circle calculations from here: https://www.movable-type.co.uk/scripts/latlong.html
+		for (int k = 0; k < globeSpokes; k++)
 		{
-			for (int k = 0; k < numberPerLayer; k++)
-			{
-				int idx = i * numberPerLayer + 1 + k;
-
-				// Cast to double, as we'll multiply with doubles
-				double ip1 = double(i + 1);
-				double dk = double(k);
-
-				// Great circle calculations from here: https://www.movable-type.co.uk/scripts/latlong.html
-				double pointLat = asin(sin(latitude0) * cos(ip1 * angResR) + cos(latitude0) * sin(ip1 * angResR) * cos(dk * angResR + rotationAngle));
-				double pointLong = longitude0 + atan2(sin(dk * angResR + rotationAngle) * sin(ip1 * angResR) * cos(latitude0), cos(ip1 * angResR) - sin(latitude0) * sin(pointLat));
+			double sinPointLat = a + b * cosDir[k];
+			double pointLat = asin(sinPointLat);
+			double u = longitude0 + atan2(sinDir[k] * b, c - sinLat0 * sinPointLat) + PI2 + wrapOffset;
 
-				newVertex[idx].tu = float((fmod(pointLong + PI * 3.0, PI2) - PI) / PI2 + 0.5) / 1.5f; // squeze by 1.5 as we now have a map covering 540 deg (3PI), and not 360 deg (2PI)
-				newVertex[idx].tv = float(-pointLat / PI + 0.5); // latitude is normal
-			}
+			ring[k].tu = float(((u - PI2 * floor(u / PI2) - wrapOffset) / PI2 + 0.5) / 1.5);
+			ring[k].tv = float(-pointLat / PI + 0.5); // latitude is normal
 		}
 	}
 
-	ges.Vtx = newVertex;
+	GROUPEDITSPEC ges;
+	ges.flags = GRPEDIT_VTXTEXU | GRPEDIT_VTXTEXV;
+	ges.nVtx = numberOfVertices;
+	ges.vIdx = globeVertexIndex;
+	ges.Vtx = globeVertex;
 	oapiEditMeshGroup(cockpitPanelMesh, globeGroup, &ges);
 }
 
@@ -1100,6 +1426,23 @@ inline void ProjectMercury::ChangePanelNumber(int group, int num)
 	oapiEditMeshGroup(cockpitPanelMesh, group + 1, &ges);
 }
 
+// Bit layout of the panel state snapshot in ChangeIndicatorStatus
+const int PANEL_STATE_INDICATORS = 13; // 2 bits each (gray, red, green), from bit 0
+const int PANEL_STATE_BUTTONS = 5; // 1 bit each (lit)
+const int PANEL_STATE_BUTTON_BIT = 2 * PANEL_STATE_INDICATORS;
+const int PANEL_STATE_SWITCHES = 5; // 2 bits each (left, centre, right)
+const int PANEL_STATE_SWITCH_BIT = PANEL_STATE_BUTTON_BIT + PANEL_STATE_BUTTONS;
+const int PANEL_STATE_THANDLES = 4; // 1 bit each (pushed)
+const int PANEL_STATE_THANDLE_BIT = PANEL_STATE_SWITCH_BIT + 2 * PANEL_STATE_SWITCHES; // 45 bits in total
+
+const double BUTTON_WHEEL_TICK = 0.05; // s
+const int BUTTON_LIGHT_TICKS = 2; // so button is lit for 0.05 to 0.1 s
+
+inline unsigned long long PanelStateField(unsigned long long state, int bit, int width)
+{
+	return (state >> bit) & ((1ull << width) - 1ull);
+}
+
 inline void ProjectMercury::ChangeIndicatorStatus(void)
 {
 	int GRAY = 0;
@@ -1114,16 +1457,12 @@ inline void ProjectMercury::ChangeIndicatorStatus(void)
 	// ABORT
 	if (abort) indicatorStatus[idx] = RED;
 	else indicatorStatus[idx] = GRAY;
-	if (indicatorStatus[idx] != previousIndicatorStatus[idx]) SetIndicatorStatus(idx, indicatorStatus[idx]);
-	previousIndicatorStatus[idx] = indicatorStatus[idx];
 	idx += 1;
 
 	// JETT TOWER
 	// JETT TOWER and SEP CAPSULE telelights seem to go out 5 minutes after capsule separation, according to MA6_FlightPlan2.pdf page 38. But have found no other source saying the same.
 	if (towerJettisoned) indicatorStatus[idx] = GREEN; // I don't implement any failures of tower sep, so don't implement any failure light. This may change when fuses are added
 	else indicatorStatus[idx] = GRAY;
-	if (indicatorStatus[idx] != previousIndicatorStatus[idx]) SetIndicatorStatus(idx, indicatorStatus[idx]);
-	previousIndicatorStatus[idx] = indicatorStatus[idx];
 	idx += 1;
 
 	// SEP CAPSULE
@@ -1131,8 +1470,6 @@ inline void ProjectMercury::ChangeIndicatorStatus(void)
 	if (VesselStatus == FLIGHT || VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE || VesselStatus == ABORT || VesselStatus == ABORTNORETRO) indicatorStatus[idx] = GREEN;
 	else if (boosterShutdownTime == 0.0) indicatorStatus[idx] = GRAY; // time between shutdown and sep is red, so gray if not shutdown yet
 	else indicatorStatus[idx] = RED;
-	if (indicatorStatus[idx] != previousIndicatorStatus[idx]) SetIndicatorStatus(idx, indicatorStatus[idx]);
-	previousIndicatorStatus[idx] = indicatorStatus[idx];
 	idx += 1;
 
 	// RETRO SEQ
@@ -1140,20 +1477,16 @@ inline void ProjectMercury::ChangeIndicatorStatus(void)
 	else if (retroStartTime == 0.0) indicatorStatus[idx] = GRAY; // uninitialised
 	else if (VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE || VesselStatus == ABORTNORETRO) indicatorStatus[idx] = GRAY;
 	else indicatorStatus[idx] = RED;
-	if (indicatorStatus[idx] != previousIndicatorStatus[idx]) SetIndicatorStatus(idx, indicatorStatus[idx]);
-	previousIndicatorStatus[idx] = indicatorStatus[idx];
 	idx += 1;
 
 	// RETRO ATT
-	double currP = GetPitch() + pitchOffset;
-	double currY = GetSlipAngle() + yawOffset;
-	double currR = GetBank() + rollOffset;
+	double currP = flightState.pitch + pitchOffset;
+	double currY = flightState.slip + yawOffset;
+	double currR = flightState.bank + rollOffset;
 	if (engageRetro && abs(currP + 34.0 * RAD) < 12.5 * RAD && abs(normangle(currY + PI)) < 30.0 * RAD && abs(currR) < 30.0 * RAD) indicatorStatus[idx] = GREEN; // within limits, familiariyation page 229
 	else if (retroStartTime == 0.0) indicatorStatus[idx] = GRAY; // haven't engaged retro
 	else if (VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE || VesselStatus == ABORTNORETRO) indicatorStatus[idx] = GRAY;
 	else indicatorStatus[idx] = RED;
-	if (indicatorStatus[idx] != previousIndicatorStatus[idx]) SetIndicatorStatus(idx, indicatorStatus[idx]);
-	previousIndicatorStatus[idx] = indicatorStatus[idx];
 	idx += 1;
 
 	// FIRE RETRO
@@ -1163,8 +1496,6 @@ inline void ProjectMercury::ChangeIndicatorStatus(void)
 	else if (retroStartTime != 0.0 && retroStartTime - 15.0 < simt) indicatorStatus[idx] = RED; // red 15 sec before retrofire
 	else if (VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE || VesselStatus == ABORTNORETRO) indicatorStatus[idx] = GREEN; // green until LOWG
 	else indicatorStatus[idx] = GRAY;
-	if (indicatorStatus[idx] != previousIndicatorStatus[idx]) SetIndicatorStatus(idx, indicatorStatus[idx]);
-	previousIndicatorStatus[idx] = indicatorStatus[idx];
 	idx += 1;
 
 	// JETT RETRO
@@ -1172,8 +1503,6 @@ inline void ProjectMercury::ChangeIndicatorStatus(void)
 	else if (VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE || VesselStatus == ABORTNORETRO) indicatorStatus[idx] = GREEN; // Green until LOWG
 	else if (retroStartTime != 0.0 && retroStartTime - 28.0 < simt) indicatorStatus[idx] = RED;
 	else indicatorStatus[idx] = GRAY;
-	if (indicatorStatus[idx] != previousIndicatorStatus[idx]) SetIndicatorStatus(idx, indicatorStatus[idx]);
-	previousIndicatorStatus[idx] = indicatorStatus[idx];
 	idx += 1;
 
 	// RETRACT SCOPE
@@ -1181,24 +1510,18 @@ inline void ProjectMercury::ChangeIndicatorStatus(void)
 	else if (PeriscopeStatus != P_CLOSED && (VesselStatus == FLIGHT || VesselStatus == REENTRYNODROGUE || (VesselStatus == LAUNCH && GroundContact()))) indicatorStatus[idx] = GREEN;
 	else if (PeriscopeStatus == P_CLOSED) indicatorStatus[idx] = GRAY;
 	else indicatorStatus[idx] = RED;
-	if (indicatorStatus[idx] != previousIndicatorStatus[idx]) SetIndicatorStatus(idx, indicatorStatus[idx]);
-	previousIndicatorStatus[idx] = indicatorStatus[idx];
 	idx += 1;
 
 	// .05 G
 	if (FailureMode != LOWGDEACTIVE && VesselStatus == REENTRY && vesselAcceleration > 0.05 * G) indicatorStatus[idx] = GREEN;
 	else if (AutopilotStatus == LOWG) indicatorStatus[idx] = GREEN;
 	else indicatorStatus[idx] = GRAY;
-	if (indicatorStatus[idx] != previousIndicatorStatus[idx]) SetIndicatorStatus(idx, indicatorStatus[idx]);
-	previousIndicatorStatus[idx] = indicatorStatus[idx];
 	idx += 1;
 
 	// MAIN
 	if (mainChuteDeployed && simt > mainChuteDeployTime + 2.0) indicatorStatus[idx] = GREEN;
 	else if (!mainChuteDeployed) indicatorStatus[idx] = GRAY;
 	else indicatorStatus[idx] = RED;
-	if (indicatorStatus[idx] != previousIndicatorStatus[idx]) SetIndicatorStatus(idx, indicatorStatus[idx]);
-	previousIndicatorStatus[idx] = indicatorStatus[idx];
 	idx += 1;
 
 	// LANDING BAG
@@ -1206,13 +1529,11 @@ inline void ProjectMercury::ChangeIndicatorStatus(void)
 	else if (mainChuteDeployed && simt - mainChuteDeployTime > 10.0) indicatorStatus[idx] = RED;
 	else if (!landingBagDeployed) indicatorStatus[idx] = GRAY;
 	else indicatorStatus[idx] = RED;
-	if (indicatorStatus[idx] != previousIndicatorStatus[idx]) SetIndicatorStatus(idx, indicatorStatus[idx]);
-	previousIndicatorStatus[idx] = indicatorStatus[idx];
 	idx += 1;
 
 	// FUEL QUAN
-	double autoLevel = GetPropellantMass(fuel_auto) / MERCURY_FUEL_MASS_AUTO;
-	double manualLevel = GetPropellantMass(fuel_manual) / MERCURY_FUEL_MASS_MAN;
+	double autoLevel = flightState.fuelAuto / MERCURY_FUEL_MASS_AUTO;
+	double manualLevel = flightState.fuelManual / MERCURY_FUEL_MASS_MAN;
 	//if (!attitudeFuelAuto) // swap (just how I've defined it)
 	//{
 	//	autoLevel = GetPropellantMass(fuel_manual) / MERCURY_FUEL_MASS_AUTO;
@@ -1224,63 +1545,123 @@ inline void ProjectMercury::ChangeIndicatorStatus(void)
 	// So we now set 0.65 to be limit.
 	if (autoLevel < 0.65 || manualLevel < 0.65) indicatorStatus[idx] = RED;
 	else indicatorStatus[idx] = GRAY;
-	if (indicatorStatus[idx] != previousIndicatorStatus[idx]) SetIndicatorStatus(idx, indicatorStatus[idx]);
-	previousIndicatorStatus[idx] = indicatorStatus[idx];
 	idx += 1;
 
 	// RETRO WARN
 	if (VesselStatus == REENTRY || VesselStatus == REENTRYNODROGUE) indicatorStatus[idx] = GRAY;
 	else if (retroWarnLight) indicatorStatus[idx] = RED;
 	else indicatorStatus[idx] = GRAY;
-	if (indicatorStatus[idx] != previousIndicatorStatus[idx]) SetIndicatorStatus(idx, indicatorStatus[idx]);
-	previousIndicatorStatus[idx] = indicatorStatus[idx];
 	idx += 1;
 
-	indicatorButtonFirstGroup = idx;
-	// Set all button lights. Works so that button is switched to active on click inside clbkPanelMouseEvent, and we here dim it
-	double buttonLightTime = 0.05;
-	for (int i = 0; i < 5; i++)
+	// Extinguish button lights
+	AdvanceButtonWheel(simt);
+
+	// Pack everything the panel shows into one snapshot, and only apply what has changed since last frame
+	int switchStatus[5] = { switchAutoRetroJet, switchRetroDelay, switchRetroAttitude, switchASCSMode, switchControlMode };
+	bool tHandleStatus[4] = { tHandleManualPushed, tHandleRollPushed, tHandleYawPushed, tHandlePitchPushed };
+
+	unsigned long long state = 0;
+	for (int i = 0; i < PANEL_STATE_INDICATORS; i++)
+		state |= (unsigned long long)indicatorStatus[i] << (2 * i);
+	state |= (unsigned long long)buttonLightsOn << PANEL_STATE_BUTTON_BIT;
+	for (int i = 0; i < PANEL_STATE_SWITCHES; i++)
+		state |= (unsigned long long)(switchStatus[i] + 1) << (PANEL_STATE_SWITCH_BIT + 2 * i);
+	for (int i = 0; i < PANEL_STATE_THANDLES; i++)
+		if (tHandleStatus[i]) state |= 1ull << (PANEL_STATE_THANDLE_BIT + i);
+
+	unsigned long long changed = ~0ull; // everything, if the panel has been reset
+	if (panelDrawnStateValid) changed = state ^ panelDrawnState;
+
+	if (changed != 0)
+		ApplyPanelState(state, changed);
+
+	panelDrawnState = state;
+	panelDrawnStateValid = true;
+}
+
+// Edit the mesh groups of the lights, buttons and switches that have changed
+inline void ProjectMercury::ApplyPanelState(unsigned long long state, unsigned long long changed)
+{
+	int idx = 0;
+
+	for (int i = 0; i < PANEL_STATE_INDICATORS; i++)
 	{
-		if (indicatorButtonPressState[i] != -1 && simt > indicatorButtonPressTime[i] + buttonLightTime) SetIndicatorButtonStatus(indicatorButtonFirstGroup + i, -1); // extinguish
+		if (PanelStateField(changed, 2 * i, 2) != 0) SetIndicatorStatus(idx, (int)PanelStateField(state, 2 * i, 2));
 		idx += 1;
+	}
 
-		// It seems like I have to do something here, or else Orbiter fails to correctly place vertices. So call a stupid function or something.
-		//double uselessValue = GetPitch();
-		//uselessValue *= GGRAV;
+	indicatorButtonFirstGroup = idx;
+	for (int i = 0; i < PANEL_STATE_BUTTONS; i++)
+	{
+		if (PanelStateField(changed, PANEL_STATE_BUTTON_BIT + i, 1) != 0)
+		{
+			if (PanelStateField(state, PANEL_STATE_BUTTON_BIT + i, 1) != 0) SetIndicatorButtonStatus(indicatorButtonFirstGroup + i, 1); // lit
+			else SetIndicatorButtonStatus(indicatorButtonFirstGroup + i, -1); // extinguish
+		}
+		idx += 1;
 	}
 
 	physicalSwitchFirstGroup = idx;
-	// Set all switch positions. Is switched every frame to the current relevant state
-	SetPhysicalSwitchStatus(physicalSwitchFirstGroup + 0, switchAutoRetroJet);
-	idx += 1;
+	for (int i = 0; i < PANEL_STATE_SWITCHES; i++)
+	{
+		if (PanelStateField(changed, PANEL_STATE_SWITCH_BIT + 2 * i, 2) != 0) SetPhysicalSwitchStatus(physicalSwitchFirstGroup + i, (int)PanelStateField(state, PANEL_STATE_SWITCH_BIT + 2 * i, 2) - 1);
+		idx += 1;
+	}
 
-	SetPhysicalSwitchStatus(physicalSwitchFirstGroup + 1, switchRetroDelay);
-	idx += 1;
+	// Then we have 8 labels which we skip.
+	idx += 8;
 
-	SetPhysicalSwitchStatus(physicalSwitchFirstGroup + 2, switchRetroAttitude);
-	idx += 1;
+	// And then the "T" handles.
+	for (int i = 0; i < PANEL_STATE_THANDLES; i++)
+	{
+		if (PanelStateField(changed, PANEL_STATE_THANDLE_BIT + i, 1) != 0) SetTHandleState(abortIndicatorGroup + idx, PanelStateField(state, PANEL_STATE_THANDLE_BIT + i, 1) != 0, i);
+		idx += 1;
+	}
+}
 
-	SetPhysicalSwitchStatus(physicalSwitchFirstGroup + 3, switchASCSMode);
-	idx += 1;
+// Light a button. It is extinguished by the timer wheel after BUTTON_LIGHT_TICKS ticks, or at the next frame if that is later
+inline void ProjectMercury::PressIndicatorButton(int button, double simt)
+{
+	AdvanceButtonWheel(simt);
 
-	SetPhysicalSwitchStatus(physicalSwitchFirstGroup + 4, switchControlMode);
-	idx += 1;
+	for (int i = 0; i < BUTTON_WHEEL_SLOTS; i++)
+		buttonWheel[i] &= ~(1u << button); // if pressed again, only the last press counts
 
-	// Then we have 8 labels which we skip.
-	idx += 8;
+	long long expiryTick = buttonWheelTick + BUTTON_LIGHT_TICKS;
+	buttonWheel[int(expiryTick % BUTTON_WHEEL_SLOTS)] |= 1u << button;
+	buttonLightsOn |= 1u << button;
 
-	// And then the "T" handles.
-	SetTHandleState(abortIndicatorGroup + idx, tHandleManualPushed, 0);
-	idx += 1;
+	// Light it in the mesh now, like before the panel state snapshot. At high time acceleration one frame is longer than
+	// BUTTON_LIGHT_TICKS, and the wheel has extinguished the light again before ChangeIndicatorStatus would have drawn it
+	if (panelDrawnStateValid)
+	{
+		SetIndicatorButtonStatus(indicatorButtonFirstGroup + button, 1);
+		panelDrawnState |= 1ull << (PANEL_STATE_BUTTON_BIT + button);
+	}
+}
 
-	SetTHandleState(abortIndicatorGroup + idx, tHandleRollPushed, 1);
-	idx += 1;
+inline void ProjectMercury::AdvanceButtonWheel(double simt)
+{
+	long long nowTick = (long long)floor(simt / BUTTON_WHEEL_TICK);
 
-	SetTHandleState(abortIndicatorGroup + idx, tHandleYawPushed, 2);
-	idx += 1;
+	if (nowTick < buttonWheelTick || nowTick - buttonWheelTick >= BUTTON_WHEEL_SLOTS) // time jump, so everything has expired
+	{
+		for (int i = 0; i < BUTTON_WHEEL_SLOTS; i++)
+			buttonWheel[i] = 0;
+		buttonLightsOn = 0;
+	}
+	else
+	{
+		while (buttonWheelTick < nowTick)
+		{
+			buttonWheelTick += 1;
+			int slot = int(buttonWheelTick % BUTTON_WHEEL_SLOTS);
+			buttonLightsOn &= ~buttonWheel[slot];
+			buttonWheel[slot] = 0;
+		}
+	}
 
-	SetTHandleState(abortIndicatorGroup + idx, tHandlePitchPushed, 3);
-	idx += 1;
+	buttonWheelTick = nowTick;
 }
 
 inline void ProjectMercury::SetIndicatorStatus(int indicatorNr, int status)
@@ -1379,8 +1760,6 @@ inline void ProjectMercury::SetIndicatorButtonStatus(int buttonNr, int status)
 
 	ges.Vtx = newVertex;
 	oapiEditMeshGroup(cockpitPanelMesh, abortIndicatorGroup + buttonNr, &ges);
-
-	indicatorButtonPressState[buttonNr - indicatorButtonFirstGroup] = status;
 }
 
 inline void ProjectMercury::SetPhysicalSwitchStatus(int switchNr, int status)
@@ -1488,10 +1867,6 @@ inline void ProjectMercury::clbkFocusChanged(bool getfocus, OBJHANDLE hNewVessel
 {
 	if (getfocus) // we gained focus (if else, we lost focus, and then don't need to update)
 	{
-		for (int i = 0; i < 13; i++)
-			previousIndicatorStatus[i] = -1; // reset. If this is not done, a panel will inherit the state of the previously viewed panel.
-
-		for (int i = 0; i < 20; i++)
-			indicatorButtonPressState[i] = 0; // reset. (-1 is default off)
+		panelDrawnStateValid = false; // reset. If this is not done, a panel will inherit the state of the previously viewed panel.
 	}
 }
\ No newline at end of file